@@ -52,12 +52,12 @@ void CharCommand::redo()
             _xData->insert(_charPos, _newChar);
             break;
         case replace:
-            _oldChar = _xData->data()[_charPos];
+            _oldChar = _xData->at(_charPos);
             _wasChanged = _xData->dataChanged(_charPos);
             _xData->replace(_charPos, _newChar);
             break;
         case remove:
-            _oldChar = _xData->data()[_charPos];
+            _oldChar = _xData->at(_charPos);
             _wasChanged = _xData->dataChanged(_charPos);
             _xData->remove(_charPos, 1);
             break;
@@ -84,12 +84,11 @@ void ArrayCommand::undo()
             _xData->remove(_baPos, _newBa.length());
             break;
         case replace:
-            _xData->replace(_baPos, _oldBa);
-            _xData->setDataChanged(_baPos, _wasChanged);
+            _xData->remove(_baPos, _newBa.length());
+            _xData->insert(_baPos, _oldPieces);
             break;
         case remove:
-            _xData->insert(_baPos, _oldBa);
-            _xData->setDataChanged(_baPos, _wasChanged);
+            _xData->insert(_baPos, _oldPieces);
             break;
     }
 }
@@ -102,13 +101,11 @@ void ArrayCommand::redo()
             _xData->insert(_baPos, _newBa);
             break;
         case replace:
-            _oldBa = _xData->data().mid(_baPos, _len);
-            _wasChanged = _xData->dataChanged(_baPos, _len);
+            _oldPieces = _xData->pieces(_baPos, _newBa.length());
             _xData->replace(_baPos, _newBa);
             break;
         case remove:
-            _oldBa = _xData->data().mid(_baPos, _len);
-            _wasChanged = _xData->dataChanged(_baPos, _len);
+            _oldPieces = _xData->pieces(_baPos, _len);
             _xData->remove(_baPos, _len);
             break;
     }
@@ -45,6 +45,7 @@ private:
 
 /*! ArrayCommand provides undo/redo functionality for handling binary strings. It
 can undo/redo insert, replace and remove binary strins (QByteArrays).
+Replaced or removed data is kept as XByteArray pieces, not copied.
 */
 class ArrayCommand : public QUndoCommand
 {
@@ -60,9 +61,8 @@ private:
     XByteArray * _xData;
     int _baPos;
     int _len;
-    QByteArray _wasChanged;
     QByteArray _newBa;
-    QByteArray _oldBa;
+    XByteArray::Pieces _oldPieces;
 };
 
 /** \endcond docNever */
@@ -119,6 +119,16 @@ QByteArray QHexEdit::data()
     return qHexEdit_p->data();
 }
 
+int QHexEdit::dataSize()
+{
+    return qHexEdit_p->xData().size();
+}
+
+uint QHexEdit::dataSum()
+{
+    return qHexEdit_p->xData().byteSum();
+}
+
 void QHexEdit::setAddressAreaColor(const QColor &color)
 {
     qHexEdit_p->setAddressAreaColor(color);
@@ -165,6 +165,8 @@ public:
     int cursorPosition();
     void setData(QByteArray const &data);
     QByteArray data();
+    int dataSize();
+    uint dataSum();
     void setAddressAreaColor(QColor const &color);
     QColor addressAreaColor();
     void setHighlightingColor(QColor const &color);
@@ -109,9 +109,10 @@ XByteArray & QHexEditPrivate::xData()
 
 int QHexEditPrivate::indexOf(const QByteArray & ba, int from)
 {
-    if (from > (_xData.data().length() - 1))
-        from = _xData.data().length() - 1;
-    int idx = _xData.data().indexOf(ba, from);
+    QByteArray data = _xData.data();
+    if (from > (data.length() - 1))
+        from = data.length() - 1;
+    int idx = data.indexOf(ba, from);
     if (idx > -1)
     {
         int curPos = idx*2;
@@ -458,7 +459,7 @@ if (!_readOnly)
             // Change content
             if (_xData.size() > 0)
             {
-                QByteArray hexValue = _xData.data().mid(posBa, 1).toHex();
+                QByteArray hexValue = _xData.mid(posBa, 1).toHex();
                 if ((charX % 3) == 0)
                     hexValue[0] = key;
                 else
@@ -475,9 +476,10 @@ if (!_readOnly)
         if (event->matches(QKeySequence::Cut))
         {
             QString result = QString();
+            QByteArray selected = _xData.mid(getSelectionBegin(), getSelectionEnd() - getSelectionBegin());
             for (int idx = getSelectionBegin(); idx < getSelectionEnd(); idx++)
             {
-                result += _xData.data().mid(idx, 1).toHex() + " ";
+                result += selected.mid(idx - getSelectionBegin(), 1).toHex() + " ";
                 if ((idx % 16) == 15)
                     result.append("\n");
             }
@@ -557,9 +559,10 @@ if (!_readOnly)
     if (event->matches(QKeySequence::Copy))
     {
         QString result = QString();
+        QByteArray selected = _xData.mid(getSelectionBegin(), getSelectionEnd() - getSelectionBegin());
         for (int idx = getSelectionBegin(); idx < getSelectionEnd(); idx++)
         {
-            result += _xData.data().mid(idx, 1).toHex() + " ";
+            result += selected.mid(idx - getSelectionBegin(), 1).toHex() + " ";
             if ((idx % 16) == 15)
                 result.append('\n');
         }
@@ -635,7 +638,8 @@ void QHexEditPrivate::paintEvent(QPaintEvent *event)
     }
 
     // paint hex area
-    QByteArray hexBa(_xData.data().mid(firstLineIdx, lastLineIdx - firstLineIdx + 1).toHex());
+    QByteArray hexBa(_xData.mid(firstLineIdx, lastLineIdx - firstLineIdx + 1).toHex());
+    QByteArray changedBa(_xData.dataChanged(firstLineIdx, lastLineIdx - firstLineIdx + 1));
     QBrush highLighted = QBrush(_highlightingColor);
     QPen colHighlighted = QPen(this->palette().color(QPalette::WindowText));
     QBrush selected = QBrush(_selectionColor);
@@ -663,7 +667,7 @@ void QHexEditPrivate::paintEvent(QPaintEvent *event)
                 {
                     // hilight diff bytes
                     painter.setBackground(highLighted);
-                    if (_xData.dataChanged(posBa))
+                    if (changedBa[posBa - firstLineIdx])
                     {
                         painter.setPen(colHighlighted);
                         painter.setBackgroundMode(Qt::OpaqueMode);
@@ -5,7 +5,16 @@ XByteArray::XByteArray()
     _oldSize = -99;
     _addressNumbers = 4;
     _addressOffset = 0;
+    _root = NULL;
+    _seed = 0x9e3779b9;
+    _sum = 0;
+    _sumValid = true;
+    _flatValid = true;
+}
 
+XByteArray::~XByteArray()
+{
+    freeTree(_root);
 }
 
 int XByteArray::addressOffset()
@@ -31,109 +40,213 @@ void XByteArray::setAddressWidth(int width)
     }
 }
 
-QByteArray & XByteArray::data()
+QByteArray XByteArray::data()
 {
-    return _data;
+    if (!_flatValid)
+    {
+        _flat = mid(0, size());
+        _flatValid = true;
+    }
+    return _flat;
 }
 
 void XByteArray::setData(QByteArray data)
 {
+    freeTree(_root);
+    _root = NULL;
     _data = data;
-    _changedData = QByteArray(data.length(), char(0));
+    _inserted.clear();
+    if (_data.size() > 0)
+    {
+        Piece piece = { 0, _data.size(), false, false };
+        _root = newNode(piece);
+    }
+    _flat = _data;
+    _flatValid = true;
+    _sumValid = false;
+}
+
+char XByteArray::at(int i)
+{
+    Node *node = find(i);
+    return node ? pieceData(node->piece)[i] : char(0);
+}
+
+QByteArray XByteArray::mid(int i, int len)
+{
+    Pieces list = pieces(i, len);
+    if ((list.size() == 1) and !list[0].inserted and (list[0].length == _data.size()))
+        return _data;
+
+    QByteArray result;
+    int total = 0;
+    for (int idx=0; idx < list.size(); idx++)
+        total += list[idx].length;
+    result.reserve(total);
+    for (int idx=0; idx < list.size(); idx++)
+        result.append(pieceData(list[idx]), list[idx].length);
+    return result;
+}
+
+uint XByteArray::byteSum()
+{
+    if (!_sumValid)
+    {
+        Pieces list = pieces(0, size());
+        _sum = 0;
+        for (int idx=0; idx < list.size(); idx++)
+            _sum += pieceSum(list[idx]);
+        _sumValid = true;
+    }
+    return _sum;
 }
 
 bool XByteArray::dataChanged(int i)
 {
-    return bool(_changedData[i]);
+    Node *node = find(i);
+    return node ? node->piece.changed : false;
 }
 
 QByteArray XByteArray::dataChanged(int i, int len)
 {
-    return _changedData.mid(i, len);
+    Pieces list = pieces(i, len);
+    QByteArray result;
+    for (int idx=0; idx < list.size(); idx++)
+        result.append(QByteArray(list[idx].length, char(list[idx].changed)));
+    return result;
 }
 
 void XByteArray::setDataChanged(int i, bool state)
 {
-    _changedData[i] = char(state);
+    setChanged(i, 1, state);
 }
 
 void XByteArray::setDataChanged(int i, const QByteArray & state)
 {
     int length = state.length();
     int len;
-    if ((i + length) > _changedData.length())
-        len = _changedData.length() - i;
+    if ((i + length) > size())
+        len = size() - i;
     else
         len = length;
-    _changedData.replace(i, len, state);
+
+    // one change per run of equal states
+    for (int j=0; j < len; )
+    {
+        int k = j + 1;
+        while ((k < len) and (bool(state[k]) == bool(state[j])))
+            k++;
+        setChanged(i + j, k - j, bool(state[j]));
+        j = k;
+    }
 }
 
 int XByteArray::realAddressNumbers()
 {
-    if (_oldSize != _data.size())
+    if (_oldSize != size())
     {
         // is addressNumbers wide enought?
         QString test = QString("%1")
-                      .arg(_data.size() + _addressOffset, _addressNumbers, 16, QChar('0'));
+                      .arg(size() + _addressOffset, _addressNumbers, 16, QChar('0'));
         _realAddressNumbers = test.size();
+        _oldSize = size();
     }
     return _realAddressNumbers;
 }
 
 int XByteArray::size()
 {
-    return _data.size();
+    return sizeOf(_root);
+}
+
+void XByteArray::insert(int i, char ch)
+{
+    insert(i, QByteArray(1, ch));
+}
+
+void XByteArray::insert(int i, const QByteArray & ba)
+{
+    if (ba.length() == 0)
+        return;
+    Piece piece = { _inserted.size(), ba.length(), true, true };
+    _inserted.append(ba);
+    insertPiece(i, piece);
 }
 
-QByteArray & XByteArray::insert(int i, char ch)
+void XByteArray::insert(int i, const Pieces & pieces)
 {
-    _data.insert(i, ch);
-    _changedData.insert(i, char(1));
-    return _data;
+    for (int idx=0; idx < pieces.size(); idx++)
+    {
+        insertPiece(i, pieces[idx]);
+        i += pieces[idx].length;
+    }
 }
 
-QByteArray & XByteArray::insert(int i, const QByteArray & ba)
+XByteArray::Pieces XByteArray::pieces(int i, int len)
 {
-    _data.insert(i, ba);
-    _changedData.insert(i, QByteArray(ba.length(), char(1)));
-    return _data;
+    Pieces result;
+    if (i < 0)
+    {
+        len += i;
+        i = 0;
+    }
+    if (len > size() - i)
+        len = size() - i;
+    if (len > 0)
+        collect(_root, 0, i, i + len, result);
+    return result;
 }
 
-QByteArray & XByteArray::remove(int i, int len)
+void XByteArray::remove(int i, int len)
 {
-    _data.remove(i, len);
-    _changedData.remove(i, len);
-    return _data;
+    if ((i < 0) or (i >= size()) or (len <= 0))
+        return;
+    if (len > size() - i)
+        len = size() - i;
+
+    Node *left, *middle, *right;
+    split(_root, i, left, right);
+    split(right, len, middle, right);
+    if (_sumValid)
+    {
+        Pieces list;
+        collect(middle, 0, 0, len, list);
+        for (int idx=0; idx < list.size(); idx++)
+            _sum -= pieceSum(list[idx]);
+    }
+    freeTree(middle);
+    _root = merge(left, right);
+    _flatValid = false;
+    _flat.clear();
 }
 
-QByteArray & XByteArray::replace(int index, char ch)
+void XByteArray::replace(int index, char ch)
 {
-    _data[index] = ch;
-    _changedData[index] = char(1);
-    return _data;
+    replace(index, 1, QByteArray(1, ch));
 }
 
-QByteArray & XByteArray::replace(int index, const QByteArray & ba)
+void XByteArray::replace(int index, const QByteArray & ba)
 {
     int len = ba.length();
-    return replace(index, len, ba);
+    replace(index, len, ba);
 }
 
-QByteArray & XByteArray::replace(int index, int length, const QByteArray & ba)
+void XByteArray::replace(int index, int length, const QByteArray & ba)
 {
     int len;
-    if ((index + length) > _data.length())
-        len = _data.length() - index;
+    if ((index + length) > size())
+        len = size() - index;
     else
         len = length;
-    _data.replace(index, len, ba.mid(0, len));
-    _changedData.replace(index, len, QByteArray(len, char(1)));
-    return _data;
+    if (len <= 0)
+        return;
+    remove(index, len);
+    insert(index, ba.mid(0, len));
 }
 
 QChar XByteArray::asciiChar(int index)
 {
-    char ch = _data[index];
+    char ch = at(index);
     if ((ch < 0x20) or (ch > 0x7e))
             ch = '.';
     return QChar(ch);
@@ -145,8 +258,9 @@ QString XByteArray::toRedableString(int start, int end)
     if (_addressNumbers > adrWidth)
         adrWidth = _addressNumbers;
     if (end < 0)
-        end = _data.size();
+        end = size();
 
+    QByteArray data = mid(start, end - start);
     QString result;
     for (int i=start; i < end; i += 16)
     {
@@ -155,13 +269,219 @@ QString XByteArray::toRedableString(int start, int end)
         QString ascStr;
         for (int j=0; j<16; j++)
         {
-            if ((i + j) < _data.size())
+            if ((i + j) < end)
             {
-                hexStr.append(" ").append(_data.mid(i+j, 1).toHex());
-                ascStr.append(asciiChar(i+j));
+                char ch = data[i + j - start];
+                hexStr.append(" ").append(data.mid(i + j - start, 1).toHex());
+                ascStr.append(((ch < 0x20) or (ch > 0x7e)) ? QChar('.') : QChar(ch));
             }
         }
         result += adrStr + " " + QString("%1").arg(hexStr, -48) + "  " + QString("%1").arg(ascStr, -17) + "\n";
     }
     return result;
 }
+
+XByteArray::Node * XByteArray::newNode(const Piece & piece)
+{
+    // xorshift32
+    _seed ^= _seed << 13;
+    _seed ^= _seed >> 17;
+    _seed ^= _seed << 5;
+
+    Node *node = new Node;
+    node->left = NULL;
+    node->right = NULL;
+    node->priority = _seed;
+    node->piece = piece;
+    node->size = piece.length;
+    return node;
+}
+
+void XByteArray::freeTree(Node * node)
+{
+    if (node)
+    {
+        freeTree(node->left);
+        freeTree(node->right);
+        delete node;
+    }
+}
+
+void XByteArray::update(Node * node)
+{
+    node->size = sizeOf(node->left) + node->piece.length + sizeOf(node->right);
+}
+
+XByteArray::Node * XByteArray::merge(Node * a, Node * b)
+{
+    if (!a)
+        return b;
+    if (!b)
+        return a;
+    if (a->priority > b->priority)
+    {
+        a->right = merge(a->right, b);
+        update(a);
+        return a;
+    }
+    b->left = merge(a, b->left);
+    update(b);
+    return b;
+}
+
+// first pos bytes go to a, the rest to b; a piece crossing pos is cut in two
+void XByteArray::split(Node * node, int pos, Node * & a, Node * & b)
+{
+    if (!node)
+    {
+        a = b = NULL;
+        return;
+    }
+    int leftSize = sizeOf(node->left);
+    if (pos <= leftSize)
+    {
+        split(node->left, pos, a, node->left);
+        update(node);
+        b = node;
+    }
+    else if (pos >= leftSize + node->piece.length)
+    {
+        split(node->right, pos - leftSize - node->piece.length, node->right, b);
+        update(node);
+        a = node;
+    }
+    else
+    {
+        int head = pos - leftSize;
+        Piece piece = node->piece;
+        piece.offset += head;
+        piece.length -= head;
+
+        Node *right = node->right;
+        node->right = NULL;
+        node->piece.length = head;
+        update(node);
+        a = node;
+        b = merge(newNode(piece), right);
+    }
+}
+
+// appends piece to the last one of the tree, when it continues it in the same buffer
+bool XByteArray::extendLast(Node * node, const Piece & piece)
+{
+    if (!node)
+        return false;
+    bool extended;
+    if (node->right)
+        extended = extendLast(node->right, piece);
+    else
+        extended = (node->piece.inserted == piece.inserted)
+                   and (node->piece.changed == piece.changed)
+                   and (node->piece.offset + node->piece.length == piece.offset);
+    if (extended)
+    {
+        if (!node->right)
+            node->piece.length += piece.length;
+        node->size += piece.length;
+    }
+    return extended;
+}
+
+XByteArray::Node * XByteArray::find(int & i)
+{
+    Node *node = _root;
+    while (node)
+    {
+        int leftSize = sizeOf(node->left);
+        if (i < leftSize)
+            node = node->left;
+        else if (i < leftSize + node->piece.length)
+        {
+            i -= leftSize;
+            return node;
+        }
+        else
+        {
+            i -= leftSize + node->piece.length;
+            node = node->right;
+        }
+    }
+    return NULL;
+}
+
+void XByteArray::collect(Node * node, int base, int from, int to, Pieces & out)
+{
+    if (!node)
+        return;
+    int start = base + sizeOf(node->left);
+    int end = start + node->piece.length;
+    if (from < start)
+        collect(node->left, base, from, to, out);
+    if ((from < end) and (to > start))
+    {
+        Piece piece = node->piece;
+        int skip = qMax(from, start) - start;
+        piece.offset += skip;
+        piece.length = qMin(to, end) - start - skip;
+        out.append(piece);
+    }
+    if (to > end)
+        collect(node->right, end, from, to, out);
+}
+
+void XByteArray::setChanged(Node * node, bool state)
+{
+    if (node)
+    {
+        node->piece.changed = state;
+        setChanged(node->left, state);
+        setChanged(node->right, state);
+    }
+}
+
+void XByteArray::setChanged(int i, int len, bool state)
+{
+    if ((i < 0) or (i >= size()) or (len <= 0))
+        return;
+
+    Node *left, *middle, *right;
+    split(_root, i, left, right);
+    split(right, len, middle, right);
+    setChanged(middle, state);
+    _root = merge(merge(left, middle), right);
+}
+
+void XByteArray::insertPiece(int i, const Piece & piece)
+{
+    if (piece.length <= 0)
+        return;
+    if (i < 0)
+        i = 0;
+    if (i > size())
+        i = size();
+
+    Node *left, *right;
+    split(_root, i, left, right);
+    if (!extendLast(left, piece))
+        left = merge(left, newNode(piece));
+    _root = merge(left, right);
+
+    if (_sumValid)
+        _sum += pieceSum(piece);
+    _flatValid = false;
+    _flat.clear();
+}
+
+const char * XByteArray::pieceData(const Piece & piece)
+{
+    return (piece.inserted ? _inserted.constData() : _data.constData()) + piece.offset;
+}
+
+uint XByteArray::pieceSum(const Piece & piece)
+{
+    const uchar *ptr = reinterpret_cast<const uchar *>(pieceData(piece));
+    uint sum = 0;
+    for (int idx=0; idx < piece.length; idx++)
+        sum += ptr[idx];
+    return sum;
+}
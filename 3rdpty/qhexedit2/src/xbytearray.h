@@ -13,11 +13,31 @@ rendering of the data
 XByteArray also provides some functionality to insert, replace and remove
 single chars and QByteArras. Additionally some functions support rendering
 and converting to readable strings.
+
+The content is a piece table. The original data is never modified, inserted
+bytes are appended to a second buffer, and the content is a sequence of pieces
+of these two buffers. Pieces are nodes of a treap ordered by position, every
+node knows the size of its subtree, so finding, inserting and removing takes
+O(log n) in number of pieces. The changed state is stored per piece.
+The original data is not copied, it can be a QByteArray::fromRawData() over
+a memory mapped file. Because buffers are never overwritten, pieces() of a
+range stay valid until next setData() and are used as cheap undo snapshots.
 */
 class XByteArray
 {
 public:
+    /*! Part of the content, in the original or in the inserted data */
+    struct Piece
+    {
+        int offset;
+        int length;
+        bool inserted;
+        bool changed;
+    };
+    typedef QVector<Piece> Pieces;
+
     explicit XByteArray();
+    ~XByteArray();
 
     int addressOffset();
     void setAddressOffset(int offset);
@@ -25,8 +45,11 @@ public:
     int addressWidth();
     void setAddressWidth(int width);
 
-    QByteArray & data();
+    QByteArray data();
     void setData(QByteArray data);
+    char at(int i);
+    QByteArray mid(int i, int len);
+    uint byteSum();
 
     bool dataChanged(int i);
     QByteArray dataChanged(int i, int len);
@@ -36,14 +59,17 @@ public:
     int realAddressNumbers();
     int size();
 
-    QByteArray & insert(int i, char ch);
-    QByteArray & insert(int i, const QByteArray & ba);
+    void insert(int i, char ch);
+    void insert(int i, const QByteArray & ba);
+    void insert(int i, const Pieces & pieces);
+
+    Pieces pieces(int i, int len);
 
-    QByteArray & remove(int pos, int len);
+    void remove(int pos, int len);
 
-    QByteArray & replace(int index, char ch);
-    QByteArray & replace(int index, const QByteArray & ba);
-    QByteArray & replace(int index, int length, const QByteArray & ba);
+    void replace(int index, char ch);
+    void replace(int index, const QByteArray & ba);
+    void replace(int index, int length, const QByteArray & ba);
 
     QChar asciiChar(int index);
     QString toRedableString(int start=0, int end=-1);
@@ -53,8 +79,40 @@ signals:
 public slots:
 
 private:
-    QByteArray _data;
-    QByteArray _changedData;
+    Q_DISABLE_COPY(XByteArray)
+
+    struct Node
+    {
+        Node *left;
+        Node *right;
+        quint32 priority;
+        int size;                           // bytes in the subtree
+        Piece piece;
+    };
+
+    Node * newNode(const Piece & piece);
+    void freeTree(Node * node);
+    static int sizeOf(Node * node) { return node ? node->size : 0; }
+    static void update(Node * node);
+    Node * merge(Node * a, Node * b);
+    void split(Node * node, int pos, Node * & a, Node * & b);
+    bool extendLast(Node * node, const Piece & piece);
+    Node * find(int & i);
+    void collect(Node * node, int base, int from, int to, Pieces & out);
+    void setChanged(Node * node, bool state);
+    void setChanged(int i, int len, bool state);
+    void insertPiece(int i, const Piece & piece);
+    const char * pieceData(const Piece & piece);
+    uint pieceSum(const Piece & piece);
+
+    QByteArray _data;                       // original data
+    QByteArray _inserted;                   // inserted data, only appended
+    Node * _root;
+    quint32 _seed;                          // for node priorities
+    uint _sum;                              // sum of all bytes
+    bool _sumValid;
+    QByteArray _flat;                       // content returned by data()
+    bool _flatValid;
 
     int _addressNumbers;                    // wanted width of address area
     int _addressOffset;                     // will be added to the real addres inside bytearray
@@ -65,6 +65,7 @@ QT_BEGIN_NAMESPACE
 
 QSerialPortPrivateData::QSerialPortPrivateData(QSerialPort *q)
     : readBufferMaxSize(0)
+    , readTimestamp(0)
     , readBuffer(SERIALPORT_BUFFERSIZE)
     , writeBuffer(SERIALPORT_BUFFERSIZE)
     , error(QSerialPort::NoError)
@@ -75,7 +76,10 @@ QSerialPortPrivateData::QSerialPortPrivateData(QSerialPort *q)
     , stopBits(QSerialPort::OneStop)
     , flowControl(QSerialPort::NoFlowControl)
     , policy(QSerialPort::IgnorePolicy)
+    , counters(QSerialPort::LineCounters())
     , settingsRestoredOnClose(true)
+    , epollReactorEnabled(false)
+    , lowLatency(false)
     , q_ptr(q)
 {
 }
@@ -527,6 +531,7 @@ bool QSerialPort::open(OpenMode mode)
     }
 
     clearError();
+    d->counters = LineCounters();
     if (!d->open(mode))
         return false;
 
@@ -543,6 +548,11 @@ bool QSerialPort::open(OpenMode mode)
         return false;
     }
 
+    // Best effort, the port works without it; the failure is reported
+    // and isLowLatency() tells the profile is not active
+    if (d->lowLatency && !d->setLowLatency(true))
+        d->lowLatency = false;
+
     return true;
 }
 
@@ -839,6 +849,77 @@ QSerialPort::FlowControl QSerialPort::flowControl() const
     return d->flowControl;
 }
 
+/*!
+    Fills \a counters with the bytes and line errors counted since open().
+
+    On Linux the counters come from the driver (TIOCGICOUNT) when it
+    supports it, so they include errors the read path never sees, such as
+    overruns. Otherwise only what the backend counts itself is available:
+    bytes read and written, and the errors marked in the received stream
+    (PARMRK, used with StopReceivingPolicy) or reported by ClearCommError()
+    on Windows.
+
+    Returns false if the port is not open.
+*/
+bool QSerialPort::lineCounters(LineCounters *counters)
+{
+    Q_D(QSerialPort);
+
+    if (!isOpen())
+        return false;
+    return d->lineCounters(counters);
+}
+
+/*!
+    Returns the baud rate the device really runs at in given \a directions
+    (output for AllDirections). Drivers derive it from their clock and may
+    only get close to the requested one; Linux reports it through termios2,
+    elsewhere the requested rate is returned.
+
+    \sa baudRate()
+*/
+qint32 QSerialPort::actualBaudRate(Directions directions)
+{
+    Q_D(QSerialPort);
+    return d->actualBaudRate(directions);
+}
+
+/*!
+    Switches the low latency profile of the port, for request/response
+    traffic where the time to the first byte of the reply matters more than
+    the throughput.
+
+    On Linux it sets ASYNC_LOW_LATENCY of the serial driver, so received
+    bytes are passed to the tty layer at once, and lowers the latency timer
+    of USB-serial converters which have it in sysfs (FTDI holds received
+    bytes up to 16 ms by default). Writing the latency timer usually needs
+    root or a udev rule; it is restored on close(). If it cannot be written
+    the driver flag is taken back, PermissionError is reported and false
+    returned. Other platforms do not support it and return false.
+
+    Can be set before open(), the profile is then applied when the port
+    is opened.
+
+    \sa isLowLatency()
+*/
+bool QSerialPort::setLowLatency(bool enable)
+{
+    Q_D(QSerialPort);
+
+    if (!isOpen() || d->setLowLatency(enable)) {
+        d->lowLatency = enable;
+        return true;
+    }
+
+    return false;
+}
+
+bool QSerialPort::isLowLatency() const
+{
+    Q_D(const QSerialPort);
+    return d->lowLatency;
+}
+
 bool QSerialPort::setTimeout(long millisec)
 {
     Q_D(QSerialPort);
@@ -1159,6 +1240,81 @@ qint64 QSerialPort::readBufferSize() const
     return d->readBufferMaxSize;
 }
 
+/*!
+    Returns the monotonic time, in nanoseconds, at which the most recent
+    chunk of data was read from the device into the internal read buffer.
+
+    The value is taken right after the read system call, so it is much
+    closer to the real arrival time than anything measured in a slot
+    connected to readyRead(). On Unix it is CLOCK_MONOTONIC, other
+    platforms return 0 (not supported).
+*/
+qint64 QSerialPort::readTimestamp() const
+{
+    Q_D(const QSerialPort);
+    return d->readTimestamp;
+}
+
+/*!
+    Gives direct access to the internal read buffer, without copying. Sets
+    \a data to the first contiguous block of received data and returns its
+    size. The block stays valid until consumeReadBuffer() or any read call.
+
+    Returns 0 when the buffer is empty, or when QIODevice holds buffered
+    data that has to be taken first with read().
+
+    \sa consumeReadBuffer(), bytesAvailable()
+*/
+qint64 QSerialPort::peekReadBuffer(const char **data) const
+{
+    Q_D(const QSerialPort);
+
+    if (QIODevice::bytesAvailable() > 0 || d->readBuffer.isEmpty())
+        return 0;
+    *data = d->readBuffer.readPointer();
+    return d->readBuffer.nextDataBlockSize();
+}
+
+/*!
+    Removes \a size bytes, returned by peekReadBuffer(), from the internal
+    read buffer.
+
+    \sa peekReadBuffer()
+*/
+void QSerialPort::consumeReadBuffer(qint64 size)
+{
+    Q_D(QSerialPort);
+    d->readBuffer.free(size);
+}
+
+/*!
+    Makes the port, when opened next time, register its descriptor in an
+    epoll set shared by all ports of the thread instead of having socket
+    notifiers of its own. The event loop then wakes up once for any number
+    of ready ports, which pays off with many ports served by one thread.
+
+    Only on Linux; elsewhere, or when epoll is not available, the port
+    uses socket notifiers.
+
+    \sa isEpollReactorEnabled()
+*/
+void QSerialPort::setEpollReactorEnabled(bool enable)
+{
+    Q_D(QSerialPort);
+    d->epollReactorEnabled = enable;
+}
+
+/*!
+    Returns true when the port is set to use the shared epoll set.
+
+    \sa setEpollReactorEnabled()
+*/
+bool QSerialPort::isEpollReactorEnabled() const
+{
+    Q_D(const QSerialPort);
+    return d->epollReactorEnabled;
+}
+
 /*!
     Sets the size of QSerialPort's internal read buffer to be \a
     size bytes.
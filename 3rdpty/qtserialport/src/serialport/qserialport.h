@@ -208,6 +208,7 @@ public:
 
     bool setBaudRate(qint32 baudRate, Directions directions = AllDirections);
     qint32 baudRate(Directions directions = AllDirections) const;
+    qint32 actualBaudRate(Directions directions = AllDirections);
 
     bool setDataBits(DataBits dataBits);
     DataBits dataBits() const;
@@ -224,6 +225,9 @@ public:
     bool setTimeout(long millisec);
     long getTimeout();
 
+    bool setLowLatency(bool enable);
+    bool isLowLatency() const;
+
     bool setDataTerminalReady(bool set);
     bool isDataTerminalReady();
 
@@ -244,8 +248,27 @@ public:
     SerialPortError error() const;
     void clearError();
 
+    // Line statistics since open()
+    struct LineCounters
+    {
+        qint64 rxBytes;
+        qint64 txBytes;
+        qint64 frameErrors;
+        qint64 parityErrors;
+        qint64 overruns;            // receiver FIFO overrun
+        qint64 bufferOverruns;      // driver buffer full
+        qint64 breaks;
+    };
+    bool lineCounters(LineCounters *counters);
+
     qint64 readBufferSize() const;
     void setReadBufferSize(qint64 size);
+    qint64 readTimestamp() const;
+    qint64 peekReadBuffer(const char **data) const;
+    void consumeReadBuffer(qint64 size);
+
+    void setEpollReactorEnabled(bool enable);
+    bool isEpollReactorEnabled() const;
 
     bool isSequential() const Q_DECL_OVERRIDE;
 
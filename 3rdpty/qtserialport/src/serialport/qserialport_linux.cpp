@@ -0,0 +1,66 @@
+/****************************************************************************
+**
+** termios2 baud rate helpers of the Linux QSerialPort backend, added to
+** the QtSerialPort copy bundled with rs232test.
+**
+** This file is distributed under the same terms as the rest of the
+** QtSerialPort module: the GNU Lesser General Public License version 2.1
+** (see LICENSE.LGPL) with the Qt LGPL Exception version 1.1 (see
+** LGPL_EXCEPTION.txt), or the GNU General Public License version 3.0
+** (see LICENSE.GPL).
+**
+****************************************************************************/
+
+// termios2 is declared only in <asm/termbits.h>, which clashes with the
+// libc <termios.h> used by qserialport_unix.cpp, so it gets a file of its own.
+
+#include <QtCore/qglobal.h>
+
+#include <errno.h>
+#include <sys/ioctl.h>
+#include <asm/termbits.h>
+
+QT_BEGIN_NAMESPACE
+
+bool qt_linux_set_baudrate(int descriptor, qint32 inputBaudRate, qint32 outputBaudRate)
+{
+#if defined(TCGETS2) && defined(BOTHER)
+    struct termios2 tio;
+    if (::ioctl(descriptor, TCGETS2, &tio) == -1)
+        return false;
+
+    tio.c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT));
+    tio.c_cflag |= BOTHER | (BOTHER << IBSHIFT);
+    tio.c_ispeed = inputBaudRate;
+    tio.c_ospeed = outputBaudRate;
+    return ::ioctl(descriptor, TCSETS2, &tio) != -1;
+#else
+    Q_UNUSED(descriptor);
+    Q_UNUSED(inputBaudRate);
+    Q_UNUSED(outputBaudRate);
+    errno = ENOTTY;
+    return false;
+#endif
+}
+
+bool qt_linux_get_baudrate(int descriptor, qint32 *inputBaudRate, qint32 *outputBaudRate)
+{
+#if defined(TCGETS2) && defined(BOTHER)
+    struct termios2 tio;
+    if (::ioctl(descriptor, TCGETS2, &tio) == -1)
+        return false;
+
+    // drivers store the rate they could really set
+    *inputBaudRate = tio.c_ispeed;
+    *outputBaudRate = tio.c_ospeed;
+    return true;
+#else
+    Q_UNUSED(descriptor);
+    Q_UNUSED(inputBaudRate);
+    Q_UNUSED(outputBaudRate);
+    errno = ENOTTY;
+    return false;
+#endif
+}
+
+QT_END_NAMESPACE
@@ -54,13 +54,16 @@ class QSerialPortPrivateData
 {
 public:
     enum IoConstants {
-        ReadChunkSize = 512
+        ReadChunkSize = 512,
+        MaxReadChunkSize = 65536,   // upper bound of a read sized from the driver queue
+        ReadTimeBudget = 2          // ms spent draining the driver per notification
     };
 
     QSerialPortPrivateData(QSerialPort *q);
     int timeoutValue(int msecs, int elapsed);
 
     qint64 readBufferMaxSize;
+    qint64 readTimestamp;
     QRingBuffer readBuffer;
     QRingBuffer writeBuffer;
     QSerialPort::SerialPortError error;
@@ -72,9 +75,12 @@ public:
     QSerialPort::StopBits stopBits;
     QSerialPort::FlowControl flowControl;
     QSerialPort::DataErrorPolicy policy;
+    QSerialPort::LineCounters counters;     // counted by the backend itself
     bool dataTerminalReady;
     bool requestToSend;
     bool settingsRestoredOnClose;
+    bool epollReactorEnabled;
+    bool lowLatency;
     QSerialPort * const q_ptr;
 };
 
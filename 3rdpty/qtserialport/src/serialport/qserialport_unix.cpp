@@ -44,10 +44,16 @@
 #include "qserialport_unix_p.h"
 
 #include <errno.h>
+#include <time.h>
 #include <sys/time.h>
 #include <sys/ioctl.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <poll.h>
+
+#ifdef Q_OS_LINUX
+#include <sys/epoll.h>
+#endif
 
 #ifdef Q_OS_MAC
 #if defined (MAC_OS_X_VERSION_10_4) && (MAC_OS_X_VERSION_MIN_REQUIRED >= MAC_OS_X_VERSION_10_4)
@@ -58,8 +64,11 @@
 #include <private/qcore_unix_p.h>
 
 #include <QtCore/qelapsedtimer.h>
+#include <QtCore/qfile.h>
 #include <QtCore/qsocketnotifier.h>
 #include <QtCore/qmap.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qthreadstorage.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -101,6 +110,33 @@ QString serialPortLockFilePath(const QString &portName)
     return lockFilePath;
 }
 
+#ifdef Q_OS_LINUX
+// sysfs latency timer of a USB-serial converter, empty if it has none
+static QString latencyTimerPath(const QString &systemLocation)
+{
+    const QString device = QFileInfo(QFileInfo(systemLocation).canonicalFilePath()).fileName();
+    const QString path = QStringLiteral("/sys/bus/usb-serial/devices/") + device
+            + QStringLiteral("/latency_timer");
+    return QFileInfo(path).exists() ? path : QString();
+}
+
+static int readLatencyTimer(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return -1;
+    bool ok;
+    const int msecs = file.readAll().trimmed().toInt(&ok);
+    return ok ? msecs : -1;
+}
+
+static bool writeLatencyTimer(const QString &path, int msecs)
+{
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write(QByteArray::number(msecs)) > 0;
+}
+#endif
+
 class ReadNotifier : public QSocketNotifier
 {
     Q_OBJECT
@@ -166,10 +202,143 @@ private:
 
 #include "qserialport_unix.moc"
 
+#ifdef Q_OS_LINUX
+
+// One epoll set per thread for the ports that use it, the event loop watches
+// only its descriptor instead of three notifiers per port. Registrations are
+// edge triggered, a port is re-armed by update() when its handler did not
+// drain the driver or it still waits for writing.
+class EpollReactor : public QSocketNotifier
+{
+public:
+    static EpollReactor *forCurrentThread();
+
+    bool update(QSerialPortPrivate *d, quint32 events);
+    void remove(QSerialPortPrivate *d);
+
+protected:
+    bool event(QEvent *e) Q_DECL_OVERRIDE {
+        bool ret = QSocketNotifier::event(e);
+        if (ret)
+            dispatch();
+        return ret;
+    }
+
+private:
+    explicit EpollReactor(int fd);
+    ~EpollReactor();
+
+    void dispatch();
+
+    enum { MaxEvents = 64 };
+
+    int epollFd;
+    int ports;
+    int eventCount;
+    struct epoll_event events[MaxEvents];
+};
+
+static QThreadStorage<QPointer<EpollReactor> > epollReactors;
+
+EpollReactor::EpollReactor(int fd)
+    : QSocketNotifier(fd, QSocketNotifier::Read)
+    , epollFd(fd)
+    , ports(0)
+    , eventCount(0)
+{
+}
+
+EpollReactor::~EpollReactor()
+{
+    qt_safe_close(epollFd);
+}
+
+EpollReactor *EpollReactor::forCurrentThread()
+{
+    EpollReactor *reactor = epollReactors.localData();
+    if (!reactor) {
+        int fd = ::epoll_create1(EPOLL_CLOEXEC);
+        if (fd == -1)
+            return 0;
+        reactor = new EpollReactor(fd);
+        epollReactors.setLocalData(reactor);
+    }
+    return reactor;
+}
+
+bool EpollReactor::update(QSerialPortPrivate *d, quint32 events)
+{
+    struct epoll_event ev;
+    ev.events = events | EPOLLET;
+    ev.data.ptr = d;
+
+    // MOD also re-arms the edge triggered registration
+    if (d->reactor == this)
+        return ::epoll_ctl(epollFd, EPOLL_CTL_MOD, d->descriptor, &ev) != -1;
+
+    if (::epoll_ctl(epollFd, EPOLL_CTL_ADD, d->descriptor, &ev) == -1)
+        return false;
+    d->reactor = this;
+    ++ports;
+    return true;
+}
+
+void EpollReactor::remove(QSerialPortPrivate *d)
+{
+    ::epoll_ctl(epollFd, EPOLL_CTL_DEL, d->descriptor, 0);
+    d->reactor = 0;
+
+    // the port may be closed from a handler, drop its events of this round
+    for (int i = 0; i < eventCount; ++i) {
+        if (events[i].data.ptr == d)
+            events[i].data.ptr = 0;
+    }
+
+    if (--ports == 0) {
+        if (epollReactors.localData() == this)
+            epollReactors.setLocalData(QPointer<EpollReactor>());
+        setEnabled(false);
+        deleteLater();
+    }
+}
+
+void EpollReactor::dispatch()
+{
+    eventCount = ::epoll_wait(epollFd, events, MaxEvents, 0);
+
+    for (int i = 0; i < eventCount; ++i) {
+        QSerialPortPrivate *d = static_cast<QSerialPortPrivate *>(events[i].data.ptr);
+        const quint32 ready = events[i].events;
+
+        if (d && (ready & (EPOLLIN | EPOLLERR | EPOLLHUP)) && (d->reactorEvents & EPOLLIN))
+            d->readNotification();
+        if (events[i].data.ptr && (ready & EPOLLPRI) && (d->reactorEvents & EPOLLPRI))
+            d->exceptionNotification();
+        if (events[i].data.ptr && (ready & EPOLLOUT) && (d->reactorEvents & EPOLLOUT))
+            d->completeAsyncWrite();
+
+        if (events[i].data.ptr && (!d->readDrained || (d->reactorEvents & EPOLLOUT)))
+            update(d, d->reactorEvents);
+    }
+    eventCount = 0;
+}
+
+#endif // Q_OS_LINUX
+
 QSerialPortPrivate::QSerialPortPrivate(QSerialPort *q)
     : QSerialPortPrivateData(q)
     , descriptor(-1)
     , isCustomBaudRateSupported(false)
+#ifdef Q_OS_LINUX
+    , latencyTimerRestore(-1)
+    , isTermios2Supported(false)
+    , isTermios2BaudRate(false)
+    , termios2InputBaudRate(0)
+    , termios2OutputBaudRate(0)
+#endif
+#ifdef QSERIALPORT_HAS_ICOUNT
+    , isICountSupported(false)
+#endif
     , readNotifier(0)
     , writeNotifier(0)
     , exceptionNotifier(0)
@@ -180,6 +349,12 @@ QSerialPortPrivate::QSerialPortPrivate(QSerialPort *q)
     , emittedBytesWritten(false)
     , pendingBytesWritten(0)
     , writeSequenceStarted(false)
+    , readDrained(true)
+#ifdef Q_OS_LINUX
+    , reactor(0)
+    , reactorEvents(0)
+    , useReactor(false)
+#endif
 {
 }
 
@@ -263,6 +438,21 @@ bool QSerialPortPrivate::open(QIODevice::OpenMode mode)
 #ifdef Q_OS_LINUX
     isCustomBaudRateSupported = (::ioctl(descriptor, TIOCGSERIAL, &currentSerialInfo) != -1)
             && (::ioctl(descriptor, TIOCSSERIAL, &currentSerialInfo) != -1);
+    if (isCustomBaudRateSupported)
+        restoredSerialInfo = currentSerialInfo;
+
+    qint32 inputRate;
+    qint32 outputRate;
+    isTermios2Supported = qt_linux_get_baudrate(descriptor, &inputRate, &outputRate);
+#endif
+
+#ifdef QSERIALPORT_HAS_ICOUNT
+    // the driver counts from its first open, the port reports from this one
+    isICountSupported = ::ioctl(descriptor, TIOCGICOUNT, &icountBase) != -1;
+#endif
+
+#ifdef Q_OS_LINUX
+    useReactor = epollReactorEnabled;
 #endif
 
     setExceptionNotificationEnabled(true);
@@ -294,6 +484,21 @@ void QSerialPortPrivate::close()
         q->setError(decodeSystemError());
 #endif
 
+#ifdef Q_OS_LINUX
+    // The latency timer belongs to the device, not to this descriptor
+    if (latencyTimerRestore >= 0) {
+        writeLatencyTimer(latencyTimerPath(systemLocation), latencyTimerRestore);
+        latencyTimerRestore = -1;
+    }
+#endif
+
+#ifdef Q_OS_LINUX
+    if (reactor)
+        reactor->remove(this);
+    reactorEvents = 0;
+    useReactor = false;
+#endif
+
     if (readNotifier) {
         readNotifier->setEnabled(false);
         readNotifier->deleteLater();
@@ -320,6 +525,10 @@ void QSerialPortPrivate::close()
 
     descriptor = -1;
     isCustomBaudRateSupported = false;
+#ifdef Q_OS_LINUX
+    isTermios2Supported = false;
+    isTermios2BaudRate = false;
+#endif
     pendingBytesWritten = 0;
     writeSequenceStarted = false;
 }
@@ -539,13 +748,28 @@ bool QSerialPortPrivate::setBaudRate(qint32 baudRate, QSerialPort::Directions di
 
     bool ret = baudRate > 0;
 
+    // the settings the tty runs with, put back if the new rate fails
+    const struct termios oldTermios = currentTermios;
+#ifdef Q_OS_LINUX
+    const struct serial_struct oldSerialInfo = currentSerialInfo;
+    const bool wasTermios2BaudRate = isTermios2BaudRate;
+    const qint32 oldTermios2InputBaudRate = termios2InputBaudRate;
+    const qint32 oldTermios2OutputBaudRate = termios2OutputBaudRate;
+#endif
+
     // prepare section
 
     if (ret) {
-        const qint32 unixBaudRate = QSerialPortPrivate::settingFromBaudRate(baudRate);
+        qint32 unixBaudRate = QSerialPortPrivate::settingFromBaudRate(baudRate);
+#ifdef Q_OS_LINUX
+        // once the other direction runs at an arbitrary rate, both stay in termios2
+        if (isTermios2BaudRate && directions != QSerialPort::AllDirections)
+            unixBaudRate = 0;
+#endif
         if (unixBaudRate > 0) {
             // try prepate to set standard baud rate
 #ifdef Q_OS_LINUX
+            isTermios2BaudRate = false;
             // prepare to forcefully reset the custom mode
             if (isCustomBaudRateSupported) {
                 //currentSerialInfo.flags |= ASYNC_SPD_MASK;
@@ -559,8 +783,23 @@ bool QSerialPortPrivate::setBaudRate(qint32 baudRate, QSerialPort::Directions di
         } else {
             // try prepate to set custom baud rate
 #ifdef Q_OS_LINUX
-            // prepare to forcefully set the custom mode
-            if (isCustomBaudRateSupported) {
+            if (isTermios2Supported) {
+                // any rate with BOTHER, set by updateTermios() after tcsetattr()
+                if (!isTermios2BaudRate) {
+                    termios2InputBaudRate = baudRateFromSetting(::cfgetispeed(&currentTermios));
+                    termios2OutputBaudRate = baudRateFromSetting(::cfgetospeed(&currentTermios));
+                }
+                if (directions & QSerialPort::Input)
+                    termios2InputBaudRate = baudRate;
+                if (directions & QSerialPort::Output)
+                    termios2OutputBaudRate = baudRate;
+                isTermios2BaudRate = true;
+                if (isCustomBaudRateSupported) {
+                    currentSerialInfo.flags &= ~ASYNC_SPD_CUST;
+                    currentSerialInfo.custom_divisor = 0;
+                }
+            } else if (isCustomBaudRateSupported) {
+                // prepare to forcefully set the custom mode
                 currentSerialInfo.flags &= ~ASYNC_SPD_MASK;
                 currentSerialInfo.flags |= (ASYNC_SPD_CUST /* | ASYNC_LOW_LATENCY*/);
                 currentSerialInfo.custom_divisor = currentSerialInfo.baud_base / baudRate;
@@ -602,9 +841,82 @@ bool QSerialPortPrivate::setBaudRate(qint32 baudRate, QSerialPort::Directions di
         ret = updateTermios();
     else
         q->setError(decodeSystemError());
+
+#ifdef Q_OS_LINUX
+    // the driver may only get close to the rate, a few percent off is a
+    // rate the other side cannot receive
+    if (ret && isTermios2BaudRate) {
+        qint32 actualInput;
+        qint32 actualOutput;
+        if (qt_linux_get_baudrate(descriptor, &actualInput, &actualOutput)) {
+            const qint32 actual = (directions & QSerialPort::Output) ? actualOutput : actualInput;
+            if (qAbs(qint64(actual) - baudRate) * 100 > qint64(baudRate) * MaxBaudRateErrorPercent) {
+                qWarning("Baud rate %d is not supported by the device, it would run at %d",
+                         int(baudRate), int(actual));
+                q->setError(QSerialPort::UnsupportedOperationError);
+                ret = false;
+            }
+        }
+    }
+
+#endif
+
+    if (!ret && baudRate > 0) {
+        // some of the new settings may have reached the device already
+        const QSerialPort::SerialPortError error = q->error();
+        const QString errorString = q->errorString();
+        currentTermios = oldTermios;
+#ifdef Q_OS_LINUX
+        isTermios2BaudRate = wasTermios2BaudRate;
+        termios2InputBaudRate = oldTermios2InputBaudRate;
+        termios2OutputBaudRate = oldTermios2OutputBaudRate;
+        if (isCustomBaudRateSupported) {
+            currentSerialInfo = oldSerialInfo;
+            if (::ioctl(descriptor, TIOCSSERIAL, &currentSerialInfo) == -1)
+                qWarning("Cannot restore the serial info of %s", qPrintable(systemLocation));
+        }
+#endif
+        if (!updateTermios()) {
+            qWarning("Cannot restore the baud rate of %s", qPrintable(systemLocation));
+            // report why the new rate failed, not the restore
+            q->setError(error, errorString);
+        }
+    }
     return ret;
 }
 
+bool QSerialPortPrivate::lineCounters(QSerialPort::LineCounters *counters)
+{
+    *counters = this->counters;
+
+#ifdef QSERIALPORT_HAS_ICOUNT
+    struct serial_icounter_struct icount;
+    if (isICountSupported && ::ioctl(descriptor, TIOCGICOUNT, &icount) != -1) {
+        // 32 bit driver counters, the difference survives a wrap
+        counters->rxBytes = quint32(icount.rx) - quint32(icountBase.rx);
+        counters->txBytes = quint32(icount.tx) - quint32(icountBase.tx);
+        counters->frameErrors = quint32(icount.frame) - quint32(icountBase.frame);
+        counters->parityErrors = quint32(icount.parity) - quint32(icountBase.parity);
+        counters->overruns = quint32(icount.overrun) - quint32(icountBase.overrun);
+        counters->bufferOverruns = quint32(icount.buf_overrun) - quint32(icountBase.buf_overrun);
+        counters->breaks = quint32(icount.brk) - quint32(icountBase.brk);
+    }
+#endif
+    return true;
+}
+
+qint32 QSerialPortPrivate::actualBaudRate(QSerialPort::Directions directions)
+{
+    const qint32 requested = (directions & QSerialPort::Output) ? outputBaudRate : inputBaudRate;
+#ifdef Q_OS_LINUX
+    qint32 actualInput;
+    qint32 actualOutput;
+    if (descriptor != -1 && qt_linux_get_baudrate(descriptor, &actualInput, &actualOutput))
+        return (directions & QSerialPort::Output) ? actualOutput : actualInput;
+#endif
+    return requested;
+}
+
 bool QSerialPortPrivate::setDataBits(QSerialPort::DataBits dataBits)
 {
     currentTermios.c_cflag &= ~CSIZE;
@@ -737,6 +1049,71 @@ bool QSerialPortPrivate::setDataErrorPolicy(QSerialPort::DataErrorPolicy policy)
     return updateTermios();
 }
 
+bool QSerialPortPrivate::setLowLatency(bool enable)
+{
+    // VMIN/VTIME stay 0: reads are non-blocking, the descriptor is readable
+    // from the first byte and a larger VMIN would only delay the wakeup
+#ifdef Q_OS_LINUX
+    Q_Q(QSerialPort);
+
+    // the driver pushes received bytes to the tty layer at once instead of
+    // deferring it to a work queue
+    if (isCustomBaudRateSupported) {
+        if (enable)
+            currentSerialInfo.flags |= ASYNC_LOW_LATENCY;
+        else
+            currentSerialInfo.flags &= ~ASYNC_LOW_LATENCY;
+        if (::ioctl(descriptor, TIOCSSERIAL, &currentSerialInfo) == -1) {
+            q->setError(decodeSystemError());
+            return false;
+        }
+    }
+
+    // USB-serial converters hold received bytes until their latency timer
+    // expires, 16 ms by default
+    const QString path = latencyTimerPath(systemLocation);
+    if (!path.isEmpty()) {
+        if (enable) {
+            const bool firstWrite = latencyTimerRestore < 0;
+            if (firstWrite)
+                latencyTimerRestore = readLatencyTimer(path);
+            if (!writeLatencyTimer(path, 1)) {
+                // half a profile is not a low latency one - take the driver flag back
+                if (firstWrite)
+                    latencyTimerRestore = -1;
+                if (isCustomBaudRateSupported) {
+                    currentSerialInfo.flags &= ~ASYNC_LOW_LATENCY;
+                    ::ioctl(descriptor, TIOCSSERIAL, &currentSerialInfo);
+                }
+                q->setError(QSerialPort::PermissionError,
+                            QSerialPort::tr("Cannot write %1, no write access?").arg(path));
+                return false;
+            }
+        } else if (latencyTimerRestore >= 0) {
+            writeLatencyTimer(path, latencyTimerRestore);
+            latencyTimerRestore = -1;
+        }
+    }
+    return true;
+#else
+    return !enable;
+#endif
+}
+
+// CLOCK_MONOTONIC in nanoseconds, wall clock where it is not available
+static qint64 monotonicTime()
+{
+#ifdef CLOCK_MONOTONIC
+    struct timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return qint64(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#else
+    struct timeval tv;
+    ::gettimeofday(&tv, 0);
+    return qint64(tv.tv_sec) * 1000000000 + qint64(tv.tv_usec) * 1000;
+#endif
+}
+
 bool QSerialPortPrivate::readNotification()
 {
     Q_Q(QSerialPort);
@@ -751,33 +1128,72 @@ bool QSerialPortPrivate::readNotification()
     }
 
     readPortNotifierCalled = true;
+    readDrained = true;
 
     // Always buffered, read data from the port into the read buffer
     qint64 newBytes = readBuffer.size();
-    qint64 bytesToRead = policy == QSerialPort::IgnorePolicy ? ReadChunkSize : 1;
+    bool firstRead = true;
+
+    // Drain the driver: reads are sized from the bytes it holds and repeated
+    // until it is empty, so a burst costs a few syscalls instead of one per chunk
+    forever {
+        qint64 bytesToRead = policy == QSerialPort::IgnorePolicy ? ReadChunkSize : 1;
+
+        if (policy == QSerialPort::IgnorePolicy) {
+            int pending = 0;
+            if (::ioctl(descriptor, FIONREAD, &pending) != -1) {
+                if (pending == 0 && !firstRead)
+                    break;
+                if (pending > bytesToRead)
+                    bytesToRead = qMin(qint64(pending), qint64(MaxReadChunkSize));
+            }
+        }
+
+        if (readBufferMaxSize && bytesToRead > (readBufferMaxSize - readBuffer.size())) {
+            bytesToRead = readBufferMaxSize - readBuffer.size();
+            if (bytesToRead == 0) {
+                // Buffer is full. User must read data from the buffer
+                // before we can read more from the port.
+                if (firstRead)
+                    return false;
+                break;
+            }
+        }
+
+        char *ptr = readBuffer.reserve(bytesToRead);
+        const qint64 readBytes = readFromPort(ptr, bytesToRead);
 
-    if (readBufferMaxSize && bytesToRead > (readBufferMaxSize - readBuffer.size())) {
-        bytesToRead = readBufferMaxSize - readBuffer.size();
-        if (bytesToRead == 0) {
-            // Buffer is full. User must read data from the buffer
-            // before we can read more from the port.
+        if (readBytes <= 0) {
+            readBuffer.chop(bytesToRead);
+            if (!firstRead)
+                break;  // EAGAIN, the driver is empty
+
+            QSerialPort::SerialPortError error = decodeSystemError();
+            if (error != QSerialPort::ResourceError)
+                error = QSerialPort::ReadError;
+            q->setError(error);
             return false;
         }
-    }
 
-    char *ptr = readBuffer.reserve(bytesToRead);
-    const qint64 readBytes = readFromPort(ptr, bytesToRead);
+        readBuffer.chop(bytesToRead - qMax(readBytes, qint64(0)));
 
-    if (readBytes <= 0) {
-        QSerialPort::SerialPortError error = decodeSystemError();
-        if (error != QSerialPort::ResourceError)
-            error = QSerialPort::ReadError;
-        q->setError(error);
-        readBuffer.chop(bytesToRead);
-        return false;
-    }
+        const qint64 now = monotonicTime();
+        if (firstRead) {
+            // Arrival time of the chunk, as close to read() as we can get
+            readTimestamp = now;
+            firstRead = false;
+        }
 
-    readBuffer.chop(bytesToRead - qMax(readBytes, qint64(0)));
+        // Short read means the driver is empty; the time budget keeps the
+        // event loop responsive under a continuous stream
+        if (readBytes < bytesToRead)
+            break;
+        if (policy != QSerialPort::IgnorePolicy
+                || now - readTimestamp >= qint64(ReadTimeBudget) * 1000000) {
+            readDrained = false;
+            break;
+        }
+    }
 
     newBytes = readBuffer.size() - newBytes;
 
@@ -872,6 +1288,15 @@ bool QSerialPortPrivate::updateTermios()
         q->setError(decodeSystemError());
         return false;
     }
+
+#ifdef Q_OS_LINUX
+    // tcsetattr() knows only the Bxxx rates, an arbitrary one goes after it
+    if (isTermios2BaudRate
+            && !qt_linux_set_baudrate(descriptor, termios2InputBaudRate, termios2OutputBaudRate)) {
+        q->setError(decodeSystemError());
+        return false;
+    }
+#endif
     return true;
 }
 
@@ -909,8 +1334,34 @@ QSerialPort::SerialPortError QSerialPortPrivate::decodeSystemError() const
     return error;
 }
 
+#ifdef Q_OS_LINUX
+bool QSerialPortPrivate::setReactorEvent(quint32 event, bool enable)
+{
+    if (!useReactor)
+        return false;
+
+    const quint32 events = enable ? (reactorEvents | event) : (reactorEvents & ~event);
+    EpollReactor *target = reactor ? reactor : EpollReactor::forCurrentThread();
+    if (target && target->update(this, events)) {
+        reactorEvents = events;
+        return true;
+    }
+
+    // No epoll here, the port goes on with socket notifiers
+    if (!reactor) {
+        useReactor = false;
+        return false;
+    }
+    return true;
+}
+#endif
+
 bool QSerialPortPrivate::isReadNotificationEnabled() const
 {
+#ifdef Q_OS_LINUX
+    if (useReactor)
+        return reactorEvents & EPOLLIN;
+#endif
     return readNotifier && readNotifier->isEnabled();
 }
 
@@ -918,6 +1369,11 @@ void QSerialPortPrivate::setReadNotificationEnabled(bool enable)
 {
     Q_Q(QSerialPort);
 
+#ifdef Q_OS_LINUX
+    if (setReactorEvent(EPOLLIN, enable))
+        return;
+#endif
+
     if (readNotifier) {
         readNotifier->setEnabled(enable);
     } else if (enable) {
@@ -928,6 +1384,10 @@ void QSerialPortPrivate::setReadNotificationEnabled(bool enable)
 
 bool QSerialPortPrivate::isWriteNotificationEnabled() const
 {
+#ifdef Q_OS_LINUX
+    if (useReactor)
+        return reactorEvents & EPOLLOUT;
+#endif
     return writeNotifier && writeNotifier->isEnabled();
 }
 
@@ -935,6 +1395,11 @@ void QSerialPortPrivate::setWriteNotificationEnabled(bool enable)
 {
     Q_Q(QSerialPort);
 
+#ifdef Q_OS_LINUX
+    if (setReactorEvent(EPOLLOUT, enable))
+        return;
+#endif
+
     if (writeNotifier) {
         writeNotifier->setEnabled(enable);
     } else if (enable) {
@@ -945,6 +1410,10 @@ void QSerialPortPrivate::setWriteNotificationEnabled(bool enable)
 
 bool QSerialPortPrivate::isExceptionNotificationEnabled() const
 {
+#ifdef Q_OS_LINUX
+    if (useReactor)
+        return reactorEvents & EPOLLPRI;
+#endif
     return exceptionNotifier && exceptionNotifier->isEnabled();
 }
 
@@ -952,6 +1421,11 @@ void QSerialPortPrivate::setExceptionNotificationEnabled(bool enable)
 {
     Q_Q(QSerialPort);
 
+#ifdef Q_OS_LINUX
+    if (setReactorEvent(EPOLLPRI, enable))
+        return;
+#endif
+
     if (exceptionNotifier) {
         exceptionNotifier->setEnabled(enable);
     } else if (enable) {
@@ -970,21 +1444,14 @@ bool QSerialPortPrivate::waitForReadOrWrite(bool *selectForRead, bool *selectFor
     Q_ASSERT(selectForWrite);
     Q_ASSERT(timedOut);
 
-    fd_set fdread;
-    FD_ZERO(&fdread);
-    if (checkRead)
-        FD_SET(descriptor, &fdread);
-
-    fd_set fdwrite;
-    FD_ZERO(&fdwrite);
-    if (checkWrite)
-        FD_SET(descriptor, &fdwrite);
-
-    struct timeval tv;
-    tv.tv_sec = msecs / 1000;
-    tv.tv_usec = (msecs % 1000) * 1000;
+    // poll() rather than select(), descriptors of a process with many ports
+    // open can be above FD_SETSIZE
+    struct pollfd pfd;
+    pfd.fd = descriptor;
+    pfd.events = (checkRead ? POLLIN : 0) | (checkWrite ? POLLOUT : 0);
+    pfd.revents = 0;
 
-    int ret = ::select(descriptor + 1, &fdread, &fdwrite, 0, msecs < 0 ? 0 : &tv);
+    int ret = ::poll(&pfd, 1, msecs < 0 ? -1 : msecs);
     if (ret < 0)
         return false;
     if (ret == 0) {
@@ -993,8 +1460,8 @@ bool QSerialPortPrivate::waitForReadOrWrite(bool *selectForRead, bool *selectFor
         return false;
     }
 
-    *selectForRead = FD_ISSET(descriptor, &fdread);
-    *selectForWrite = FD_ISSET(descriptor, &fdwrite);
+    *selectForRead = checkRead && (pfd.revents & (POLLIN | POLLERR | POLLHUP));
+    *selectForWrite = checkWrite && (pfd.revents & (POLLOUT | POLLERR | POLLHUP));
 
     return ret;
 }
@@ -1014,6 +1481,8 @@ qint64 QSerialPortPrivate::readFromPort(char *data, qint64 maxSize)
         bytesRead = readPerChar(data, maxSize);
     }
 
+    if (bytesRead > 0)
+        counters.rxBytes += bytesRead;
     return bytesRead;
 }
 
@@ -1031,6 +1500,8 @@ qint64 QSerialPortPrivate::writeToPort(const char *data, qint64 maxSize)
     }
 #endif
 
+    if (bytesWritten > 0)
+        counters.txBytes += bytesWritten;
     return bytesWritten;
 }
 
@@ -1121,6 +1592,12 @@ qint64 QSerialPortPrivate::readPerChar(char *data, qint64 maxSize)
         par ^= evenParity(*data & charMask); //par contains parity bit value for EVEN mode
         par ^= (currentTermios.c_cflag & PARODD); //par contains parity bit value for current mode
         if (par ^ (parity == QSerialPort::SpaceParity)) { //if parity error
+            if (parity != QSerialPort::NoParity)
+                ++counters.parityErrors;
+            else if (*data == '\0')
+                ++counters.breaks;
+            else
+                ++counters.frameErrors;
             switch (policy) {
             case QSerialPort::SkipPolicy:
                 continue;       //ignore received character
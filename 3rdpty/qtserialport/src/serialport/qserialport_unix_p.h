@@ -52,6 +52,7 @@
 
 #include <limits.h>
 #include <termios.h>
+#include <sys/ioctl.h>
 #ifndef Q_OS_ANDROID
 #ifdef Q_OS_LINUX
 #  include <linux/serial.h>
@@ -81,17 +82,38 @@ struct serial_struct {
 #define ASYNC_SPD_MASK  0x1030
 #endif
 
+#if defined(Q_OS_LINUX) && !defined(ASYNC_LOW_LATENCY)
+#define ASYNC_LOW_LATENCY 0x2000
+#endif
+
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID) && defined(TIOCGICOUNT)
+#define QSERIALPORT_HAS_ICOUNT
+#endif
+
 QT_BEGIN_NAMESPACE
 
 QString serialPortLockFilePath(const QString &portName);
 
+#ifdef Q_OS_LINUX
+// qserialport_linux.cpp, arbitrary rates through termios2 BOTHER
+bool qt_linux_set_baudrate(int descriptor, qint32 inputBaudRate, qint32 outputBaudRate);
+bool qt_linux_get_baudrate(int descriptor, qint32 *inputBaudRate, qint32 *outputBaudRate);
+#endif
+
 class QSocketNotifier;
+#ifdef Q_OS_LINUX
+class EpollReactor;
+#endif
 
 class QSerialPortPrivate : public QSerialPortPrivateData
 {
     Q_DECLARE_PUBLIC(QSerialPort)
 
 public:
+    enum {
+        MaxBaudRateErrorPercent = 2     // larger deviation of the real rate fails setBaudRate()
+    };
+
     QSerialPortPrivate(QSerialPort *q);
 
     bool open(QIODevice::OpenMode mode);
@@ -115,11 +137,14 @@ public:
 
     bool setBaudRate();
     bool setBaudRate(qint32 baudRate, QSerialPort::Directions directions);
+    qint32 actualBaudRate(QSerialPort::Directions directions);
+    bool lineCounters(QSerialPort::LineCounters *counters);
     bool setDataBits(QSerialPort::DataBits dataBits);
     bool setParity(QSerialPort::Parity parity);
     bool setStopBits(QSerialPort::StopBits stopBits);
     bool setFlowControl(QSerialPort::FlowControl flowControl);
     bool setDataErrorPolicy(QSerialPort::DataErrorPolicy policy);
+    bool setLowLatency(bool enable);
 
     bool readNotification();
     bool startAsyncWrite();
@@ -142,6 +167,17 @@ public:
 #endif
     int descriptor;
     bool isCustomBaudRateSupported;
+#ifdef Q_OS_LINUX
+    int latencyTimerRestore;    // ms to restore on close, -1 - not changed
+    bool isTermios2Supported;
+    bool isTermios2BaudRate;    // the rates below are set with BOTHER
+    qint32 termios2InputBaudRate;
+    qint32 termios2OutputBaudRate;
+#endif
+#ifdef QSERIALPORT_HAS_ICOUNT
+    struct serial_icounter_struct icountBase;   // driver counters at open
+    bool isICountSupported;
+#endif
 
     QSocketNotifier *readNotifier;
     QSocketNotifier *writeNotifier;
@@ -157,6 +193,14 @@ public:
     qint64 pendingBytesWritten;
     bool writeSequenceStarted;
 
+    bool readDrained;   // last readNotification() emptied the driver
+
+#ifdef Q_OS_LINUX
+    EpollReactor *reactor;
+    quint32 reactorEvents;
+    bool useReactor;
+#endif
+
     QScopedPointer<QLockFile> lockFileScopedPointer;
 
 private:
@@ -170,6 +214,9 @@ private:
     void setWriteNotificationEnabled(bool enable);
     bool isExceptionNotificationEnabled() const;
     void setExceptionNotificationEnabled(bool enable);
+#ifdef Q_OS_LINUX
+    bool setReactorEvent(quint32 event, bool enable);
+#endif
 
     bool waitForReadOrWrite(bool *selectForRead, bool *selectForWrite,
                             bool checkRead, bool checkWrite,
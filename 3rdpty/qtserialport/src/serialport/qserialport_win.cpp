@@ -581,6 +581,24 @@ long QSerialPortPrivate::getTimeout() const
     return (long) currentCommTimeouts.ReadIntervalTimeout;
 }
 
+bool QSerialPortPrivate::lineCounters(QSerialPort::LineCounters *counters)
+{
+    *counters = this->counters;
+    return true;
+}
+
+qint32 QSerialPortPrivate::actualBaudRate(QSerialPort::Directions directions)
+{
+    // the DCB holds the rate as requested
+    return (directions & QSerialPort::Output) ? outputBaudRate : inputBaudRate;
+}
+
+bool QSerialPortPrivate::setLowLatency(bool enable)
+{
+    // Not in the comm API, the FTDI latency timer is a property of the driver
+    return !enable;
+}
+
 #ifndef Q_OS_WINCE
 
 void QSerialPortPrivate::_q_completeAsyncCommunication()
@@ -639,6 +657,7 @@ void QSerialPortPrivate::_q_completeAsyncRead()
 
     if (numberOfBytesTransferred > 0) {
 
+        counters.rxBytes += numberOfBytesTransferred;
         readBuffer.append(readChunkBuffer.left(numberOfBytesTransferred));
 
         if (!emulateErrorPolicy())
@@ -663,6 +682,7 @@ void QSerialPortPrivate::_q_completeAsyncWrite()
     }
 
     if (numberOfBytesTransferred > 0) {
+        counters.txBytes += numberOfBytesTransferred;
         writeBuffer.free(numberOfBytesTransferred);
         emit q->bytesWritten(numberOfBytesTransferred);
     }
@@ -795,6 +815,18 @@ void QSerialPortPrivate::processIoErrors(bool error)
         return;
     }
 
+    // flags only, several errors of a kind between two calls count once
+    if (errors & CE_FRAME)
+        ++counters.frameErrors;
+    if (errors & CE_RXPARITY)
+        ++counters.parityErrors;
+    if (errors & CE_OVERRUN)
+        ++counters.overruns;
+    if (errors & CE_RXOVER)
+        ++counters.bufferOverruns;
+    if (errors & CE_BREAK)
+        ++counters.breaks;
+
     if (errors & CE_FRAME) {
         q->setError(QSerialPort::FramingError);
     } else if (errors & CE_RXPARITY) {
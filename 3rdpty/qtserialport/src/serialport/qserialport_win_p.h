@@ -92,6 +92,9 @@ public:
     bool setDataErrorPolicy(QSerialPort::DataErrorPolicy policy);
     bool setTimeout(long millisec);
     long getTimeout() const;
+    bool setLowLatency(bool enable);
+    qint32 actualBaudRate(QSerialPort::Directions directions);
+    bool lineCounters(QSerialPort::LineCounters *counters);
 
     void processIoErrors(bool error);
     QSerialPort::SerialPortError decodeSystemError() const;
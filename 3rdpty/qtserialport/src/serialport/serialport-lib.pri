@@ -79,6 +79,10 @@ unix:!symbian {
         $$PWD/qserialport_unix.cpp \
         $$PWD/qserialportinfo_unix.cpp
 
+    linux {
+        SOURCES += $$PWD/qserialport_linux.cpp
+    }
+
     macx {
         SOURCES += $$PWD/qserialportinfo_mac.cpp
 
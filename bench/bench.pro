@@ -0,0 +1,15 @@
+#-------------------------------------------------
+#
+# Benchmarks (standalone, not part of the application build)
+#
+#   cd bench && qmake && make
+#
+#-------------------------------------------------
+
+TEMPLATE = subdirs
+
+SUBDIRS += convbench
+
+unix {
+    SUBDIRS += ptybench
+}
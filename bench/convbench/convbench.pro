@@ -0,0 +1,38 @@
+#-------------------------------------------------
+#
+# Converters benchmark (standalone, not part of the application build)
+#
+#   qmake convbench.pro && make && ./convbench [-s max_size] [-t ms]
+#
+# Reports MB/s of input and allocations per call (glibc only) for every
+# display and edit mode converter and the TextToHtml/StrToCStrString
+# helpers, inputs from 16 B to 64 MB.
+#
+#-------------------------------------------------
+
+QT       += core
+QT       -= gui
+
+TARGET = convbench
+TEMPLATE = app
+CONFIG += console release
+CONFIG -= app_bundle
+
+ROOT = ../..
+
+SOURCES += \
+    main.cpp \
+    legacy_hexdump.cpp \
+    $$ROOT/src/strbinconv.cpp \
+    $$ROOT/src/HexDumpEngine.cpp \
+    $$ROOT/src/HexKernels.cpp \
+    $$ROOT/common/strutils.c
+
+HEADERS += \
+    legacy_hexdump.h \
+    $$ROOT/src/strbinconv.h \
+    $$ROOT/src/HexDumpEngine.h \
+    $$ROOT/src/HexKernels.h \
+    $$ROOT/common/strutils.h
+
+INCLUDEPATH += $$ROOT/src $$ROOT/common
@@ -0,0 +1,86 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Reference copy of the QString::arg() based hex dump
+ *           (QBin2HexStrConv::HexToStr before HexDumpEngine)
+ *
+ * @date     01-03-2013
+ * @author   Rafal Kukla
+ ******************************************************************************
+ *       Copyright (C) 2013 Rafal Kukla ( rkdevel AT gmail DOT com )
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#include <ctype.h>
+
+#include "legacy_hexdump.h"
+#include "strbinconv.h"
+
+QString legacyHexDump(unsigned long address, const unsigned char* buf, unsigned long size, bool html)
+{
+    static const char* sep     = "  ";
+    static const char* eol     = "\n";
+    static const unsigned recw = 16;
+
+    QString head;
+    QString tail;
+    QString addrfmt = "%1:";
+    QString hexfmt  = "%1";
+    QString asciifmt= "%1";
+    if (html)
+    {
+        head = "<pre>";
+        tail = "</pre>";
+        addrfmt  = QString("</b><font color=\"%1\">%2</font></b>").arg("blue").arg(addrfmt);
+        hexfmt   = QString("<font color=\"%1\">%2</font>").arg("black").arg(hexfmt);
+        asciifmt = QString("<font color=\"%1\"><code>%2</code></font>").arg("teal").arg(asciifmt);
+    }
+
+    char          hex[recw*3+1];
+    char          asc[recw+1];
+    unsigned long cnt,r;
+    unsigned      addrw;
+    int           hexw = recw*3-1;
+
+    addrw=0;
+    for (cnt=address+size;cnt;cnt/=16) addrw++;
+    for (cnt=2; addrw>cnt; cnt<<=1) ;
+    addrw = cnt;
+
+    QString out = head;
+    while (size)
+    {
+        r = (size > recw) ? recw : size;
+
+        out+=QString(addrfmt).arg(address,addrw,16,QChar('0'));
+
+        char *hptr = hex;
+        for (cnt=0;cnt<r;cnt++)
+        {
+            unsigned char c = buf[cnt], b = c >> 4; c&=0xF;
+            *hptr++=b+ ((b<10)?'0':'A'-10);
+            *hptr++=c+ ((c<10)?'0':'A'-10);
+            if (cnt+1<r) *hptr++=' ';
+        }
+        *hptr=0;
+        out+=sep;
+        out+=QString(hexfmt).arg(hex,-hexw);
+
+        for (cnt=0;cnt<r;cnt++) asc[cnt] = iscntrl(buf[cnt]) ? '.' : buf[cnt];
+        asc[r] = 0;
+        out+=sep;
+        if (html)
+            out+=QString(asciifmt).arg(TextToHtml(asc,r));
+        else
+            out+=QString(asciifmt).arg(asc,-(int)recw);
+        out+=eol;
+
+        buf     += r;
+        address += r;
+        size    -= r;
+    }
+    out+=tail;
+    return out;
+}
@@ -0,0 +1,28 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Reference copy of the QString::arg() based hex dump
+ *           (QBin2HexStrConv::HexToStr before HexDumpEngine)
+ *
+ * @date     01-03-2013
+ * @author   Rafal Kukla
+ ******************************************************************************
+ *       Copyright (C) 2013 Rafal Kukla ( rkdevel AT gmail DOT com )
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#ifndef LEGACY_HEXDUMP_H
+#define LEGACY_HEXDUMP_H
+
+#include <QString>
+
+/**
+ * Hex dump as implemented by QBin2HexStrConv::HexToStr before the table
+ * driven engine (byte words, hex address, ascii column). Kept only as the
+ * baseline for convbench.
+ */
+QString legacyHexDump(unsigned long address, const unsigned char* buf, unsigned long size, bool html);
+
+#endif // LEGACY_HEXDUMP_H
@@ -0,0 +1,382 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Converters benchmark
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include "strbinconv.h"
+#include "HexKernels.h"
+#include "legacy_hexdump.h"
+
+//------------------------------------------------------------------------------ allocation counter
+// Qt containers allocate with malloc()/realloc(), operator new ends up in malloc() too
+static qint64 alloc_count = 0;
+
+#ifdef __GLIBC__
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t nmemb, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+
+extern "C" void* malloc(size_t size)                 { alloc_count++; return __libc_malloc(size); }
+extern "C" void* calloc(size_t nmemb, size_t size)   { alloc_count++; return __libc_calloc(nmemb, size); }
+extern "C" void* realloc(void* ptr, size_t size)     { alloc_count++; return __libc_realloc(ptr, size); }
+#define ALLOC_COUNTING 1
+#else
+#define ALLOC_COUNTING 0
+#endif
+
+//------------------------------------------------------------------------------ inputs
+typedef enum {
+    INPUT_RANDOM,       /* random binary */
+    INPUT_TEXT,         /* printable ASCII lines, CR LF */
+    INPUT_MIXED,        /* text with every ~8th byte a control character or >= 0x80 */
+
+    __INPUT_CNT
+} input_kind_t;
+
+static const char* input_names[__INPUT_CNT] = { "random", "text", "mixed" };
+
+static QByteArray randomData(int size)
+{
+    QByteArray buf(size, Qt::Uninitialized);
+    srand(12345);
+    for (int cnt = 0; cnt < size; cnt++) buf[cnt] = static_cast<char>(rand());
+    return buf;
+}
+
+static QByteArray inputData(input_kind_t kind, int size)
+{
+    static const char text[] = "The quick brown fox jumps over the lazy dog. 0123456789 <&> \"quoted\"\r\n";
+    static const int  text_len = sizeof(text) - 1;
+
+    if (kind == INPUT_RANDOM) return randomData(size);
+
+    QByteArray buf(size, Qt::Uninitialized);
+    srand(54321);
+    for (int cnt = 0; cnt < size; cnt++)
+    {
+        buf[cnt] = text[cnt % text_len];
+        if (kind == INPUT_MIXED && (rand() & 7) == 0)
+        {
+            int r = rand();
+            buf[cnt] = static_cast<char>( (r & 1) ? (r >> 1) % 0x20 : 0x80 | (r >> 1) );
+        }
+    }
+    return buf;
+}
+
+/** Runs fn until at least min_ms elapsed, returns MB/s of input processed */
+template <typename Fn>
+static double measure(Fn fn, int input_size, int min_ms = 300)
+{
+    QElapsedTimer timer;
+    qint64        iterations = 0;
+    qint64        elapsed;
+
+    timer.start();
+    do {
+        fn();
+        iterations++;
+    } while ( (elapsed = timer.nsecsElapsed()) < min_ms * 1000000LL );
+
+    return (static_cast<double>(input_size) * iterations / (1024.0*1024.0)) / (elapsed / 1e9);
+}
+
+struct LegacyHex
+{
+    const QByteArray& buf; bool html; QString* out;
+    void operator()() { *out = legacyHexDump(0, reinterpret_cast<const unsigned char*>(buf.constData()), buf.size(), html); }
+};
+
+struct EngineHex
+{
+    QBinStrConv* conv; QByteArray& buf; QBinStrConv::STR_FORMAT fmt; QString* out;
+    void operator()() { *out = conv->convert(buf, fmt, QBinStrConv::OUTB_NOT_SPECIFIED); }
+};
+
+enum {
+    HEXDUMP_MIN_SPEEDUP = 10,               /* target of the engine for multi-megabyte captures */
+    HEXDUMP_CHECKED_SIZE = 1024*1024        /* smaller inputs are reported, not checked */
+};
+
+/** Returns false if the engine misses the speedup target or its output differs */
+static bool benchHexDump()
+{
+    static const int sizes[] = { 4*1024, 1024*1024, 8*1024*1024 };
+    QBinStrConv*     hex     = QBinStrConvCollection::getConv(QBinStrConvCollection::CONV_HEX);
+    bool             passed  = true;
+
+    printf("\n=== Hex dump: legacy QString::arg() vs table driven engine, target %dx from %d bytes\n",
+           HEXDUMP_MIN_SPEEDUP, HEXDUMP_CHECKED_SIZE);
+    printf("%-8s %10s %14s %14s %9s\n", "format", "size", "legacy MB/s", "engine MB/s", "speedup");
+
+    for (unsigned s = 0; s < sizeof(sizes)/sizeof(sizes[0]); s++)
+    {
+        QByteArray buf = randomData(sizes[s]);
+
+        for (int html = 0; html < 2; html++)
+        {
+            QString  legacy_out, engine_out;
+            QBinStrConv::STR_FORMAT fmt = html ? QBinStrConv::HTML : QBinStrConv::PLAIN_TEXT;
+
+            LegacyHex lf = { buf, html != 0, &legacy_out };
+            EngineHex ef = { hex, buf, fmt, &engine_out };
+
+            double legacy   = measure(lf, buf.size());
+            double engine   = measure(ef, buf.size());
+            bool   mismatch = !html && legacy_out != engine_out;
+            bool   slow     = buf.size() >= HEXDUMP_CHECKED_SIZE && engine < legacy * HEXDUMP_MIN_SPEEDUP;
+
+            printf("%-8s %10d %14.1f %14.1f %8.1fx%s%s\n",
+                   html ? "HTML" : "PLAIN", buf.size(), legacy, engine, engine/legacy,
+                   mismatch ? "  OUTPUT MISMATCH" : "", slow ? "  BELOW TARGET" : "");
+            if (mismatch || slow) passed = false;
+        }
+    }
+    return passed;
+}
+
+struct KernelEncode
+{
+    const QByteArray& buf; QString* out;
+    void operator()()
+    {
+        HexKernels::encodeSpaced(reinterpret_cast<const uint8_t*>(buf.constData()), buf.size(),
+                                 reinterpret_cast<uint16_t*>(out->data()));
+    }
+};
+
+struct HexDecode
+{
+    QStrBinConv* conv; QString& text; QByteArray* out;
+    void operator()() { out->clear(); conv->convert(text, out, NULL); }
+};
+
+static void benchHexKernels()
+{
+    static const int sizes[] = { 4*1024, 1024*1024 };
+    QStrBinConv*     hex     = QStrBinConvCollection::getConv(QStrBinConvCollection::CONV_HEX);
+    const HexKernels::isa_t best = HexKernels::activeIsa();
+
+    printf("\n=== Hex kernels: encode \"XX XX ..\" / decode (HEX input converter)\n");
+    printf("%-8s %10s %14s %14s %s\n", "isa", "size", "encode MB/s", "decode MB/s", "");
+
+    for (int isa = HexKernels::ISA_SCALAR; isa <= best; isa++)
+    {
+        HexKernels::selectIsa(static_cast<HexKernels::isa_t>(isa));
+
+        for (unsigned s = 0; s < sizeof(sizes)/sizeof(sizes[0]); s++)
+        {
+            QByteArray buf = randomData(sizes[s]);
+            QString    text(3*buf.size()-1, Qt::Uninitialized);
+            QByteArray decoded;
+
+            KernelEncode ef = { buf, &text };
+            HexDecode    df = { hex, text, &decoded };
+
+            double enc = measure(ef, buf.size());
+            double dec = measure(df, buf.size());
+
+            printf("%-8s %10d %14.1f %14.1f%s\n",
+                   HexKernels::isaName(static_cast<HexKernels::isa_t>(isa)), buf.size(), enc, dec,
+                   (decoded != buf) ? "  OUTPUT MISMATCH" : "");
+        }
+    }
+    HexKernels::selectIsa(best);
+}
+
+//------------------------------------------------------------------------------ all converters
+
+enum {
+    MAX_OUTPUT_CHARS = 256*1024*1024    /* larger estimated outputs are skipped (QString size limit, memory) */
+};
+
+static int min_time = 300;              /* ms per measurement */
+
+struct BinStr
+{
+    QBinStrConv* conv; QByteArray& buf; QBinStrConv::STR_FORMAT fmt; QString* out;
+    void operator()() { *out = conv->convert(buf, fmt, QBinStrConv::OUTB_NOT_SPECIFIED); }
+};
+
+struct StrBin
+{
+    QStrBinConv* conv; QString& text; QByteArray* out;
+    void operator()() { out->clear(); conv->convert(text, out, NULL); }
+};
+
+struct HtmlHelper
+{
+    const QByteArray& buf; QString* out;
+    void operator()() { *out = TextToHtml(buf.constData(), buf.size()); }
+};
+
+struct CStrHelper
+{
+    const QByteArray& buf; QString* out;
+    void operator()() { *out = StrToCStrString(buf.constData(), buf.size()); }
+};
+
+/** Allocations made by one call */
+template <typename Fn>
+static qint64 allocations(Fn fn)
+{
+    qint64 before = alloc_count;
+    fn();
+    return alloc_count - before;
+}
+
+template <typename Fn>
+static void report(const char* name, const char* fmt, input_kind_t input, int size, Fn fn)
+{
+    qint64 allocs = allocations(fn);    // also warms up
+    double rate   = measure(fn, size, min_time);
+
+    printf("%-12s %-6s %-7s %10d %12.1f", name, fmt, input_names[input], size, rate);
+    if (ALLOC_COUNTING) printf(" %10lld\n", static_cast<long long>(allocs));
+    else                printf(" %10s\n", "n/a");
+    fflush(stdout);
+}
+
+static void benchConverters(const QVector<int>& sizes)
+{
+    printf("\n=== Converters: input MB/s and allocations per call\n");
+    printf("%-12s %-6s %-7s %10s %12s %10s\n", "converter", "format", "input", "size", "MB/s", "allocs");
+
+    for (int c = 0; c < QBinStrConvCollection::__CONV_CNT; c++)
+    {
+        QBinStrConv* conv = QBinStrConvCollection::getConv(c);
+
+        for (int html = 0; html < 2; html++)
+        {
+            QBinStrConv::STR_FORMAT fmt = html ? QBinStrConv::HTML : QBinStrConv::PLAIN_TEXT;
+
+            for (int input = 0; input < __INPUT_CNT; input++)
+            {
+                double expansion = 0;   /* output chars per input byte, from the 64 kB run */
+
+                for (int s = 0; s < sizes.size(); s++)
+                {
+                    if (expansion > 0 && expansion * sizes[s] > MAX_OUTPUT_CHARS)
+                    {
+                        printf("%-12s %-6s %-7s %10d %12s\n", conv->getName(), html ? "HTML" : "PLAIN", input_names[input], sizes[s], "skipped");
+                        continue;
+                    }
+
+                    QByteArray buf = inputData(static_cast<input_kind_t>(input), sizes[s]);
+                    QString    out;
+                    BinStr     fn  = { conv, buf, fmt, &out };
+
+                    report(conv->getName(), html ? "HTML" : "PLAIN", static_cast<input_kind_t>(input), buf.size(), fn);
+                    if (sizes[s] >= 64*1024 && expansion == 0) expansion = static_cast<double>(out.size()) / buf.size();
+                }
+            }
+        }
+    }
+
+    // Input (edit mode) converters parse what a user would type for the same data
+    for (int c = 0; c < QStrBinConvCollection::__CONV_CNT; c++)
+    {
+        QStrBinConv* conv = QStrBinConvCollection::getConv(c);
+
+        for (int input = 0; input < __INPUT_CNT; input++)
+        {
+            for (int s = 0; s < sizes.size(); s++)
+            {
+                QByteArray buf = inputData(static_cast<input_kind_t>(input), sizes[s]);
+                QString    text;
+                QByteArray out;
+
+                if (sizes[s] > MAX_OUTPUT_CHARS / 4) continue;
+                switch (c)
+                {
+                case QStrBinConvCollection::CONV_HEX:
+                    text = QString(3*buf.size()-1, Qt::Uninitialized);
+                    HexKernels::encodeSpaced(reinterpret_cast<const uint8_t*>(buf.constData()), buf.size(),
+                                             reinterpret_cast<uint16_t*>(text.data()));
+                    break;
+                case QStrBinConvCollection::CONV_CSTR:
+                    text = StrToCStrString(buf.constData(), buf.size());
+                    break;
+                default:
+                    text = QString::fromLatin1(buf);
+                    break;
+                }
+
+                StrBin fn = { conv, text, &out };
+                report(conv->getName(), "PLAIN", static_cast<input_kind_t>(input), buf.size(), fn);
+            }
+        }
+    }
+
+    // Helpers used by the converters
+    for (int input = 0; input < __INPUT_CNT; input++)
+    {
+        for (int s = 0; s < sizes.size(); s++)
+        {
+            QByteArray buf = inputData(static_cast<input_kind_t>(input), sizes[s]);
+            QString    out;
+            HtmlHelper hf  = { buf, &out };
+            CStrHelper cf  = { buf, &out };
+
+            if (sizes[s] > MAX_OUTPUT_CHARS / 8) continue;
+            report("TextToHtml",      "HTML",  static_cast<input_kind_t>(input), buf.size(), hf);
+            report("StrToCStrString", "PLAIN", static_cast<input_kind_t>(input), buf.size(), cf);
+        }
+    }
+}
+
+static int parseSize(const char* str)
+{
+    char*  end;
+    double val = strtod(str, &end);
+
+    if (*end == 'k' || *end == 'K') val *= 1024;
+    if (*end == 'm' || *end == 'M') val *= 1024*1024;
+    return static_cast<int>(val);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    int              max_size = 64*1024*1024;
+    QVector<int>     sizes;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if      (!strcmp(argv[i], "-s") && i+1 < argc) max_size = parseSize(argv[++i]);
+        else if (!strcmp(argv[i], "-t") && i+1 < argc) min_time = qMax(atoi(argv[++i]), 1);
+        else
+        {
+            fprintf(stderr, "usage: %s [-s max_input_size[k|M], default 64M] [-t ms_per_measurement, default 300]\n"
+                            "exit code 1 if the hex dump engine misses its speedup target\n", argv[0]);
+            return 2;
+        }
+    }
+    for (int size = 16; size <= max_size; size *= 16) sizes.append(size);
+    if (sizes.isEmpty() || sizes.last() != max_size) sizes.append(max_size);
+
+    bool hexdump_ok = benchHexDump();
+    benchHexKernels();
+    benchConverters(sizes);
+
+    return hexdump_ok ? 0 : 1;
+}
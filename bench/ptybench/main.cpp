@@ -0,0 +1,240 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Receive pipeline benchmark on a pseudo-terminal
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QImage>
+#include <QTemporaryFile>
+#include <QTimer>
+
+#include "PtyLoopbackDevice.h"
+#include "SerialPortEngine.h"
+#include "RxAccumulator.h"
+#include "OutputView.h"
+#include "CaptureLog.h"
+#include "strbinconv.h"
+
+#include "debug.h"
+
+// ******************************************************************************** C L A S S:  BenchPipeline
+/**
+ * Same path as MainWindow: engine -> accumulator -> output view (+ capture),
+ * the view is rendered off screen at display frame rate.
+ */
+class BenchPipeline : public QObject
+{
+    Q_OBJECT
+public:
+    enum {
+        FRAME_INTERVAL = 40     /* ms, repaint rate of the output view */
+    };
+
+    BenchPipeline(QBinStrConv* conv, CaptureLogWriter* capture)
+        : port(new SerialPortEngine(this))
+        , rx(new RxAccumulator(this))
+        , capture(capture)
+        , image(1000, 700, QImage::Format_RGB32)
+        , received(0)
+        , seq_errors(0)
+        , expected(-1)
+        , frames(0)
+    {
+        if (conv)
+        {
+            view.setDisplayConv(conv);
+            view.resize(image.size());
+            view.setAttribute(Qt::WA_DontShowOnScreen);
+            view.show();
+            ASSERT_ALWAYS( connect(&render_timer, SIGNAL(timeout()), SLOT(render()) ) );
+        }
+        has_view = (conv != NULL);
+
+        ASSERT_ALWAYS( connect(port, SIGNAL(readyRead()), SLOT(onReadyRead()) ) );
+        ASSERT_ALWAYS( connect(rx,   SIGNAL(frameReady(QByteArray,int,qint64,qint64)), SLOT(onRxFrameReady(QByteArray,int,qint64,qint64)) ) );
+    }
+
+    SerialPortEngine* port;
+    RxAccumulator*    rx;
+    CaptureLogWriter* capture;
+    OutputView        view;
+    bool              has_view;
+    QTimer            render_timer;
+    QImage            image;
+    qint64            received;
+    qint64            seq_errors;   /* counter pattern discontinuities */
+    int               expected;
+    qint64            frames;       /* rendered */
+
+    void start()         { if (has_view) render_timer.start(FRAME_INTERVAL); }
+    void stop()          { render_timer.stop(); port->close(); onReadyRead(); rx->flush(); }
+
+public slots:
+    void onReadyRead()
+    {
+        const char* ptr;
+        int         len;
+        qint64      time;
+
+        while ( (len = port->peekChunk(&ptr, &time)) > 0 )
+        {
+            rx->append(ptr, len, time);
+            port->consume(len);
+        }
+    }
+
+    void onRxFrameReady(const QByteArray& data, int chunks, qint64 time_ns, qint64 gap_ns)
+    {
+        (void) chunks;
+        (void) gap_ns;
+
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(data.constData());
+        for (int cnt = 0; cnt < data.size(); cnt++)
+        {
+            if (expected >= 0 && p[cnt] != expected) seq_errors++;
+            expected = (p[cnt] + 1) & 0xFF;
+        }
+        received += data.size();
+
+        if (has_view) view.appendData(OutputRecordStore::REC_RX, data);
+        if (capture)  capture->write(OutputRecordStore::REC_RX, data.constData(), data.size(), capture->timestampAt(time_ns));
+    }
+
+    void render()
+    {
+        view.render(&image);
+        frames++;
+    }
+};
+
+static qint64 processCpuTime()
+{
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return (static_cast<qint64>(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000LL
+            + ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) * 1000LL;
+}
+
+static void wait(int ms)
+{
+    QEventLoop loop;
+    QTimer::singleShot(ms, &loop, SLOT(quit()));
+    loop.exec();
+}
+
+static void runMode(const char* name, QBinStrConv* conv, qint64 rate, int seconds, bool log)
+{
+    PtyLoopbackDevice device;
+    QTemporaryFile    log_file;
+    CaptureLogWriter  capture;
+
+    if (!device.open())
+    {
+        fprintf(stderr, "%s\n", device.errorString().toLocal8Bit().constData());
+        exit(1);
+    }
+    if (log)
+    {
+        log_file.open();
+        capture.open(log_file.fileName());
+    }
+
+    BenchPipeline pipe(conv, log ? &capture : NULL);
+    SerialSetupDialog::PortSettings settings = { 115200, QSerialPort::Data8, QSerialPort::NoParity, QSerialPort::OneStop, QSerialPort::NoFlowControl, 250, 0, 0 };
+
+    pipe.port->setPortName(device.slaveName());
+    if (!pipe.port->open(QIODevice::ReadWrite))
+    {
+        fprintf(stderr, "Cannot open %s: %s\n", device.slaveName().toLocal8Bit().constData(), pipe.port->errorString().toLocal8Bit().constData());
+        exit(1);
+    }
+    pipe.port->setSettings(settings);
+
+    QElapsedTimer wall;
+    qint64        cpu0 = processCpuTime();
+
+    wall.start();
+    pipe.start();
+    device.startGenerator(rate);
+    wait(seconds * 1000);
+    device.stopGenerator();
+
+    qint64 elapsed   = wall.nsecsElapsed();
+    qint64 received  = pipe.received;
+    qint64 cpu       = processCpuTime() - cpu0 - device.generatorCpuTime();
+
+    wait(200);          // whatever is still in flight
+    pipe.stop();
+    if (log) capture.close();
+
+    qint64 generated = device.generatedBytes();
+    qint64 dropped   = pipe.port->droppedBytes();
+
+    printf("%-10s %12.2f %8.1f %12lld %12lld %10lld %8.1f\n",
+           name,
+           received / (elapsed / 1e9) / (1024.0*1024.0),
+           100.0 * cpu / elapsed,
+           static_cast<long long>(dropped),
+           static_cast<long long>(generated - pipe.received - dropped),
+           static_cast<long long>(pipe.seq_errors),
+           pipe.frames / (elapsed / 1e9));
+}
+
+static qint64 parseRate(const char* str)
+{
+    char*  end;
+    double val = strtod(str, &end);
+
+    if (*end == 'k' || *end == 'K') val *= 1024;
+    if (*end == 'm' || *end == 'M') val *= 1024*1024;
+    return static_cast<qint64>(val);
+}
+
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+    qint64       rate    = 0;
+    int          seconds = 5;
+    bool         log     = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if      (!strcmp(argv[i], "-r") && i+1 < argc) rate    = parseRate(argv[++i]);
+        else if (!strcmp(argv[i], "-t") && i+1 < argc) seconds = qMax(atoi(argv[++i]), 1);
+        else if (!strcmp(argv[i], "-l"))               log     = true;
+        else
+        {
+            fprintf(stderr, "usage: %s [-r bytes_per_sec[k|M], 0 - max] [-t seconds] [-l (capture log)]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    printf("=== PTY receive pipeline, rate %s, %d s per mode%s\n",
+           rate ? QString("%1 B/s").arg(rate).toLocal8Bit().constData() : "max", seconds, log ? ", capture log on" : "");
+    printf("%-10s %12s %8s %12s %12s %10s %8s\n", "display", "MB/s", "CPU %", "dropped", "missing", "seq.err", "fps");
+
+    runMode("none", NULL, rate, seconds, log);
+    runMode("HEX",    QBinStrConvCollection::getConv(QBinStrConvCollection::CONV_HEX),   rate, seconds, log);
+    runMode("ASCII",  QBinStrConvCollection::getConv(QBinStrConvCollection::CONV_ASCII), rate, seconds, log);
+    runMode("C-String", QBinStrConvCollection::getConv(QBinStrConvCollection::CONV_CSTR), rate, seconds, log);
+
+    return 0;
+}
+
+#include "main.moc"
@@ -0,0 +1,54 @@
+#-------------------------------------------------
+#
+# Receive pipeline benchmark on a pseudo-terminal (standalone, Linux only)
+#
+#   qmake ptybench.pro && make && ./ptybench [-r rate] [-t seconds] [-l]
+#   QT_QPA_PLATFORM=offscreen ./ptybench    (no display needed)
+#
+#-------------------------------------------------
+
+QT       += core gui widgets
+
+TARGET = ptybench
+TEMPLATE = app
+CONFIG += console release
+CONFIG -= app_bundle
+
+ROOT = ../..
+
+SOURCES += \
+    main.cpp \
+    $$ROOT/src/PtyLoopbackDevice.cpp \
+    $$ROOT/src/SerialDeviceInterface.cpp \
+    $$ROOT/src/SerialPortEngine.cpp \
+    $$ROOT/src/RxAccumulator.cpp \
+    $$ROOT/src/OutputRecordStore.cpp \
+    $$ROOT/src/OutputView.cpp \
+    $$ROOT/src/RecordExporter.cpp \
+    $$ROOT/src/CaptureLog.cpp \
+    $$ROOT/src/HiResClock.cpp \
+    $$ROOT/src/strbinconv.cpp \
+    $$ROOT/src/HexDumpEngine.cpp \
+    $$ROOT/src/HexKernels.cpp \
+    $$ROOT/common/strutils.c
+
+HEADERS += \
+    $$ROOT/src/PtyLoopbackDevice.h \
+    $$ROOT/src/SerialDeviceInterface.h \
+    $$ROOT/src/SerialPortEngine.h \
+    $$ROOT/src/SpscRingBuffer.h \
+    $$ROOT/src/RxAccumulator.h \
+    $$ROOT/src/OutputRecordStore.h \
+    $$ROOT/src/OutputView.h \
+    $$ROOT/src/RecordExporter.h \
+    $$ROOT/src/CaptureLog.h \
+    $$ROOT/src/HiResClock.h \
+    $$ROOT/src/strbinconv.h \
+    $$ROOT/src/HexDumpEngine.h \
+    $$ROOT/src/HexKernels.h \
+    $$ROOT/common/strutils.h
+
+INCLUDEPATH += $$ROOT/src $$ROOT/common $$ROOT/3rdpty/qtserialport/include/QtSerialPort $$ROOT/3rdpty/qtserialport/src/serialport $$ROOT/3rdpty/qtserialport/src/serialport/qt4support/include
+
+include($$ROOT/3rdpty/qtserialport/include/QtSerialPort/headers.pri)
+include($$ROOT/3rdpty/qtserialport/src/serialport/serialport-lib.pri)
@@ -386,12 +386,19 @@ int str_is_in_case(char* str,size_t strsize,...)
  */
 size_t CStrToStr(const char* str, size_t strsize, char* outstr, size_t outstrsize)
 {
+  return CStrToStrEx(str, strsize, outstr, outstrsize, NULL);
+}
+
+size_t CStrToStrEx(const char* str, size_t strsize, char* outstr, size_t outstrsize, size_t* pinsize)
+{
+  const char  *strbeg=str;
   const char  *strend;
   char        *outend;
   char        *bufpos=NULL;
   char        c;
   char        sign=0;
 
+  if (pinsize) *pinsize=0;
   if (!str || !strsize || !outstr || !outstrsize) return 0;
 
   strend=str+strsize;
@@ -481,6 +488,7 @@ size_t CStrToStr(const char* str, size_t strsize, char* outstr, size_t outstrsiz
   if (bufpos<outend)
     *bufpos=0;
 
+  if (pinsize) *pinsize=(size_t) (str-strbeg);
   return (size_t) (bufpos-outstr);
 }
 
@@ -219,6 +219,15 @@ int str_is_in_case(char* str,size_t strsize,...);
  */
 size_t CStrToStr(const char* str, size_t strsize, char* outstr, size_t outstrsize);
 
+/**
+ * Same as CStrToStr(), additionally stores in <pinsize> the number of source
+ * characters consumed. It is less than <strsize> when the conversion stopped
+ * early, on a null character or when the destination buffer got full.
+ *
+ * @param pinsize    Consumed source size, may be NULL
+ */
+size_t CStrToStrEx(const char* str, size_t strsize, char* outstr, size_t outstrsize, size_t* pinsize);
+
 /**
  * Function splits <str> into parameters following bash shell splitting rules.
  * Funtion respect ' ' and " " characters. Within " " following formating will be used
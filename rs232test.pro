@@ -13,11 +13,25 @@ SOURCES += \
     src/main.cpp\
     src/MainWindow.cpp \
     src/strbinconv.cpp \
+    src/HexDumpEngine.cpp \
+    src/HexKernels.cpp \
     src/SerialDeviceInterface.cpp \
     src/serialsetupdialog.cpp \
     src/InputHistoryList.cpp \
     src/BinaryEditor.cpp \
     src/MacrosEditDialog.cpp \
+    src/RxAccumulator.cpp \
+    src/SerialPortEngine.cpp \
+    src/OutputRecordStore.cpp \
+    src/OutputView.cpp \
+    src/RecordExporter.cpp \
+    src/CaptureLog.cpp \
+    src/HiResClock.cpp \
+    src/FileSender.cpp \
+    src/HeadlessSession.cpp \
+    src/SessionManager.cpp \
+    src/MonitorWindow.cpp \
+    src/CaptureReplayDevice.cpp \
     3rdpty/qhexedit2/src/xbytearray.cpp \
     3rdpty/qhexedit2/src/qhexedit_p.cpp \
     3rdpty/qhexedit2/src/qhexedit.cpp \
@@ -30,6 +44,8 @@ SOURCES += \
 HEADERS  += \
     src/MainWindow.h \
     src/strbinconv.h \
+    src/HexDumpEngine.h \
+    src/HexKernels.h \
     src/SerialDeviceInterface.h \
     src/appconfig.h \
     src/serialsetupdialog.h \
@@ -38,6 +54,19 @@ HEADERS  += \
     src/debug.h \
     src/cpputils.h \
     src/MacrosEditDialog.h \
+    src/RxAccumulator.h \
+    src/SerialPortEngine.h \
+    src/SpscRingBuffer.h \
+    src/OutputRecordStore.h \
+    src/OutputView.h \
+    src/RecordExporter.h \
+    src/CaptureLog.h \
+    src/HiResClock.h \
+    src/FileSender.h \
+    src/HeadlessSession.h \
+    src/SessionManager.h \
+    src/MonitorWindow.h \
+    src/CaptureReplayDevice.h \
     3rdpty/qhexedit2/src/xbytearray.h \
     3rdpty/qhexedit2/src/qhexedit_p.h \
     3rdpty/qhexedit2/src/qhexedit.h \
@@ -51,7 +80,8 @@ FORMS    += \
     ui/MainWindow.ui \
     ui/serialsetupdialog.ui \
     ui/BinaryEditor.ui \
-    ui/MacrosEditDialog.ui
+    ui/MacrosEditDialog.ui \
+    ui/MonitorWindow.ui
 
 RESOURCES += \
     res/icons_16.qrc \
@@ -15,17 +15,49 @@
 #include "BinaryEditor.h"
 #include "ui_BinaryEditor.h"
 
+#include <climits>
+#include <QTextBlock>
+#include <QFile>
+
 #include "strbinconv.h"
 
 #include "debug.h"
 
 
+// ******************************************************************************** C L A S S: InputDataView
+
+InputDataView::InputDataView(const QByteArray &bytes, quint32 version)
+    : d(new Data)
+{
+    d->bytes   = bytes;
+    d->version = version;
+    d->fcs     = -1;
+}
+
+quint8 InputDataView::fcs() const
+{
+    if (!d) return calcFCS( QByteArray() );
+
+    // shared by all views of the version
+    if (d->fcs < 0) d->fcs = calcFCS(d->bytes);
+    return static_cast<quint8>(d->fcs);
+}
+
+// ******************************************************************************** C L A S S: InputEditorAbstract
+
+quint8 InputEditorAbstract::getDataFCS()
+{
+    return calcFCS( getInputData() );
+}
+
 // ******************************************************************************** C L A S S: BinaryEditor
 
 BinaryEditor::BinaryEditor(QWidget *parent) :
     QStackedWidget(parent),
     current_editor(NULL),
-    _data_cache_valid(false),
+    _version(1),
+    _view_valid(false),
+    mapped_file(NULL),
     ui(new Ui::BinaryEditor)
 {
     ui->setupUi(this);
@@ -49,6 +81,7 @@ BinaryEditor::BinaryEditor(QWidget *parent) :
 BinaryEditor::~BinaryEditor()
 {
     delete ui;
+    delete mapped_file;
 }
 
 void BinaryEditor::changeEvent(QEvent *e)
@@ -71,6 +104,80 @@ void BinaryEditor::connectInputEditor(InputEditorAbstract *editor)
     ASSERT_ALWAYS( connect(editor, SIGNAL( inputChanged() ),             SLOT( onEditorDataChanged() )              ) );
 }
 
+void BinaryEditor::updateView(const QByteArray &data)
+{
+    // Data of a mapped file must not leave the editor, it is gone when the file is released
+    _view = InputDataView( (mapped_file) ? QByteArray(data.constData(), data.size()) : data, _version );
+    _view_valid = true;
+}
+
+void BinaryEditor::releaseFile()
+{
+    if (mapped_file)
+    {
+        if (current_editor != hex_editor)
+        {
+            QByteArray empty;
+            hex_editor->setInputData(empty);
+        }
+        delete mapped_file;
+        mapped_file = NULL;
+    }
+}
+
+/**
+ * Loads file into the editor. In hex mode the file is mapped read-only and
+ * the editor reads only the pages it displays, edits are kept apart from
+ * the file. In text mode the whole file is read and converted.
+ */
+bool BinaryEditor::openFile(const QString &file_name, QString *error)
+{
+    QFile* file = new QFile(file_name);
+
+    if (! file->open(QIODevice::ReadOnly) )
+    {
+        if (error) *error = QString("Cannot open for reading file: %1").arg(file_name);
+        delete file;
+        return false;
+    }
+
+    if ( current_editor != hex_editor )
+    {
+        QByteArray data = file->readAll();
+        delete file;
+        setInputData( data );
+        return true;
+    }
+
+    qint64 size = file->size();
+    uchar* ptr  = NULL;
+    if ( size > INT_MAX )
+    {
+        if (error) *error = QString("File too large: %1").arg(file_name);
+        delete file;
+        return false;
+    }
+    if ( size > 0 && !(ptr = file->map(0, size)) )
+    {
+        if (error) *error = QString("Cannot map file: %1 (%2)").arg(file_name).arg(file->errorString());
+        delete file;
+        return false;
+    }
+
+    QByteArray data = QByteArray::fromRawData( reinterpret_cast<const char*>(ptr), static_cast<int>(size) );
+    hex_editor->setInputData(data);
+
+    // Previous mapping is no longer displayed
+    delete mapped_file;
+    mapped_file = file;
+
+    _view = InputDataView();
+    invalidateView();
+
+    refreshInput();
+    return true;
+}
+
 void BinaryEditor::clear()
 {
     QByteArray empty;
@@ -106,21 +213,29 @@ void BinaryEditor::setEditMode(BinaryEditor::input_modes_t mode, bool forceRefre
 
     if ( (current_editor!=new_editor) || forceRefresh )
     {
-        if (current_editor) updateDataCache(current_editor->getInputData());
+        if (current_editor) updateView(current_editor->getInputData());
         current_editor=new_editor;
 
-        if (_data_cache.size()>0)
-            current_editor->setInputData(_data_cache);
+        QByteArray data = _view.bytes();
+        if (data.size()>0)
+            current_editor->setInputData(data);
         else
-            _data_cache_valid = false;
+            invalidateView();
+
+        releaseFile();
     }
 }
 
+quint8 BinaryEditor::getInputFCS()
+{
+    return (_view_valid) ? _view.fcs() : current_editor->getDataFCS();
+}
+
 void BinaryEditor::setTextModeCoverters(QStrBinConv *inputConverter, QBinStrConv *displayConverter)
 {
     if ( current_editor==txt_editor )
     {
-        updateDataCache( current_editor->getInputData() );
+        updateView( current_editor->getInputData() );
     }
 
     txt_editor->setInputConv( inputConverter );
@@ -128,8 +243,9 @@ void BinaryEditor::setTextModeCoverters(QStrBinConv *inputConverter, QBinStrConv
 
     if ( current_editor==txt_editor )
     {
-        current_editor->setInputData(_data_cache);
-        _data_cache_valid = false;
+        QByteArray data = _view.bytes();
+        current_editor->setInputData(data);
+        invalidateView();
     }
 }
 
@@ -141,13 +257,13 @@ void BinaryEditor::onEditorCurrentAddressChanged(int address)
 
 void BinaryEditor::onEditorCurrentSizeChanged(int size)
 {
-    _data_cache_valid = false;
+    invalidateView();
     emit inputSizeChanged(size);
 }
 
 void BinaryEditor::onEditorDataChanged()
 {
-    _data_cache_valid = false;
+    invalidateView();
     emit inputChanged();
 }
 
@@ -161,10 +277,18 @@ void BinaryEditor::onEditorOverwriteModeChanged(bool state)
 InputTextEditor::InputTextEditor(QPlainTextEdit *widget)
     : editor(widget)
     , inputConv(NULL)
+    , displayConv(NULL)
     , last_doc_size(0)
+    , pieces_valid(false)
+    , pieces_size(0)
+    , pieces_sum(0)
+    , pieces_stops(0)
+    , pieces_might(0)
 {
 
     //QMetaObject::connectSlotsByName(this);
+    // contentsChange comes before textChanged, pieces are up to date when inputChanged is emitted
+    ASSERT_ALWAYS( connect(editor->document(), SIGNAL(contentsChange(int,int,int)), SLOT(on_document_contentsChange(int,int,int)) ) );
     ASSERT_ALWAYS( connect(editor, SIGNAL(textChanged()),           SLOT(on_editor_textChanged()) ) );
     ASSERT_ALWAYS( connect(editor, SIGNAL(cursorPositionChanged()), SLOT(on_editor_cursorPositionChanged()) ) );
 
@@ -182,6 +306,7 @@ void InputTextEditor::setInputConv(QStrBinConv*  newConv)
     inputConv = NULL;
     if (conv) QStrBinConvCollection::disposeConv(conv);
     inputConv = newConv;
+    pieces_valid = false;
 }
 
 void InputTextEditor::setDisplayConv(QBinStrConv *newConv)
@@ -193,39 +318,158 @@ void InputTextEditor::setDisplayConv(QBinStrConv *newConv)
 }
 
 
+void InputTextEditor::convertText(QString &str, Piece *piece)
+{
+    int fail_pos = -1;
+
+    piece->data.clear();
+    piece->validity = inputConv->convert(str, &piece->data, &fail_pos);
+    piece->stops    = (piece->validity == QStrBinConv::INVALID) || (fail_pos >= 0 && fail_pos < str.size());
+
+    const uchar* ptr = reinterpret_cast<const uchar*>( piece->data.constData() );
+    int          cnt = piece->data.size();
+    uint         sum = 0;
+    while (cnt--) sum += *ptr++;
+    piece->sum = sum;
+}
+
+void InputTextEditor::convertBlock(const QTextBlock &block, Piece *piece)
+{
+    QString str = block.text();
+
+    // The same characters QTextDocument::toPlainText() replaces
+    str.replace(QChar::Nbsp, QLatin1Char(' '));
+    str.replace(QChar::LineSeparator, QLatin1Char('\n'));
+    if (block.next().isValid()) str += QLatin1Char('\n');
+
+    convertText(str, piece);
+}
+
+void InputTextEditor::countPiece(const Piece &piece, int sign)
+{
+    pieces_size  += sign * piece.data.size();
+    pieces_sum   += sign * piece.sum;
+    pieces_stops += sign * (piece.stops ? 1 : 0);
+    pieces_might += sign * (piece.validity == QStrBinConv::MIGHT_VALID ? 1 : 0);
+}
+
+void InputTextEditor::updatePieces()
+{
+    if (pieces_valid) return;
+
+    pieces.clear();
+    pieces_size  = 0;
+    pieces_sum   = 0;
+    pieces_stops = 0;
+    pieces_might = 0;
+
+    QTextDocument* doc = editor->document();
+    if (inputConv->isLineSeparable())
+    {
+        pieces.resize( doc->blockCount() );
+        QTextBlock block = doc->begin();
+        for (int i = 0; i < pieces.size() && block.isValid(); ++i, block = block.next())
+        {
+            convertBlock(block, &pieces[i]);
+            countPiece(pieces[i], 1);
+        }
+    }
+    else
+    {
+        QString str = doc->toPlainText();
+        pieces.resize(1);
+        convertText(str, &pieces[0]);
+        countPiece(pieces[0], 1);
+    }
+    pieces_valid = true;
+}
+
+int InputTextEditor::piecesEnd()
+{
+    if (!pieces_stops) return pieces.size();
+
+    int i = 0;
+    while (!pieces[i].stops) ++i;
+    return i + 1;
+}
+
+void InputTextEditor::beepIfInvalid()
+{
+    bool invalid = (pieces_stops > 0) && (pieces[piecesEnd()-1].validity == QStrBinConv::INVALID);
+
+    if ( invalid || pieces_might == pieces.size() )
+    {
+        QApplication::beep();
+    }
+}
+
 QByteArray InputTextEditor::getInputData()
 {
     QByteArray buf;
 
     if ( inputConv )
     {
-        QString    str = editor->toPlainText();
-        int        erridx;
+        updatePieces();
+        int end = piecesEnd();
 
-        switch (inputConv->convert(str,&buf,&erridx))
+        if (end == 1)
         {
-            case QStrBinConv::VALID:
-                {
-                }
-                break;
-            case QStrBinConv::MIGHT_VALID:
-                QApplication::beep();
-                break;
-            case QStrBinConv::INVALID:
-                QApplication::beep();
-                break;
-            default:
-                break;
+            buf = pieces[0].data;
         }
+        else
+        {
+            if (!pieces_stops) buf.reserve(pieces_size);
+            for (int i = 0; i < end; ++i)
+                buf.append( pieces[i].data );
+        }
+        beepIfInvalid();
     }
 
     return buf;
 }
 
+size_t InputTextEditor::getDataSize()
+{
+    if ( !inputConv ) return 0;
+
+    updatePieces();
+    if (!pieces_stops) return pieces_size;
+
+    int    end  = piecesEnd();
+    size_t size = 0;
+    for (int i = 0; i < end; ++i)
+        size += pieces[i].data.size();
+    return size;
+}
+
+quint8 InputTextEditor::getDataFCS()
+{
+    uint sum = 0;
+
+    if ( inputConv )
+    {
+        updatePieces();
+        if (!pieces_stops)
+        {
+            sum = pieces_sum;
+        }
+        else
+        {
+            int end = piecesEnd();
+            for (int i = 0; i < end; ++i)
+                sum += pieces[i].sum;
+        }
+        beepIfInvalid();
+    }
+
+    return static_cast<quint8>( 255 - (sum & 0xFF) );
+}
+
 void InputTextEditor::setInputData(QByteArray &data)
 {
     if (displayConv)
     {
+        pieces_valid = false;
         editor->setPlainText( displayConv->convert(data) );
     }
 }
@@ -263,6 +507,51 @@ void InputTextEditor::on_editor_textChanged()
     emit inputChanged();
 }
 
+void InputTextEditor::on_document_contentsChange(int pos, int removed, int added)
+{
+    (void)removed;
+
+    if ( !pieces_valid ) return;
+    if ( !inputConv->isLineSeparable() )
+    {
+        pieces_valid = false;
+        return;
+    }
+
+    // Blocks from the one holding <pos> to the one holding end of added text replace the old ones
+    QTextDocument* doc   = editor->document();
+    QTextBlock     first = doc->findBlock(pos);
+    QTextBlock     last  = doc->findBlock(pos + added);
+
+    if (!first.isValid()) first = doc->lastBlock();
+    if (!last.isValid())  last  = doc->lastBlock();
+
+    int from      = first.blockNumber();
+    int new_count = last.blockNumber() - from + 1;
+    int old_count = new_count + pieces.size() - doc->blockCount();
+
+    if ( new_count < 1 || old_count < 1 || from + old_count > pieces.size() )
+    {
+        pieces_valid = false;
+        return;
+    }
+
+    for (int i = from; i < from + old_count; ++i)
+        countPiece(pieces[i], -1);
+
+    if (old_count > new_count)
+        pieces.remove(from, old_count - new_count);
+    else if (old_count < new_count)
+        pieces.insert(from, new_count - old_count, Piece());
+
+    QTextBlock block = first;
+    for (int i = from; i < from + new_count; ++i, block = block.next())
+    {
+        convertBlock(block, &pieces[i]);
+        countPiece(pieces[i], 1);
+    }
+}
+
 // ******************************************************************************** C L A S S: InputHexEditor
 
 
@@ -17,11 +17,51 @@
 
 #include <QStackedWidget>
 #include <QPlainTextEdit>
+#include <QVector>
+#include <QSharedData>
 #include "qhexedit.h"
 
 
 class QStrBinConv;
 class QBinStrConv;
+class QTextBlock;
+class QFile;
+
+// ******************************************************************************** C L A S S:  InputDataView
+/**
+ * Read-only view of the editor data of one version: ptr, size and version.
+ * All views of a version share one buffer (explicitly shared, never
+ * detached), so sending, history and status bar never copy the payload.
+ * A view is a snapshot - it keeps its data after later edits, only the
+ * editor's version moves on. FCS is computed once per version.
+ */
+class InputDataView
+{
+public:
+    InputDataView() {}
+
+    const char* ptr() const         { return d ? d->bytes.constData() : NULL; }
+    int         size() const        { return d ? d->bytes.size() : 0; }
+    quint32     version() const     { return d ? d->version : 0; }
+    bool        isEmpty() const     { return size() == 0; }
+    quint8      fcs() const;
+    /** Implicitly shared bytes of the view, no copy */
+    QByteArray  bytes() const       { return d ? d->bytes : QByteArray(); }
+
+private:
+    friend class BinaryEditor;
+
+    struct Data : public QSharedData
+    {
+        QByteArray bytes;
+        quint32    version;
+        int        fcs;             /* -1 - not computed yet */
+    };
+
+    InputDataView(const QByteArray& bytes, quint32 version);
+
+    QExplicitlySharedDataPointer<Data> d;
+};
 
 // ******************************************************************************** C L A S S:  InputEditorAbstract
 class InputEditorAbstract: public QObject
@@ -36,6 +76,8 @@ public:
     virtual QWidget*   getWidget() = 0;
     virtual void       undo() = 0;
     virtual void       redo() = 0;
+    virtual size_t     getDataSize()                   { return getInputData().size(); }
+    virtual quint8     getDataFCS();
 
 public Q_SLOTS:
     void   refreshInput() {
@@ -57,10 +99,32 @@ class InputTextEditor: public InputEditorAbstract
 {
     Q_OBJECT
 protected:
+    /* Converted part of the text, the input data is the sequence of pieces */
+    struct Piece {
+        QByteArray data;
+        uint       sum;         /* sum of data bytes, for FCS */
+        int        validity;    /* QStrBinConv::VALIDITY */
+        bool       stops;       /* conversion does not continue past this piece */
+    };
+
     QPlainTextEdit* editor;
     QStrBinConv*    inputConv;
     QBinStrConv*    displayConv;
     size_t          last_doc_size;
+
+    QVector<Piece>  pieces;         /* one per text block, single one if inputConv is not line separable */
+    bool            pieces_valid;   /* if false, whole text is converted on next use */
+    int             pieces_size;    /* totals of all the pieces */
+    uint            pieces_sum;
+    int             pieces_stops;
+    int             pieces_might;   /* MIGHT_VALID pieces */
+
+    void            convertText(QString& str, Piece* piece);
+    void            convertBlock(const QTextBlock& block, Piece* piece);
+    void            countPiece(const Piece& piece, int sign);
+    void            updatePieces();
+    int             piecesEnd();
+    void            beepIfInvalid();
 public:
     InputTextEditor(QPlainTextEdit* widget);
     ~InputTextEditor();
@@ -75,10 +139,13 @@ public:
     virtual QWidget*   getWidget()                     { return editor; }
     virtual void       undo()                          { editor->undo(); }
     virtual void       redo()                          { editor->redo(); }
+    virtual size_t     getDataSize();
+    virtual quint8     getDataFCS();
 
 protected Q_SLOTS:
     void on_editor_cursorPositionChanged();
     void on_editor_textChanged();
+    void on_document_contentsChange(int pos, int removed, int added);
 
 };
 
@@ -95,12 +162,14 @@ public:
 
     virtual QByteArray getInputData()                 { return editor->data(); }
     virtual void       setInputData(QByteArray& data) { editor->setData(data); }
-    virtual size_t     getInputSize()                 { return editor->data().size(); }
+    virtual size_t     getInputSize()                 { return editor->dataSize(); }
     virtual int        getCurrentPos()                { return editor->cursorPosition(); }
     virtual bool       getOverwriteMode()             { return editor->overwriteMode(); }
     virtual QWidget*   getWidget()                    { return editor; }
     virtual void       undo()                         { editor->undo(); }
     virtual void       redo()                         { editor->redo(); }
+    virtual size_t     getDataSize()                  { return editor->dataSize(); }
+    virtual quint8     getDataFCS()                   { return static_cast<quint8>( 255 - (editor->dataSum() & 0xFF) ); }
 
 public Q_SLOTS:
     void on_editor_currentAddressChanged (int address);
@@ -123,11 +192,15 @@ protected:
     void changeEvent(QEvent *e);
 
     InputEditorAbstract* current_editor;
-    QByteArray           _data_cache;
-    bool                 _data_cache_valid;
-
-    void                 updateDataCache(const QByteArray& data) { _data_cache = data;  _data_cache_valid=true; }
-    void                 updateDataCache() { if (!_data_cache_valid) {updateDataCache(current_editor->getInputData()); } }
+    InputDataView        _view;             /* data of _version, if _view_valid */
+    quint32              _version;          /* changes with every edit */
+    bool                 _view_valid;
+    QFile*               mapped_file;       /* file mapped into the hex editor, see openFile() */
+
+    void                 updateView(const QByteArray& data);
+    void                 updateView()      { if (!_view_valid) {updateView(current_editor->getInputData()); } }
+    void                 invalidateView()  { _view_valid = false; ++_version; }
+    void                 releaseFile();
 public:
     typedef enum {
         INMODE_TEXT,
@@ -138,31 +211,33 @@ public:
 
     void       setEditMode(input_modes_t mode, bool forceRefresh = false );
     void       setTextModeCoverters(QStrBinConv* inputConverter, QBinStrConv*  displayConverter);
+    bool       openFile(const QString& file_name, QString* error = NULL);
+    bool       isFileBacked() const           { return mapped_file != NULL; }
 
-    QByteArray getInputData()
+    /** Data of the current version, converted once per version */
+    InputDataView getInputView()
     {
-        updateDataCache();
-        return _data_cache;
+        updateView();
+        return _view;
     }
+    quint32    getInputVersion() const        { return _version; }
 
-    const QByteArray& getInputConstData()
-    {
-        updateDataCache();
-        return _data_cache;
-    }
+    QByteArray getInputData()                 { return getInputView().bytes(); }
 
     void       setInputData( QByteArray& data)
     {
         current_editor->setInputData(data);
-        updateDataCache(data);
+        releaseFile();
+        ++_version;
+        updateView(data);
 
         refreshInput();
     }
     size_t     getInputSize()
     {
-        updateDataCache();
-        return _data_cache.size();
+        return (_view_valid) ? _view.size() : current_editor->getDataSize();
     }
+    quint8     getInputFCS();
     int        getCurrentPos()                { return current_editor->getCurrentPos(); }
     bool       getOverwriteMode()             { return current_editor->getOverwriteMode(); }
 
@@ -0,0 +1,380 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Capture log writer thread, record reader and offline export
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#include <string.h>
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QtEndian>
+
+#include "CaptureLog.h"
+#include "RecordExporter.h"
+#include "strbinconv.h"
+
+const char CaptureLog::magic[8] = { 'R','S','2','3','2','C','A','P' };
+
+//======================================================= CaptureLog::exportFile
+
+bool CaptureLog::exportFile(const QString &capture_name, const QString &out_name, QBinStrConv *conv, QString *error)
+{
+    CaptureLogReader         reader;
+    OutputRecordStore::Record rec;
+    QByteArray               payload;
+    QFile                    out(out_name);
+
+    if (!reader.open(capture_name))
+    {
+        if (error) *error = reader.errorString();
+        return false;
+    }
+    if (!out.open(QIODevice::WriteOnly))
+    {
+        if (error) *error = QString("Cannot open for writing file: %1").arg(out_name);
+        return false;
+    }
+
+    RecordExporter exporter(&out, conv, RecordExporter::formatForFile(out_name));
+    bool           ok = exporter.begin();
+
+    while ( ok && reader.readRecord(&rec, &payload) )
+    {
+        ok = exporter.write(rec, payload.constData());
+    }
+    ok = ok && exporter.end();
+
+    if (error)
+    {
+        if (!ok)                                 *error = QString("Cannot write to file: %1").arg(out_name);
+        else if (!reader.errorString().isEmpty()) *error = reader.errorString();
+    }
+    return ok && reader.errorString().isEmpty();
+}
+
+// ******************************************************************************** C L A S S:  CaptureLogThread
+class CaptureLogThread : public QThread
+{
+public:
+    explicit CaptureLogThread(CaptureLogWriter* writer) : writer(writer) {}
+protected:
+    virtual void run() { writer->run(); }
+private:
+    CaptureLogWriter* writer;
+};
+
+// ******************************************************************************** C L A S S:  CaptureLogWriter
+
+CaptureLogWriter::CaptureLogWriter()
+    : is_open(false)
+    , thread(NULL)
+    , open_time(0)
+    , commit_interval(DEFAULT_COMMIT_INTERVAL)
+    , queue_limit(DEFAULT_QUEUE_LIMIT)
+    , front_records(0)
+    , stopping(false)
+    , commit_now(false)
+{
+    memset(&st, 0, sizeof(st));
+}
+
+CaptureLogWriter::~CaptureLogWriter()
+{
+    close();
+}
+
+void CaptureLogWriter::setCommitInterval(int ms)
+{
+    commit_interval = qBound(static_cast<int>(MIN_COMMIT_INTERVAL), ms, static_cast<int>(MAX_COMMIT_INTERVAL));
+}
+
+void CaptureLogWriter::setQueueLimit(int bytes)
+{
+    queue_limit = qMax(static_cast<int>(MIN_QUEUE_LIMIT), bytes);
+}
+
+bool CaptureLogWriter::open(const QString &file_name)
+{
+    uchar hdr[CaptureLog::FILE_HEADER_SIZE];
+
+    close();
+
+    // Own buffering, so QFile does not have to copy the data once again
+    this->file_name = file_name;
+    file.setFileName(file_name);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered))
+    {
+        error = file.errorString();
+        return false;
+    }
+
+    memset(hdr, 0, sizeof(hdr));
+    memcpy(hdr, CaptureLog::magic, sizeof(CaptureLog::magic));
+    qToLittleEndian<quint16>(CaptureLog::VERSION,            hdr + 8);
+    qToLittleEndian<quint16>(CaptureLog::FILE_HEADER_SIZE,   hdr + 10);
+    qToLittleEndian<quint16>(CaptureLog::RECORD_HEADER_SIZE, hdr + 12);
+    qToLittleEndian<qint64>(QDateTime::currentMSecsSinceEpoch(), hdr + 16);
+
+    if (file.write(reinterpret_cast<const char*>(hdr), sizeof(hdr)) != sizeof(hdr))
+    {
+        error = file.errorString();
+        file.close();
+        return false;
+    }
+
+    open_time = HiResClock::now();
+    memset(&st, 0, sizeof(st));
+    st.bytes_written = sizeof(hdr);
+    front.reserve(COMMIT_THRESHOLD);
+    front_records = 0;
+    stopping   = false;
+    commit_now = false;
+    error.clear();
+    is_open    = true;
+
+    thread = new CaptureLogThread(this);
+    thread->start();
+
+    return true;
+}
+
+void CaptureLogWriter::close()
+{
+    if (!is_open) return;
+
+    mutex.lock();
+    stopping = true;
+    wake.wakeAll();
+    mutex.unlock();
+
+    thread->wait();
+    delete thread;
+    thread = NULL;
+
+    file.close();
+    front.clear();
+    front_records = 0;
+    is_open = false;
+}
+
+bool CaptureLogWriter::write(OutputRecordStore::record_kind_t kind, const char *data, int size, qint64 time_us, QRgb color, int style)
+{
+    uchar hdr[CaptureLog::RECORD_HEADER_SIZE];
+
+    if (!is_open) return false;
+    if (time_us < 0) time_us = timestamp();
+
+    memset(hdr, 0, sizeof(hdr));
+    qToLittleEndian<quint64>(static_cast<quint64>(time_us), hdr);
+    qToLittleEndian<quint32>(static_cast<quint32>(size),    hdr + 8);
+    hdr[12] = static_cast<uchar>(kind);
+    hdr[13] = static_cast<uchar>(style);
+    qToLittleEndian<quint32>(color, hdr + 16);
+
+    QMutexLocker lock(&mutex);
+
+    // Backpressure: drop whole records rather than stall the caller
+    if ( st.write_error || size > CaptureLog::MAX_RECORD_SIZE
+         || front.size() + static_cast<int>(sizeof(hdr)) + size > queue_limit )
+    {
+        st.dropped_records++;
+        st.dropped_bytes += sizeof(hdr) + size;
+        return false;
+    }
+
+    front.append(reinterpret_cast<const char*>(hdr), sizeof(hdr));
+    front.append(data, size);
+    front_records++;
+
+    if (front.size() >= COMMIT_THRESHOLD) wake.wakeAll();
+    return true;
+}
+
+bool CaptureLogWriter::writeMessage(const QString &text, QRgb color, int style)
+{
+    QByteArray utf8 = text.toUtf8();
+    return write(OutputRecordStore::REC_MESSAGE, utf8.constData(), utf8.size(), -1, color, style);
+}
+
+void CaptureLogWriter::flush()
+{
+    QMutexLocker lock(&mutex);
+    commit_now = true;
+    wake.wakeAll();
+}
+
+QString CaptureLogWriter::errorString() const
+{
+    QMutexLocker lock(&mutex);
+    return error;
+}
+
+CaptureLogWriter::Stats CaptureLogWriter::stats() const
+{
+    QMutexLocker lock(&mutex);
+    Stats s = st;
+    s.bytes_queued = front.size();
+    return s;
+}
+
+void CaptureLogWriter::run()
+{
+    QByteArray    back;
+    int           back_records;
+    QElapsedTimer timer;
+    qint64        res, done, us;
+
+    back.reserve(COMMIT_THRESHOLD);
+
+    QMutexLocker lock(&mutex);
+    for (;;)
+    {
+        if (!stopping && !commit_now && front.size() < COMMIT_THRESHOLD)
+        {
+            wake.wait(&mutex, commit_interval);
+        }
+        commit_now = false;
+
+        if (front.isEmpty())
+        {
+            if (stopping) break;
+            continue;
+        }
+
+        // Swap buffers, write the filled one without blocking producers
+        qSwap(front, back);
+        back_records  = front_records;
+        front_records = 0;
+        lock.unlock();
+
+        // The device may take only a part, the rest goes in next calls
+        timer.start();
+        done = 0;
+        do
+        {
+            res = file.write(back.constData() + done, back.size() - done);
+            if (res > 0) done += res;
+        } while (res > 0 && done < back.size());
+        us  = timer.nsecsElapsed() / 1000;
+
+        lock.relock();
+        st.commits++;
+        st.last_commit_us = us;
+        if (us > st.max_commit_us) st.max_commit_us = us;
+        st.bytes_written += done;
+        if (done == back.size())
+        {
+            st.records_written += back_records;
+        }
+        else
+        {
+            st.write_error = true;
+            st.dropped_records += back_records + front_records;
+            st.dropped_bytes   += back.size() - done + front.size();
+            error = file.errorString();
+            front.resize(0);
+            front_records = 0;
+        }
+        back.resize(0);     /* keeps capacity */
+    }
+}
+
+// ******************************************************************************** C L A S S:  CaptureLogReader
+
+CaptureLogReader::CaptureLogReader()
+    : start_time(0)
+    , rec_header_size(CaptureLog::RECORD_HEADER_SIZE)
+{
+}
+
+bool CaptureLogReader::open(const QString &file_name)
+{
+    uchar hdr[CaptureLog::FILE_HEADER_SIZE];
+    int   hdr_size;
+
+    error.clear();
+    file.close();
+    file.setFileName(file_name);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        error = QString("Cannot open for reading file: %1").arg(file_name);
+        return false;
+    }
+
+    if ( file.read(reinterpret_cast<char*>(hdr), sizeof(hdr)) != sizeof(hdr)
+         || memcmp(hdr, CaptureLog::magic, sizeof(CaptureLog::magic)) )
+    {
+        error = QString("Not a capture log file: %1").arg(file_name);
+        return false;
+    }
+
+    hdr_size        = qFromLittleEndian<quint16>(hdr + 10);
+    rec_header_size = qFromLittleEndian<quint16>(hdr + 12);
+    start_time      = qFromLittleEndian<qint64>(hdr + 16);
+
+    if ( qFromLittleEndian<quint16>(hdr + 8) > CaptureLog::VERSION
+         || hdr_size < CaptureLog::FILE_HEADER_SIZE
+         || rec_header_size < CaptureLog::RECORD_HEADER_SIZE )
+    {
+        error = QString("Unsupported capture log version: %1").arg(file_name);
+        return false;
+    }
+
+    return file.seek(hdr_size);
+}
+
+bool CaptureLogReader::readRecord(OutputRecordStore::Record *rec, QByteArray *payload, qint64 *time_us)
+{
+    uchar  hdr[CaptureLog::RECORD_HEADER_SIZE];
+    qint64 us, res;
+
+    if (!file.isOpen() || file.atEnd()) return false;
+
+    // A crash or power loss leaves the last record cut off, the capture
+    // ends with the last complete one
+    res = file.read(reinterpret_cast<char*>(hdr), sizeof(hdr));
+    if (res < 0)
+    {
+        error = QString("Cannot read file: %1").arg(file.fileName());
+        return false;
+    }
+    if ( res != sizeof(hdr)
+         || ( rec_header_size > CaptureLog::RECORD_HEADER_SIZE
+              && !file.seek(file.pos() + rec_header_size - CaptureLog::RECORD_HEADER_SIZE) ) )
+    {
+        return false;
+    }
+
+    us          = static_cast<qint64>( qFromLittleEndian<quint64>(hdr) );
+    rec->time   = start_time + us / 1000;
+    rec->pos    = 0;
+    rec->chunk  = 0;
+    rec->offset = 0;
+    rec->size   = static_cast<int>( qFromLittleEndian<quint32>(hdr + 8) );
+    rec->kind   = hdr[12];
+    rec->style  = hdr[13];
+    rec->color  = qFromLittleEndian<quint32>(hdr + 16);
+    if (time_us) *time_us = us;
+
+    if ( rec->size < 0 || rec->size > CaptureLog::MAX_RECORD_SIZE
+         || rec->kind >= OutputRecordStore::__REC_KIND_CNT )
+    {
+        error = QString("Corrupted record in: %1").arg(file.fileName());
+        return false;
+    }
+    // Payload cut off, the same as a short read - don't allocate for it
+    if (rec->size > file.size() - file.pos()) return false;
+
+    *payload = file.read(rec->size);
+    return payload->size() == rec->size;
+}
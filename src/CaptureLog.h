@@ -0,0 +1,189 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Binary capture log: writer, reader and offline exporter
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#ifndef CAPTURELOG_H
+#define CAPTURELOG_H
+
+#include <QFile>
+#include <QByteArray>
+#include <QString>
+#include <QMutex>
+#include <QWaitCondition>
+
+#include "OutputRecordStore.h"
+#include "HiResClock.h"
+
+class QBinStrConv;
+class QThread;
+
+/**
+ * File layout (all numbers little endian):
+ *
+ *   file header, FILE_HEADER_SIZE bytes
+ *     0  char[8]  magic "RS232CAP"
+ *     8  u16      version
+ *    10  u16      file header size
+ *    12  u16      record header size
+ *    14  u16      reserved
+ *    16  i64      capture start, ms since epoch
+ *    24  u64      reserved
+ *
+ *   records, each: header (RECORD_HEADER_SIZE bytes) followed by payload
+ *     0  u64      timestamp, us since capture start (monotonic clock)
+ *     8  u32      payload size
+ *    12  u8       kind: OutputRecordStore::record_kind_t (RX, TX, event message)
+ *    13  u8       style (messages only)
+ *    14  u16      flags, reserved
+ *    16  u32      color, 0xAARRGGBB (messages only)
+ *    20  u32      reserved
+ *
+ * Readers skip unknown header tails using the sizes stored in the file header.
+ */
+namespace CaptureLog
+{
+    enum {
+        VERSION            = 1,
+        FILE_HEADER_SIZE   = 32,
+        RECORD_HEADER_SIZE = 24,
+        MAX_RECORD_SIZE    = 64*1024*1024   /* payload, larger ones are not written */
+    };
+    extern const char magic[8];
+
+    /** Renders a capture file with given display converter, format depends on out_name extension (.html/.htm or text) */
+    bool exportFile(const QString& capture_name, const QString& out_name, QBinStrConv* conv, QString* error);
+}
+
+// ******************************************************************************** C L A S S:  CaptureLogWriter
+/**
+ * Records are queued in memory by the caller thread and written to disk by a
+ * background thread, so disk latency never reaches the receive path.
+ *
+ * Double buffering: write() appends to the front buffer, the writer thread
+ * swaps it with the back buffer and writes that one without holding the
+ * lock. Commits are grouped: the writer wakes up every commit interval, or
+ * earlier when COMMIT_THRESHOLD bytes are queued. The queue is bounded -
+ * when the disk does not keep up and the limit is reached, whole records
+ * are dropped (write() returns false) and counted in Stats.
+ * A failed disk write stops the log: a record cut in the middle would make
+ * everything after it unreadable, so records of the failed commit and all
+ * later ones are dropped.
+ */
+class CaptureLogWriter
+{
+public:
+    enum {
+        DEFAULT_COMMIT_INTERVAL = 500,          /* ms */
+        MIN_COMMIT_INTERVAL     = 10,
+        MAX_COMMIT_INTERVAL     = 10000,
+        DEFAULT_QUEUE_LIMIT     = 8*1024*1024,  /* bytes */
+        MIN_QUEUE_LIMIT         = 64*1024,
+        COMMIT_THRESHOLD        = 256*1024      /* wake writer early */
+    };
+
+    struct Stats
+    {
+        qint64 bytes_queued;        /* waiting in front buffer */
+        qint64 bytes_written;
+        qint64 records_written;     /* reached the file */
+        qint64 dropped_records;
+        qint64 dropped_bytes;
+        qint64 commits;
+        qint64 last_commit_us;      /* duration of last disk write */
+        qint64 max_commit_us;
+        bool   write_error;         /* nothing is written after it */
+    };
+
+    CaptureLogWriter();
+    ~CaptureLogWriter();
+
+    /** Must be set before open() */
+    void    setCommitInterval(int ms);
+    void    setQueueLimit(int bytes);
+
+    bool    open(const QString& file_name);
+    /** Commits everything queued and stops the writer thread */
+    void    close();
+    bool    isOpen() const          { return is_open; }
+    QString fileName() const        { return file_name; }
+    QString errorString() const;
+
+    /** Monotonic time since open(), us */
+    qint64  timestamp() const       { return timestampAt(HiResClock::now()); }
+    /** Converts HiResClock time (e.g. arrival stamp of received data) to capture time, us */
+    qint64  timestampAt(qint64 clock_ns) const { return qMax<qint64>(clock_ns - open_time, 0) / 1000; }
+
+    /** time_us < 0 - current timestamp(). Never blocks on disk, returns false if record was dropped */
+    bool    write(OutputRecordStore::record_kind_t kind, const char* data, int size,
+                  qint64 time_us = -1, QRgb color = 0, int style = OutputRecordStore::STYLE_NORMAL);
+    bool    writeMessage(const QString& text, QRgb color, int style);
+    /** Requests commit of queued records, does not wait for it */
+    void    flush();
+
+    Stats   stats() const;
+
+private:
+    Q_DISABLE_COPY(CaptureLogWriter)
+    friend class CaptureLogThread;
+
+    void    run();                  /* writer thread body */
+
+    QFile          file;            /* used only by writer thread while open */
+    QString        file_name;
+    QString        error;
+    bool           is_open;
+    QThread*       thread;
+    qint64         open_time;       /* HiResClock */
+    int            commit_interval;
+    int            queue_limit;
+
+    mutable QMutex mutex;           /* protects everything below */
+    QWaitCondition wake;
+    QByteArray     front;
+    int            front_records;
+    bool           stopping;
+    bool           commit_now;
+    Stats          st;
+};
+
+// ******************************************************************************** C L A S S:  CaptureLogReader
+class CaptureLogReader
+{
+public:
+    CaptureLogReader();
+
+    bool    open(const QString& file_name);
+    void    close()                 { file.close(); }
+    QString errorString() const     { return error; }
+    qint64  startTime() const       { return start_time; }
+
+    /**
+     * Reads next record; rec->time is converted to ms since epoch, exact
+     * timestamp (us since capture start) is returned in time_us if provided.
+     * Returns false at end of file or on error (errorString() not empty).
+     * A truncated last record is the end of file, not an error. A payload
+     * size above CaptureLog::MAX_RECORD_SIZE is reported as corrupted file;
+     * nothing is allocated for a size larger than the rest of the file.
+     */
+    bool    readRecord(OutputRecordStore::Record* rec, QByteArray* payload, qint64* time_us = NULL);
+
+private:
+    Q_DISABLE_COPY(CaptureLogReader)
+
+    QFile    file;
+    QString  error;
+    qint64   start_time;
+    int      rec_header_size;
+};
+
+#endif // CAPTURELOG_H
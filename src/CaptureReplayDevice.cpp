@@ -0,0 +1,188 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Capture replay paced by the recorded timestamps
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#include "CaptureReplayDevice.h"
+#include "HiResClock.h"
+
+#include "debug.h"
+
+// ******************************************************************************** C L A S S:  CaptureReplayDevice
+
+CaptureReplayDevice::CaptureReplayDevice(QObject *parent)
+    : SerialDeviceInterface(parent)
+    , is_open(false)
+    , active(false)
+    , speed_factor(1.0)
+    , rec_us(0)
+    , has_rec(false)
+    , clock_origin(0)
+    , pace_clock(0)
+    , pace_us(0)
+    , last_us(0)
+    , records(0)
+    , bytes(0)
+{
+    timer.setSingleShot(true);
+    timer.setTimerType(Qt::PreciseTimer);
+    ASSERT_ALWAYS( connect(&timer, SIGNAL(timeout()), SLOT(replay()) ) );
+}
+
+CaptureReplayDevice::~CaptureReplayDevice()
+{
+    close();
+}
+
+bool CaptureReplayDevice::open(const QString &file_name)
+{
+    close();
+    if (!reader.open(file_name))
+    {
+        error = reader.errorString();
+        return false;
+    }
+    error.clear();
+    is_open = true;
+    has_rec = false;
+    records = 0;
+    bytes   = 0;
+    last_us = 0;
+    return true;
+}
+
+void CaptureReplayDevice::close()
+{
+    stop();
+    reader.close();
+    is_open = false;
+    has_rec = false;
+}
+
+void CaptureReplayDevice::setSpeed(double factor)
+{
+    qint64 now = HiResClock::now();
+
+    // rebase pacing, so the change applies from the current position on
+    if (active)
+    {
+        pace_us    = (speed_factor > 0) ? pace_us + static_cast<qint64>((now - pace_clock) / 1000 * speed_factor) : rec_us;
+        pace_clock = now;
+        timer.start(0);
+    }
+    speed_factor = (factor > 0) ? factor : 0;
+}
+
+void CaptureReplayDevice::start()
+{
+    if (!is_open || active) return;
+
+    if (!has_rec && !readNext())
+    {
+        finish(reader.errorString().isEmpty());
+        return;
+    }
+
+    active       = true;
+    pace_clock   = HiResClock::now();
+    pace_us      = rec_us;
+    if (records == 0) clock_origin = pace_clock - rec_us * 1000;
+    timer.start(0);
+}
+
+void CaptureReplayDevice::stop()
+{
+    active = false;
+    timer.stop();
+}
+
+bool CaptureReplayDevice::send(const QByteArray &buf)
+{
+    (void) buf;
+    return false;
+}
+
+qint64 CaptureReplayDevice::dueTime(qint64 us) const
+{
+    return pace_clock + static_cast<qint64>((us - pace_us) * 1000 / speed_factor);
+}
+
+bool CaptureReplayDevice::readNext()
+{
+    do
+    {
+        if (!reader.readRecord(&rec, &payload, &rec_us))
+        {
+            has_rec = false;
+            return false;
+        }
+    } while (rec.kind == OutputRecordStore::REC_MESSAGE);
+
+    has_rec = true;
+    return true;
+}
+
+void CaptureReplayDevice::replay()
+{
+    qint64 now   = HiResClock::now();
+    int    batch = 0;
+
+    while (active && has_rec)
+    {
+        if (speed_factor > 0)
+        {
+            // Sub-millisecond waits would round down to a zero timer and spin,
+            // records due that soon are delivered now (stamps stay exact)
+            qint64 wait_ns = dueTime(rec_us) - now;
+            if (wait_ns >= DUE_WINDOW_NS)
+            {
+                timer.start( static_cast<int>(qMin(wait_ns / 1000000, static_cast<qint64>(MAX_WAIT))) );
+                return;
+            }
+        }
+        else if (batch >= MAX_SPEED_BATCH)
+        {
+            timer.start(0);     // let the display catch up
+            return;
+        }
+
+        qint64 stamp = clock_origin + rec_us * 1000;
+
+        last_us = rec_us;
+        records++;
+        bytes  += payload.size();
+        batch  += payload.size();
+
+        if (rec.kind == OutputRecordStore::REC_RX)
+        {
+            emit rxData(payload, stamp);
+            emit on_receive(payload);
+        }
+        else
+        {
+            emit txData(payload, stamp);
+        }
+
+        if (!readNext())
+        {
+            finish(reader.errorString().isEmpty());
+            return;
+        }
+    }
+}
+
+void CaptureReplayDevice::finish(bool ok)
+{
+    if (!ok) error = reader.errorString();
+    stop();
+    emit finished(ok);
+}
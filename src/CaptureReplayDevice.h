@@ -0,0 +1,110 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Plays a capture log back as if it came from a port
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#ifndef CAPTUREREPLAYDEVICE_H
+#define CAPTUREREPLAYDEVICE_H
+
+#include <QTimer>
+#include <QByteArray>
+#include <QString>
+
+#include "SerialDeviceInterface.h"
+#include "CaptureLog.h"
+
+// ******************************************************************************** C L A S S:  CaptureReplayDevice
+/**
+ * Reads a capture log (CaptureLogWriter) and delivers its data records in
+ * the recorded rhythm: at recorded speed, scaled (setSpeed(2.0) - twice as
+ * fast) or as fast as possible (speed 0).
+ *
+ * Every record carries a HiResClock stamp on a virtual clock started with
+ * start(): origin + capture time, not scaled by the speed. Frame splitting
+ * on line gaps (RxAccumulator) therefore sees the original gaps even at
+ * full speed. Log messages of the original session are skipped.
+ *
+ * Received (RX) records are also emitted through on_receive() for
+ * SerialDeviceInterface users. The device is read only, send() fails.
+ */
+class CaptureReplayDevice : public SerialDeviceInterface
+{
+    Q_OBJECT
+public:
+    enum {
+        MAX_SPEED_BATCH = 256*1024,     /* bytes delivered per event loop pass at full speed */
+        MAX_WAIT        = 1000,         /* ms, long pauses are waited out in steps (keeps stop() responsive) */
+        DUE_WINDOW_NS   = 1000000       /* records due within it go in the current batch, timers run in ms */
+    };
+
+    explicit CaptureReplayDevice(QObject* parent = 0);
+    ~CaptureReplayDevice();
+
+    bool     open(const QString& file_name);
+    void     close();
+    bool     isOpen() const             { return is_open; }
+    QString  errorString() const        { return error; }
+
+    /** 1.0 - recorded speed, 0 - as fast as possible; may change while playing */
+    void     setSpeed(double factor);
+    double   speed() const              { return speed_factor; }
+
+    void     start();
+    void     stop();
+    bool     isActive() const           { return active; }
+
+    qint64   recordsReplayed() const    { return records; }
+    qint64   bytesReplayed() const      { return bytes; }
+    /** Capture time of the last delivered record, us */
+    qint64   position() const           { return last_us; }
+
+    virtual bool send(const QByteArray& buf);
+
+signals:
+    /** time_ns - HiResClock stamp on the replay clock, see class description */
+    void     rxData(const QByteArray& data, qint64 time_ns);
+    void     txData(const QByteArray& data, qint64 time_ns);
+    /** End of capture or read error (errorString()); not emitted by stop() */
+    void     finished(bool ok);
+
+private slots:
+    void     replay();
+
+private:
+    Q_DISABLE_COPY(CaptureReplayDevice)
+
+    bool     readNext();
+    void     finish(bool ok);
+    /** Wall clock (HiResClock) time when the record at capture time us is due */
+    qint64   dueTime(qint64 us) const;
+
+    CaptureLogReader          reader;
+    QTimer                    timer;
+    QString                   error;
+    bool                      is_open;
+    bool                      active;
+    double                    speed_factor;
+
+    OutputRecordStore::Record rec;          /* next record to deliver */
+    QByteArray                payload;
+    qint64                    rec_us;
+    bool                      has_rec;
+
+    qint64                    clock_origin; /* HiResClock at capture time 0 on the replay clock */
+    qint64                    pace_clock;   /* wall clock ... */
+    qint64                    pace_us;      /* ... at this capture time, rebased on speed change */
+    qint64                    last_us;
+    qint64                    records;
+    qint64                    bytes;
+};
+
+#endif // CAPTUREREPLAYDEVICE_H
@@ -0,0 +1,195 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    File transfer through the transmit queue, a window of chunks at a time
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#include "FileSender.h"
+#include "SerialPortEngine.h"
+
+#include "debug.h"
+
+// ******************************************************************************** C L A S S:  FileSender
+
+FileSender::FileSender(SerialPortEngine *port, QObject *parent)
+    : QObject(parent)
+    , port(port)
+    , map(NULL)
+    , total(0)
+    , queued(0)
+    , confirmed(0)
+    , acked(0)
+    , window(DEFAULT_WINDOW)
+    , active(false)
+{
+    progress_timer.setInterval(PROGRESS_INTERVAL);
+    ASSERT_ALWAYS( connect(&progress_timer, SIGNAL(timeout()), SLOT(onProgressTimer()) ) );
+}
+
+FileSender::~FileSender()
+{
+    cancel();
+}
+
+bool FileSender::start(const QString &file_name)
+{
+    if (active) return false;
+
+    error.clear();
+    file.setFileName(file_name);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        error = file.errorString();
+        return false;
+    }
+
+    total     = file.size();
+    queued    = 0;
+    confirmed = 0;
+    acked     = 0;
+    in_flight.clear();
+    // mapping fails for special files, pipes, or when address space is short - read then
+    map       = (total > 0) ? file.map(0, total) : NULL;
+
+    active = true;
+    clock.start();
+    progress_timer.start();
+    ASSERT_ALWAYS( connect(port, SIGNAL(bytesWritten(qint64)), this, SLOT(onBytesWritten(qint64)) ) );
+    ASSERT_ALWAYS( connect(port, SIGNAL(error(QSerialPort::SerialPortError)), this, SLOT(onPortError(QSerialPort::SerialPortError)) ) );
+
+    if (total == 0)
+    {
+        finish(true);
+        return true;
+    }
+
+    feed();
+    return true;
+}
+
+void FileSender::cancel()
+{
+    if (active) finish(false, tr("Cancelled"));
+}
+
+double FileSender::rate() const
+{
+    qint64 ms = elapsed();
+    return (ms > 0) ? confirmed * 1000.0 / ms : 0.0;
+}
+
+qint64 FileSender::eta() const
+{
+    double r = rate();
+    if (confirmed <= 0 || r <= 0.0) return -1;
+    return static_cast<qint64>( (total - confirmed) * 1000.0 / r );
+}
+
+void FileSender::feed()
+{
+    qint64 len;
+
+    while ( active && queued < total && (queued - confirmed) < window )
+    {
+        len = qMin<qint64>( qMin<qint64>(CHUNK_SIZE, total - queued), window - (queued - confirmed) );
+
+        if (!port->isOpen())
+        {
+            finish(false, tr("Port is closed"));
+            return;
+        }
+
+        QByteArray chunk = map
+                ? QByteArray::fromRawData(reinterpret_cast<const char*>(map + queued), static_cast<int>(len))
+                : ( file.seek(queued) ? file.read(len) : QByteArray() );
+
+        if (chunk.size() != len)
+        {
+            finish(false, file.errorString());
+            return;
+        }
+        Chunk sent = { port->txWritten(), len };
+
+        // Transmit queue full (shared with other writes) - retried on next bytesWritten()
+        if (port->write(chunk) != len) return;
+        in_flight.append(sent);
+        queued += len;
+    }
+}
+
+void FileSender::onBytesWritten(qint64 bytes)
+{
+    qint64 done = port->txDone();
+
+    (void) bytes;   // may belong to other packets, positions tell
+    if (!active) return;
+
+    while (!in_flight.isEmpty() && done >= in_flight.first().pos + in_flight.first().len)
+    {
+        acked += in_flight.first().len;
+        in_flight.removeFirst();
+    }
+    confirmed = acked;
+    if (!in_flight.isEmpty() && done > in_flight.first().pos) confirmed += done - in_flight.first().pos;
+
+    if (confirmed >= total)
+    {
+        finish(true);
+        return;
+    }
+    feed();
+}
+
+void FileSender::onPortError(QSerialPort::SerialPortError error)
+{
+    if (!active) return;
+
+    // a failed or removed device confirms nothing more - don't wait for it;
+    // line errors of received data and rejected settings don't stop sending
+    switch (error)
+    {
+    case QSerialPort::WriteError:
+    case QSerialPort::ResourceError:
+    case QSerialPort::DeviceNotFoundError:
+    case QSerialPort::NotOpenError:
+        finish(false, port->errorString());
+        break;
+    default:
+        break;
+    }
+}
+
+void FileSender::onProgressTimer()
+{
+    emit progress(confirmed, total);
+}
+
+void FileSender::finish(bool ok, const QString &err)
+{
+    disconnect(port, SIGNAL(bytesWritten(qint64)), this, SLOT(onBytesWritten(qint64)));
+    disconnect(port, SIGNAL(error(QSerialPort::SerialPortError)), this, SLOT(onPortError(QSerialPort::SerialPortError)));
+    progress_timer.stop();
+    active = false;
+    error  = err;
+
+    // Stop means stop - and the transmit queue may still hold views into the mapping
+    if (!ok) port->clearTx();
+    if (map)
+    {
+        file.unmap(map);
+        map = NULL;
+    }
+    file.close();
+    in_flight.clear();
+
+    emit progress(confirmed, total);
+    emit finished(ok);
+}
@@ -0,0 +1,112 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Streams a file to the serial port without loading it into memory
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#ifndef FILESENDER_H
+#define FILESENDER_H
+
+#include <QObject>
+#include <QFile>
+#include <QString>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QList>
+
+#include "QSerialPort"
+
+class SerialPortEngine;
+
+// ******************************************************************************** C L A S S:  FileSender
+/**
+ * Sends a file chunk by chunk. The file is memory mapped when possible and
+ * chunks are handed to the port as raw views into the mapping, otherwise
+ * they are read one at a time. Only a window of data is in flight: the next
+ * chunk goes out when bytesWritten() confirms that the port has written
+ * the previous ones, so memory use does not depend on the file size and the
+ * transmit queue never holds more than the window. Each chunk is one packet
+ * for the transmit scheduler (see SerialPortWorker).
+ *
+ * Other packets may be written while the file is being sent. Chunks keep
+ * their position in the port's transmit stream (SerialPortEngine::txWritten())
+ * and only their own bytes are counted as confirmed, see txDone().
+ */
+class FileSender : public QObject
+{
+    Q_OBJECT
+public:
+    enum {
+        CHUNK_SIZE        = 64*1024,     /* bytes */
+        DEFAULT_WINDOW    = 256*1024,    /* bytes handed to the port, not confirmed yet */
+        PROGRESS_INTERVAL = 250          /* ms */
+    };
+
+    explicit FileSender(SerialPortEngine* port, QObject* parent = 0);
+    ~FileSender();
+
+    void    setWindow(int bytes)      { window = (bytes >= CHUNK_SIZE) ? bytes : CHUNK_SIZE; }
+
+    bool    start(const QString& file_name);
+    bool    isActive() const          { return active; }
+    QString fileName() const          { return file.fileName(); }
+    QString errorString() const       { return error; }
+
+    qint64  totalSize() const         { return total; }
+    /** Bytes of the file confirmed as written by the port */
+    qint64  bytesSent() const         { return confirmed; }
+    qint64  elapsed() const           { return clock.isValid() ? clock.elapsed() : 0; }
+    /** Average throughput, bytes per second */
+    double  rate() const;
+    /** Estimated time to completion, ms; -1 - unknown yet */
+    qint64  eta() const;
+
+public slots:
+    void    cancel();
+
+signals:
+    void    progress(qint64 sent, qint64 total);
+    /** ok is false if the transfer was cancelled or failed, see errorString() */
+    void    finished(bool ok);
+
+private slots:
+    void    onBytesWritten(qint64 bytes);
+    void    onPortError(QSerialPort::SerialPortError error);
+    void    onProgressTimer();
+
+private:
+    Q_DISABLE_COPY(FileSender)
+
+    void    feed();
+    void    finish(bool ok, const QString& err = QString());
+
+    struct Chunk
+    {
+        qint64 pos;             /* transmit stream position, see SerialPortEngine::txWritten() */
+        qint64 len;
+    };
+
+    SerialPortEngine* port;
+    QFile             file;
+    uchar*            map;          /* NULL - file is read in chunks */
+    qint64            total;
+    qint64            queued;       /* handed to the port */
+    qint64            confirmed;    /* file bytes written by the port */
+    qint64            acked;        /* ... in chunks already written completely */
+    QList<Chunk>      in_flight;    /* chunks handed to the port, not written completely */
+    int               window;
+    bool              active;
+    QString           error;
+    QElapsedTimer     clock;
+    QTimer            progress_timer;
+};
+
+#endif // FILESENDER_H
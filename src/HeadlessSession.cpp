@@ -0,0 +1,321 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Command line session: port setup, script, capture and exit status
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#include <stdio.h>
+#include <signal.h>
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QTextStream>
+
+#include "HeadlessSession.h"
+#include "SerialPortEngine.h"
+#include "RxAccumulator.h"
+#include "CaptureLog.h"
+#include "strbinconv.h"
+#include "appconfig.h"
+
+#include "debug.h"
+
+static volatile sig_atomic_t interrupted = 0;
+
+static void onInterruptSignal(int)
+{
+    interrupted = 1;
+}
+
+// ******************************************************************************** C L A S S:  HeadlessSession
+
+HeadlessSession::HeadlessSession(QObject *parent)
+    : QObject(parent)
+    , port(NULL)
+    , rx(NULL)
+    , capture(NULL)
+    , display_conv(NULL)
+    , input_conv(NULL)
+    , hex_output(false)
+    , script_pos(0)
+    , exit_code(0)
+    , quitting(false)
+    , stopped(false)
+{
+    script_timer.setSingleShot(true);
+    ASSERT_ALWAYS( connect(&script_timer,    SIGNAL(timeout()), SLOT(runScript()) ) );
+    ASSERT_ALWAYS( connect(&interrupt_timer, SIGNAL(timeout()), SLOT(checkInterrupt()) ) );
+}
+
+HeadlessSession::~HeadlessSession()
+{
+    stop();
+    delete capture;
+}
+
+bool HeadlessSession::start(const AppCommandLineParams &params)
+{
+    // edit/display mode lists of the command line map 1:1 to converter collections
+    static const int conv_of_inmode[__INMODES_CNT] =
+    {
+        QStrBinConvCollection::CONV_HEX,
+        QStrBinConvCollection::CONV_ASCII,
+        QStrBinConvCollection::CONV_CSTR
+    };
+    static const int conv_of_outmode[__OUTMODES_CNT] =
+    {
+        QBinStrConvCollection::CONV_HEX,
+        QBinStrConvCollection::CONV_ASCII,
+        QBinStrConvCollection::CONV_CSTR
+    };
+    SerialSetupDialog::PortSettings settings = SerialSetupDialog::DefaultSettings;
+    int                             inmode   = params.editMode;
+
+    if (!params.selPort)
+    {
+        fail("Headless mode requires port name (-p)");
+        return false;
+    }
+
+    if (inmode < 0 || inmode >= __INMODES_CNT) inmode = INMODE_HEX;
+    input_conv = QStrBinConvCollection::getConv(conv_of_inmode[inmode]);
+
+    // Data goes to stdout unless only a capture was asked for
+    if (params.displayMode >= 0 || !params.logFileName)
+    {
+        int outmode = (params.displayMode >= 0 && params.displayMode < __OUTMODES_CNT) ? params.displayMode : OUTMODE_HEX;
+        display_conv = QBinStrConvCollection::getConv(conv_of_outmode[outmode]);
+        hex_output   = (outmode == OUTMODE_HEX);
+        out.open(stdout, QIODevice::WriteOnly);
+    }
+
+    if (params.scriptFileName && !loadScript(QString(params.scriptFileName)))
+    {
+        return false;
+    }
+
+    if (params.logFileName)
+    {
+        QString name = (params.logFileName == CONF_MARK_USE_DEFAULT_STR)
+                ? QString("%1_%2.cap").arg(QCoreApplication::applicationName(), QDateTime::currentDateTime().toString("yyyy-MM-dd_hh.mm.ss.zzz"))
+                : QString(params.logFileName);
+
+        capture = new CaptureLogWriter();
+        if (!capture->open(name))
+        {
+            fail(QString("Failed to create log file: %1. %2").arg(name, capture->errorString()));
+            return false;
+        }
+        fprintf(stderr, "Capturing to %s\n", name.toLocal8Bit().constData());
+    }
+
+    // Same settings as the GUI uses, baud rate may be overridden
+    appconfig->beginGroup("PortSettings");
+    SerialSetupDialog::updateConfig(CONF_OP_READ, settings);
+    appconfig->endGroup();
+    if (params.baudRate > 0) settings.BaudRate = params.baudRate;
+
+    port = new SerialPortEngine(this);
+    rx   = new RxAccumulator(this);
+    ASSERT_ALWAYS( connect(port, SIGNAL(readyRead()), SLOT(onReadyRead()) ) );
+    ASSERT_ALWAYS( connect(port, SIGNAL(error(QSerialPort::SerialPortError)), SLOT(onSerialPortError(QSerialPort::SerialPortError)) ) );
+    ASSERT_ALWAYS( connect(port, SIGNAL(bytesWritten(qint64)), SLOT(onBytesWritten(qint64)) ) );
+    ASSERT_ALWAYS( connect(rx,   SIGNAL(frameReady(QByteArray,int,qint64,qint64)), SLOT(onRxFrameReady(QByteArray,int,qint64,qint64)) ) );
+
+    port->setPortName(QString(params.selPort));
+    if (!port->open(QIODevice::ReadWrite))
+    {
+        fail(QString("Cannot open port: %1. Error: %2").arg(port->portName(), port->errorString()));
+        return false;
+    }
+    QStringList rejected = port->setSettings(settings);
+    if (!rejected.isEmpty())
+        fprintf(stderr, "Port settings not applied: %s\n", qPrintable(rejected.join(", ")));
+    fprintf(stderr, "Opened %s, %d bd\n", params.selPort, static_cast<int>(settings.BaudRate));
+
+    signal(SIGINT,  onInterruptSignal);
+    signal(SIGTERM, onInterruptSignal);
+    interrupt_timer.start(INTERRUPT_INTERVAL);
+
+    if (params.runTime > 0)
+    {
+        QTimer::singleShot(params.runTime * 1000, this, SLOT(stop()));
+    }
+
+    if (params.sendPayload) script.prepend(QString(params.sendPayload));
+    if (!script.isEmpty()) script_timer.start(0);
+
+    return true;
+}
+
+void HeadlessSession::stop()
+{
+    if (stopped) return;
+    stopped = true;
+
+    script_timer.stop();
+    interrupt_timer.stop();
+
+    if (port && port->isOpen())
+    {
+        port->close();
+        onReadyRead();      // tail of the data drained by close()
+    }
+    if (rx) rx->flush();
+    if (out.isOpen()) out.flush();
+
+    if (capture)
+    {
+        CaptureLogWriter::Stats st = capture->stats();
+        capture->close();
+        if (st.dropped_records || st.write_error)
+        {
+            fail(QString("Log file incomplete: %1 records dropped. %2").arg(st.dropped_records).arg(capture->errorString()));
+        }
+    }
+
+    QCoreApplication::exit(exit_code);
+}
+
+bool HeadlessSession::loadScript(const QString &file_name)
+{
+    QFile file(file_name);
+
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        fail(QString("Cannot open script %1: %2").arg(file_name, file.errorString()));
+        return false;
+    }
+
+    QTextStream stream(&file);
+    while (!stream.atEnd())
+    {
+        script.append(stream.readLine());
+    }
+    return true;
+}
+
+void HeadlessSession::runScript()
+{
+    while (!stopped && script_pos < script.size())
+    {
+        QString line = script.at(script_pos);
+        QString cmd  = line.trimmed();
+
+        if (cmd.isEmpty() || cmd.startsWith('#'))
+        {
+            script_pos++;
+        }
+        else if (cmd.startsWith("@sleep", Qt::CaseInsensitive))
+        {
+            script_pos++;
+            script_timer.start( qMax(cmd.mid(6).trimmed().toInt(), 0) );
+            return;
+        }
+        else if (cmd.compare("@quit", Qt::CaseInsensitive) == 0)
+        {
+            quit();
+            return;
+        }
+        else if (send(line, script_pos))
+        {
+            script_pos++;
+        }
+        else
+        {
+            if (!stopped) script_timer.start(RETRY_INTERVAL);
+            return;
+        }
+    }
+}
+
+bool HeadlessSession::send(const QString &payload, int line)
+{
+    QString    str = payload;
+    QByteArray buf;
+    int        fail_pos = -1;
+
+    if (input_conv->convert(str, &buf, &fail_pos) != QStrBinConv::VALID)
+    {
+        fail(QString("Invalid payload (line %1, column %2): %3").arg(line + 1).arg(fail_pos + 1).arg(payload));
+        stop();
+        return false;
+    }
+    if (buf.isEmpty()) return true;
+    if (port->write(buf) != buf.size()) return false;
+
+    if (capture) capture->write(OutputRecordStore::REC_TX, buf.constData(), buf.size());
+    return true;
+}
+
+void HeadlessSession::onReadyRead()
+{
+    const char* ptr;
+    int         len;
+    qint64      time;
+
+    while ( (len = port->peekChunk(&ptr, &time)) > 0 )
+    {
+        rx->append(ptr, len, time);
+        port->consume(len);
+    }
+}
+
+void HeadlessSession::onRxFrameReady(const QByteArray &data, int chunks, qint64 time_ns, qint64 gap_ns)
+{
+    (void) chunks;
+    (void) gap_ns;
+
+    // dropped records are reported once at the end, see stop()
+    if (capture) capture->write(OutputRecordStore::REC_RX, data.constData(), data.size(), capture->timestampAt(time_ns));
+    if (display_conv)
+    {
+        QByteArray frame = data;
+        QByteArray text  = display_conv->convert(frame, QBinStrConv::PLAIN_TEXT).toLocal8Bit();
+
+        if (hex_output && !text.endsWith('\n')) text.append('\n');
+        out.write(text);
+        out.flush();
+    }
+}
+
+void HeadlessSession::onSerialPortError(QSerialPort::SerialPortError error)
+{
+    if (error == QSerialPort::NoError) return;
+
+    fail(QString("Serial port error %1: %2").arg(static_cast<int>(error)).arg(port->errorString()));
+    if (error == QSerialPort::ResourceError) stop();  // device removed
+}
+
+void HeadlessSession::quit()
+{
+    // close() drops whatever is still queued, payloads before @quit must go out first
+    quitting = true;
+    script_timer.stop();
+    if (port->txDone() >= port->txWritten()) stop();
+}
+
+void HeadlessSession::onBytesWritten(qint64 bytes)
+{
+    (void) bytes;
+    if (quitting && port->txDone() >= port->txWritten()) stop();
+}
+
+void HeadlessSession::checkInterrupt()
+{
+    if (interrupted) stop();
+}
+
+void HeadlessSession::fail(const QString &msg)
+{
+    fprintf(stderr, "Error: %s\n", msg.toLocal8Bit().constData());
+    exit_code = -1;
+}
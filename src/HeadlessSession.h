@@ -0,0 +1,98 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Command line capture/replay session, no GUI
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#ifndef HEADLESSSESSION_H
+#define HEADLESSSESSION_H
+
+#include <QObject>
+#include <QFile>
+#include <QTimer>
+#include <QStringList>
+
+#include "QSerialPort"
+
+class SerialPortEngine;
+class RxAccumulator;
+class CaptureLogWriter;
+class QBinStrConv;
+class QStrBinConv;
+class AppCommandLineParams;
+
+// ******************************************************************************** C L A S S:  HeadlessSession
+/**
+ * Runs the port the way the GUI does (same I/O engine, accumulator and
+ * capture log) but with QCoreApplication only. Received data goes to stdout
+ * formatted by the display converter and/or to a binary capture; status
+ * and errors go to stderr.
+ *
+ * Payloads come from --send and from a script file, one command per line:
+ *   <payload>      sent as one packet, written in the edit mode format
+ *   @sleep <ms>    pause
+ *   @quit          stop the session once everything written has been sent
+ *   # ...          comment, empty lines are skipped
+ */
+class HeadlessSession : public QObject
+{
+    Q_OBJECT
+public:
+    enum {
+        RETRY_INTERVAL     = 10,      /* ms, transmit queue full */
+        INTERRUPT_INTERVAL = 100      /* ms, SIGINT/SIGTERM polling */
+    };
+
+    explicit HeadlessSession(QObject* parent = 0);
+    ~HeadlessSession();
+
+    /** Opens the port and starts the script; on failure the error is already reported */
+    bool    start(const AppCommandLineParams& params);
+    int     exitCode() const          { return exit_code; }
+
+public slots:
+    void    stop();
+
+private slots:
+    void    onReadyRead();
+    void    onRxFrameReady(const QByteArray& data, int chunks, qint64 time_ns, qint64 gap_ns);
+    void    onSerialPortError(QSerialPort::SerialPortError error);
+    void    onBytesWritten(qint64 bytes);
+    void    runScript();
+    void    checkInterrupt();
+
+private:
+    Q_DISABLE_COPY(HeadlessSession)
+
+    bool    loadScript(const QString& file_name);
+    /** @quit - stops the session when the transmit queue is empty */
+    void    quit();
+    /** Returns false if the payload was not queued yet (queue full) */
+    bool    send(const QString& payload, int line);
+    void    fail(const QString& msg);
+
+    SerialPortEngine* port;
+    RxAccumulator*    rx;
+    CaptureLogWriter* capture;
+    QBinStrConv*      display_conv;     /* NULL - nothing written to stdout */
+    QStrBinConv*      input_conv;
+    bool              hex_output;       /* line oriented output, each frame ends with a new line */
+    QFile             out;
+    QStringList       script;
+    int               script_pos;
+    QTimer            script_timer;
+    QTimer            interrupt_timer;
+    int               exit_code;
+    bool              quitting;         /* @quit seen, waiting for the queued data to be sent */
+    bool              stopped;
+};
+
+#endif // HEADLESSSESSION_H
@@ -0,0 +1,415 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Lookup tables and row writers of the hex dump formatter
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <wctype.h>
+
+#include "HexDumpEngine.h"
+#include "HexKernels.h"
+
+//======================================================= Lookup tables
+
+namespace {
+
+struct HtmlEntity
+{
+    unsigned char len;
+    char          str[7];
+};
+
+struct HexDumpTables
+{
+    char       hex_pair[256][2];   /* "00".."FF" */
+    char       plain_ascii[256];   /* control characters replaced by '.' */
+    HtmlEntity html_ascii[256];    /* escaped form of plain_ascii */
+
+    HexDumpTables()
+    {
+        static const char digits[] = "0123456789ABCDEF";
+        for (int c = 0; c < 256; c++)
+        {
+            hex_pair[c][0] = digits[c >> 4];
+            hex_pair[c][1] = digits[c & 0xF];
+
+            plain_ascii[c] = ( c < 0x20 || c == 0x7F ) ? '.' : static_cast<char>(c);
+
+            HtmlEntity& e = html_ascii[c];
+            switch (plain_ascii[c])
+            {
+            case ' ': setEntity(e, "&nbsp;"); break;
+            case '&': setEntity(e, "&amp;");  break;
+            case '<': setEntity(e, "&lt;");   break;
+            case '>': setEntity(e, "&gt;");   break;
+            case '"': setEntity(e, "&quot;"); break;
+            default:
+                if (c < 0x80)
+                {
+                    e.len = 1;
+                    e.str[0] = plain_ascii[c];
+                }
+                else
+                {
+                    // Put as hex, so it does not depend on document encoding
+                    setEntity(e, "&#xFF;");
+                    e.str[3] = hex_pair[c][0];
+                    e.str[4] = hex_pair[c][1];
+                }
+            }
+        }
+    }
+
+    static void setEntity(HtmlEntity& e, const char* s)
+    {
+        e.len = static_cast<unsigned char>( strlen(s) );
+        memcpy(e.str, s, e.len);
+    }
+};
+
+const HexDumpTables tables;
+
+enum {
+    HTML_MAX_ENTITY = 6     /* longest html_ascii[] entry */
+};
+
+const char   html_head[] = "<pre>";
+const char   html_tail[] = "</pre>";
+const char   col_sep[]   = "  ";
+
+template <typename CharT>
+inline CharT* put(CharT* out, const char* str, unsigned len)
+{
+    while (len--) *out++ = static_cast<unsigned char>(*str++);
+    return out;
+}
+
+template <typename CharT>
+inline CharT* fill(CharT* out, char c, unsigned cnt)
+{
+    while (cnt--) *out++ = c;
+    return out;
+}
+
+inline unsigned digitsCnt(unsigned long val, unsigned base)
+{
+    unsigned cnt = 1;
+    while (val >= base) { val /= base; cnt++; }
+    return cnt;
+}
+
+} // namespace
+
+
+//======================================================= HexDumpEngine
+
+HexDumpEngine::HexDumpEngine(const HexDumpFormat &fmt, unsigned long address, unsigned long size)
+    : f(fmt)
+    , address(address)
+    , size(size)
+    , addrw(fmt.addrWidth)
+{
+    unsigned long cnt;
+
+    if (f.wordSize != 2 && f.wordSize != 4 && f.wordSize != 8) f.wordSize = 1;
+
+    // Calculate address size
+    if (!addrw)
+    {
+        if ( f.addrMode == HexDumpFormat::ADDR_DEC )
+        {
+            addrw=1;
+            for (cnt=address+size;cnt;cnt/=10) addrw++;
+        }
+        else if ( f.addrMode == HexDumpFormat::ADDR_HEX )
+        {
+            addrw=0;
+            for (cnt=address+size;cnt;cnt/=16) addrw++;
+            // align to 2, 4, 8, 16, ...
+            for (cnt=2; addrw>cnt; cnt<<=1) ;
+            addrw = cnt;
+        }
+    }
+
+    // Calculate record size in words
+    recw = f.recSize;
+    if (recw > MAX_REC) recw = MAX_REC;
+    recw /= f.wordSize;
+    if (!recw) recw = 1;
+
+    hexw  = recw*(f.wordSize*2+1)-1;
+    words = size / f.wordSize;      /* only complete words */
+
+    ascii_col = f.showAscii && ( f.wordSize == 1 || f.wordSize == sizeof(wchar_t) );
+
+    if (f.html)
+    {
+        makeTag(addr_pre, &addr_pre_len,  "</b><font color=\"%s\">", f.addrColor);
+        makeTag(addr_post,&addr_post_len, ":</font></b>", NULL);
+        makeTag(hex_pre,  &hex_pre_len,   "<font color=\"%s\">", f.bodyColor);
+        makeTag(hex_post, &hex_post_len,  "</font>", NULL);
+        makeTag(asc_pre,  &asc_pre_len,   "<font color=\"%s\"><code>", f.suppColor);
+        makeTag(asc_post, &asc_post_len,  "</code></font>", NULL);
+    }
+    else
+    {
+        addr_pre_len = hex_pre_len = hex_post_len = asc_pre_len = asc_post_len = 0;
+        makeTag(addr_post,&addr_post_len, ":", NULL);
+    }
+
+    out_size = calcSize();
+}
+
+void HexDumpEngine::makeTag(char *tag, unsigned *len, const char *fmt, const char *color)
+{
+    int n = snprintf(tag, MAX_TAG, fmt, color ? color : "");
+    if (n < 0) n = 0;
+    if (n >= MAX_TAG) n = MAX_TAG-1;
+    *len = static_cast<unsigned>(n);
+}
+
+size_t HexDumpEngine::calcSize() const
+{
+    size_t        total = 0;
+    unsigned long lines = (words + recw - 1) / recw;
+    unsigned      last  = static_cast<unsigned>( words - (lines ? (lines-1)*recw : 0) );
+
+    if (f.html) total += sizeof(html_head)-1 + sizeof(html_tail)-1;
+    if (!lines) return total;
+
+    // fixed part of every line
+    size_t   line = 1; /* eol */
+    bool     sep  = false;
+
+    if (f.addrMode != HexDumpFormat::ADDR_NONE)
+    {
+        line += addr_pre_len + addr_post_len;
+        sep = true;
+    }
+    if (f.showHex)
+    {
+        if (sep) line += sizeof(col_sep)-1;
+        line += hex_pre_len + hex_post_len;
+        sep = true;
+    }
+    if (ascii_col)
+    {
+        if (sep) line += sizeof(col_sep)-1;
+        line += asc_pre_len + asc_post_len;
+    }
+    total += line * lines;
+
+    // hex column: padded to full width only when ascii column is requested
+    if (f.showHex)
+    {
+        unsigned lastw = last*(f.wordSize*2+1)-1;
+        total += static_cast<size_t>(hexw) * (lines-1) + ( f.showAscii ? hexw : lastw );
+    }
+
+    // ascii column: padded in plain text, escaped (at most HTML_MAX_ENTITY) in HTML
+    if (ascii_col)
+    {
+        if (f.html)
+            total += static_cast<size_t>(words) * HTML_MAX_ENTITY;
+        else
+            total += static_cast<size_t>(recw) * lines;
+    }
+
+    // address column: width grows only if the number does not fit into addrw
+    if (f.addrMode != HexDumpFormat::ADDR_NONE)
+    {
+        unsigned      base = (f.addrMode == HexDumpFormat::ADDR_DEC) ? 10 : 16;
+        unsigned long step = static_cast<unsigned long>(recw) * f.wordSize;
+        unsigned long last_addr = address + (lines-1)*step;
+
+        if ( digitsCnt(last_addr, base) <= addrw )
+        {
+            total += static_cast<size_t>(addrw) * lines;
+        }
+        else
+        {
+            unsigned long a = address;
+            for (unsigned long l = 0; l < lines; l++, a += step)
+            {
+                unsigned d = digitsCnt(a, base);
+                total += (d > addrw) ? d : addrw;
+            }
+        }
+    }
+
+    return total;
+}
+
+template <typename CharT>
+CharT* HexDumpEngine::putAddr(CharT *out, unsigned long addr) const
+{
+    CharT    tmp[24];
+    unsigned len = 0;
+
+    if (f.addrMode == HexDumpFormat::ADDR_DEC)
+    {
+        do { tmp[len++] = '0' + static_cast<char>(addr % 10); addr /= 10; } while (addr);
+        if (len < addrw) out = fill(out, ' ', addrw - len);
+    }
+    else
+    {
+        static const char digits[] = "0123456789abcdef";
+        do { tmp[len++] = digits[addr & 0xF]; addr >>= 4; } while (addr);
+        if (len < addrw) out = fill(out, '0', addrw - len);
+    }
+    while (len) *out++ = tmp[--len];
+
+    return out;
+}
+
+template <typename CharT>
+CharT* HexDumpEngine::putAsciiWide(CharT *out, const unsigned char *ptr, unsigned cnt) const
+{
+    const unsigned long max_char = (sizeof(CharT) == 1) ? 0xFFUL : 0xFFFFUL;
+    wchar_t             wc;
+
+    while (cnt--)
+    {
+        memcpy(&wc, ptr, sizeof(wc));
+        ptr += sizeof(wc);
+
+        if ( iswcntrl(wc) || static_cast<unsigned long>(wc) > max_char )
+        {
+            *out++ = '.';
+        }
+        else if ( f.html && static_cast<unsigned long>(wc) < 0x80 )
+        {
+            const HtmlEntity& e = tables.html_ascii[wc];
+            out = put(out, e.str, e.len);
+        }
+        else
+        {
+            *out++ = static_cast<CharT>(wc);
+        }
+    }
+    return out;
+}
+
+template <typename CharT>
+size_t HexDumpEngine::formatT(const unsigned char *buf, CharT *out) const
+{
+    CharT* const        start = out;
+    const unsigned      ws    = f.wordSize;
+    unsigned long       addr  = address;
+    unsigned long       left  = words;
+    unsigned            r, cnt, b;
+    bool                sep;
+
+    if (f.html) out = put(out, html_head, sizeof(html_head)-1);
+
+    while (left)
+    {
+        r   = (left > recw) ? recw : static_cast<unsigned>(left);
+        sep = false;
+
+        // Address field
+        if (f.addrMode != HexDumpFormat::ADDR_NONE)
+        {
+            out = put(out, addr_pre, addr_pre_len);
+            out = putAddr(out, addr);
+            out = put(out, addr_post, addr_post_len);
+            sep = true;
+        }
+
+        // Hex field
+        if (f.showHex)
+        {
+            const unsigned char* ptr = buf;
+
+            if (sep) out = put(out, col_sep, sizeof(col_sep)-1);
+            out = put(out, hex_pre, hex_pre_len);
+            if (ws == 1)
+            {
+                // bulk path, vectorized where available
+                out = HexKernels::encodeSpaced(ptr, r, out);
+            }
+            else for (cnt = r; cnt; cnt--)
+            {
+                if (f.bigEndian)
+                {
+                    for (b = 0; b < ws; b++)
+                    {
+                        *out++ = tables.hex_pair[ptr[b]][0];
+                        *out++ = tables.hex_pair[ptr[b]][1];
+                    }
+                }
+                else
+                {
+                    for (b = ws; b--; )
+                    {
+                        *out++ = tables.hex_pair[ptr[b]][0];
+                        *out++ = tables.hex_pair[ptr[b]][1];
+                    }
+                }
+                ptr += ws;
+                if (cnt > 1) *out++ = ' ';
+            }
+            if (f.showAscii) out = fill(out, ' ', hexw - (r*(ws*2+1)-1));
+            out = put(out, hex_post, hex_post_len);
+            sep = true;
+        }
+
+        // Ascii field
+        if (ascii_col)
+        {
+            if (sep) out = put(out, col_sep, sizeof(col_sep)-1);
+            out = put(out, asc_pre, asc_pre_len);
+            if (ws == 1)
+            {
+                if (f.html)
+                {
+                    for (cnt = 0; cnt < r; cnt++)
+                    {
+                        const HtmlEntity& e = tables.html_ascii[buf[cnt]];
+                        out = put(out, e.str, e.len);
+                    }
+                }
+                else
+                {
+                    for (cnt = 0; cnt < r; cnt++) *out++ = static_cast<unsigned char>( tables.plain_ascii[buf[cnt]] );
+                }
+            }
+            else
+            {
+                out = putAsciiWide(out, buf, r);
+            }
+            if (!f.html) out = fill(out, ' ', recw - r);
+            out = put(out, asc_post, asc_post_len);
+        }
+
+        *out++ = '\n';
+
+        buf  += r*ws;
+        addr += r*ws;
+        left -= r;
+    }
+
+    if (f.html) out = put(out, html_tail, sizeof(html_tail)-1);
+
+    return static_cast<size_t>(out - start);
+}
+
+size_t HexDumpEngine::format(const unsigned char *buf, char *out) const
+{
+    return formatT(buf, out);
+}
+
+size_t HexDumpEngine::format(const unsigned char *buf, uint16_t *out) const
+{
+    return formatT(buf, out);
+}
@@ -0,0 +1,114 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Allocation-free, table driven hex dump formatter
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#ifndef HEXDUMPENGINE_H
+#define HEXDUMPENGINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ******************************************************************************** S T R U C T:  HexDumpFormat
+struct HexDumpFormat
+{
+    enum AddrMode {
+        ADDR_NONE,
+        ADDR_HEX,
+        ADDR_DEC
+    };
+
+    AddrMode    addrMode;
+    unsigned    addrWidth;      /* 0 - calculated automatically */
+    unsigned    recSize;        /* bytes per line */
+    unsigned    wordSize;       /* 1, 2, 4 or 8 */
+    bool        bigEndian;
+    bool        showHex;
+    bool        showAscii;
+    bool        html;
+    const char* addrColor;      /* used only if html is set */
+    const char* bodyColor;
+    const char* suppColor;
+
+    HexDumpFormat()
+        : addrMode(ADDR_HEX)
+        , addrWidth(0)
+        , recSize(16)
+        , wordSize(1)
+        , bigEndian(false)
+        , showHex(true)
+        , showAscii(true)
+        , html(false)
+        , addrColor("blue")
+        , bodyColor("black")
+        , suppColor("teal")
+    {}
+};
+
+// ******************************************************************************** C L A S S:  HexDumpEngine
+/**
+ * Formats binary data as address / hex / ascii lines directly into caller
+ * provided memory. Output size is computed up front in the constructor:
+ * it is exact for plain text, and a tight upper bound for HTML (escaping
+ * of the ascii column depends on data), so a single allocation is always
+ * enough. format() returns the number of characters actually written.
+ *
+ * Output is produced either as Latin-1 (char) or UTF-16 (uint16_t, layout
+ * compatible with QChar), so QString can be filled without conversion.
+ */
+class HexDumpEngine
+{
+public:
+    enum {
+        MAX_REC  = 256,
+        MAX_TAG  = 80
+    };
+
+    HexDumpEngine(const HexDumpFormat& fmt, unsigned long address, unsigned long size);
+
+    size_t outputSize() const { return out_size; }
+    unsigned addressWidth() const { return addrw; }
+    unsigned bytesPerLine() const { return recw * f.wordSize; }
+    unsigned long lines() const { return (words + recw - 1) / recw; }
+    unsigned hexWidth() const { return hexw; }
+    bool asciiColumn() const { return ascii_col; }
+
+    size_t format(const unsigned char* buf, char* out) const;
+    size_t format(const unsigned char* buf, uint16_t* out) const;
+
+private:
+    template <typename CharT> size_t formatT(const unsigned char* buf, CharT* out) const;
+    template <typename CharT> CharT* putAddr(CharT* out, unsigned long addr) const;
+    template <typename CharT> CharT* putAsciiWide(CharT* out, const unsigned char* ptr, unsigned cnt) const;
+
+    size_t calcSize() const;
+    static void makeTag(char* tag, unsigned* len, const char* fmt, const char* color);
+
+    HexDumpFormat  f;
+    unsigned long  address;
+    unsigned long  size;
+    unsigned       addrw;
+    unsigned       recw;        /* words per line */
+    unsigned       hexw;        /* hex column width (chars) */
+    unsigned long  words;
+    size_t         out_size;
+    bool           ascii_col;   /* ascii column really printed */
+
+    char           addr_pre[MAX_TAG], addr_post[MAX_TAG];
+    char           hex_pre[MAX_TAG],  hex_post[MAX_TAG];
+    char           asc_pre[MAX_TAG],  asc_post[MAX_TAG];
+    unsigned       addr_pre_len, addr_post_len;
+    unsigned       hex_pre_len,  hex_post_len;
+    unsigned       asc_pre_len,  asc_post_len;
+};
+
+#endif // HEXDUMPENGINE_H
@@ -0,0 +1,468 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Scalar, SSSE3 and AVX2 hex kernels and their runtime selection
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#include "HexKernels.h"
+
+#if ( defined(__GNUC__) || defined(__clang__) ) && ( defined(__x86_64__) || defined(__i386__) )
+#  define HEXKERNELS_X86 1
+#  include <immintrin.h>
+#  define TARGET(_isa_) __attribute__((target(_isa_)))
+#endif
+
+using namespace HexKernels;
+
+//======================================================= Scalar kernels
+
+namespace {
+
+const char hex_digits[] = "0123456789ABCDEF";
+
+struct NibbleTable
+{
+    uint8_t val[128];      /* 0xFF - not a hex digit */
+    NibbleTable()
+    {
+        for (int c = 0; c < 128; c++)
+        {
+            if      (c >= '0' && c <= '9') val[c] = static_cast<uint8_t>(c - '0');
+            else if (c >= 'A' && c <= 'F') val[c] = static_cast<uint8_t>(c - 'A' + 10);
+            else if (c >= 'a' && c <= 'f') val[c] = static_cast<uint8_t>(c - 'a' + 10);
+            else                           val[c] = 0xFF;
+        }
+    }
+};
+
+const NibbleTable nibbles;
+
+inline bool isHexDigit(uint16_t c) { return c < 128 && nibbles.val[c] != 0xFF; }
+inline uint8_t nibble(uint16_t c)  { return nibbles.val[c]; }
+
+template <typename CharT>
+CharT* encodeSpacedScalar(const uint8_t* in, size_t n, CharT* out)
+{
+    while (n)
+    {
+        *out++ = hex_digits[*in >> 4];
+        *out++ = hex_digits[*in & 0xF];
+        in++;
+        if (--n) *out++ = ' ';
+    }
+    return out;
+}
+
+size_t scanDigitsScalar(const uint16_t* in, size_t n)
+{
+    size_t i = 0;
+    while (i < n && isHexDigit(in[i])) i++;
+    return i;
+}
+
+void decodePairsScalar(const uint16_t* in, size_t npairs, uint8_t* out)
+{
+    while (npairs--)
+    {
+        *out++ = static_cast<uint8_t>( (nibble(in[0]) << 4) | nibble(in[1]) );
+        in += 2;
+    }
+}
+
+size_t decodeSpacedPairsScalar(const uint16_t* in, size_t n, uint8_t* out)
+{
+    size_t groups = 0;
+    while ( n >= 3 && isHexDigit(in[0]) && isHexDigit(in[1]) && in[2] == ' ' )
+    {
+        *out++ = static_cast<uint8_t>( (nibble(in[0]) << 4) | nibble(in[1]) );
+        in += 3; n -= 3; groups++;
+    }
+    return groups;
+}
+
+} // namespace
+
+//======================================================= SSE2 / SSSE3 kernels
+#ifdef HEXKERNELS_X86
+namespace {
+
+#define Z  ((char)0x80)     /* pshufb: zero the lane */
+
+/* 16 bytes -> 48 characters "XX XX .. XX " (with trailing space) */
+TARGET("ssse3")
+inline void encode16Ssse3(const uint8_t* in, __m128i* r0, __m128i* r1, __m128i* r2)
+{
+    const __m128i lut = _mm_setr_epi8('0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F');
+    const __m128i m0f = _mm_set1_epi8(0x0F);
+
+    __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    __m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(v, 4), m0f));
+    __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(v, m0f));
+    __m128i a  = _mm_unpacklo_epi8(hi, lo);     /* digit pairs of bytes 0..7  */
+    __m128i b  = _mm_unpackhi_epi8(hi, lo);     /* digit pairs of bytes 8..15 */
+
+    *r0 = _mm_or_si128( _mm_shuffle_epi8(a, _mm_setr_epi8( 0, 1, Z, 2, 3, Z, 4, 5, Z, 6, 7, Z, 8, 9, Z,10)),
+                        _mm_setr_epi8( 0, 0,' ', 0, 0,' ', 0, 0,' ', 0, 0,' ', 0, 0,' ', 0) );
+    *r1 = _mm_or_si128( _mm_or_si128(
+                        _mm_shuffle_epi8(a, _mm_setr_epi8(11, Z,12,13, Z,14,15, Z, Z, Z, Z, Z, Z, Z, Z, Z)),
+                        _mm_shuffle_epi8(b, _mm_setr_epi8( Z, Z, Z, Z, Z, Z, Z, Z, 0, 1, Z, 2, 3, Z, 4, 5)) ),
+                        _mm_setr_epi8( 0,' ', 0, 0,' ', 0, 0,' ', 0, 0,' ', 0, 0,' ', 0, 0) );
+    *r2 = _mm_or_si128( _mm_shuffle_epi8(b, _mm_setr_epi8( Z, 6, 7, Z, 8, 9, Z,10,11, Z,12,13, Z,14,15, Z)),
+                        _mm_setr_epi8(' ', 0, 0,' ', 0, 0,' ', 0, 0,' ', 0, 0,' ', 0, 0,' ') );
+}
+
+TARGET("ssse3")
+char* encodeSpacedSsse3(const uint8_t* in, size_t n, char* out)
+{
+    __m128i r0, r1, r2;
+    while (n > 16) /* last byte must not be followed by a space - leave it for scalar tail */
+    {
+        encode16Ssse3(in, &r0, &r1, &r2);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out),    r0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out+16), r1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out+32), r2);
+        in += 16; n -= 16; out += 48;
+    }
+    return encodeSpacedScalar(in, n, out);
+}
+
+TARGET("ssse3")
+inline void storeWide(uint16_t* out, __m128i r)
+{
+    const __m128i zero = _mm_setzero_si128();
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out),   _mm_unpacklo_epi8(r, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out+8), _mm_unpackhi_epi8(r, zero));
+}
+
+TARGET("ssse3")
+uint16_t* encodeSpacedWideSsse3(const uint8_t* in, size_t n, uint16_t* out)
+{
+    __m128i r0, r1, r2;
+    while (n > 16)
+    {
+        encode16Ssse3(in, &r0, &r1, &r2);
+        storeWide(out,    r0);
+        storeWide(out+16, r1);
+        storeWide(out+32, r2);
+        in += 16; n -= 16; out += 48;
+    }
+    return encodeSpacedScalar(in, n, out);
+}
+
+/* 0xFFFF in lanes holding [0-9A-Fa-f] */
+TARGET("sse2")
+inline __m128i isHex8(__m128i c)
+{
+    __m128i d = _mm_and_si128( _mm_cmpgt_epi16(c, _mm_set1_epi16('0'-1)), _mm_cmplt_epi16(c, _mm_set1_epi16('9'+1)) );
+    __m128i l = _mm_or_si128(c, _mm_set1_epi16(0x20));
+    __m128i a = _mm_and_si128( _mm_cmpgt_epi16(l, _mm_set1_epi16('a'-1)), _mm_cmplt_epi16(l, _mm_set1_epi16('f'+1)) );
+    return _mm_or_si128(d, a);
+}
+
+/* nibble value of (valid) hex digits: (c & 0xF) + 9 * bit6(c) */
+TARGET("sse2")
+inline __m128i nibbles8(__m128i c)
+{
+    __m128i t = _mm_and_si128(_mm_srli_epi16(c, 6), _mm_set1_epi16(1));
+    return _mm_add_epi16( _mm_and_si128(c, _mm_set1_epi16(0x0F)),
+                          _mm_add_epi16(_mm_slli_epi16(t, 3), t) );
+}
+
+TARGET("sse2")
+size_t scanDigitsSse2(const uint16_t* in, size_t n)
+{
+    size_t i = 0;
+    while (i + 8 <= n)
+    {
+        unsigned m = static_cast<unsigned>( _mm_movemask_epi8( isHex8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in+i))) ) );
+        if (m != 0xFFFF) return i + __builtin_ctz(~m) / 2;
+        i += 8;
+    }
+    return i + scanDigitsScalar(in+i, n-i);
+}
+
+TARGET("sse2")
+void decodePairsSse2(const uint16_t* in, size_t npairs, uint8_t* out)
+{
+    const __m128i lo_mask = _mm_set1_epi16(0x00FF);
+    while (npairs >= 8)
+    {
+        __m128i n0 = nibbles8( _mm_loadu_si128(reinterpret_cast<const __m128i*>(in)) );
+        __m128i n1 = nibbles8( _mm_loadu_si128(reinterpret_cast<const __m128i*>(in+8)) );
+        __m128i p  = _mm_packus_epi16(n0, n1);   /* 16 nibbles, in order */
+        __m128i x  = _mm_or_si128( _mm_slli_epi16(_mm_and_si128(p, lo_mask), 4), _mm_srli_epi16(p, 8) );
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(x, x));
+        in += 16; npairs -= 8; out += 8;
+    }
+    decodePairsScalar(in, npairs, out);
+}
+
+TARGET("sse2")
+size_t decodeSpacedPairsSse2(const uint16_t* in, size_t n, uint8_t* out)
+{
+    /* 8 groups = 24 characters; spaces expected at 2,5,8,11,14,17,20,23 */
+    const __m128i e0 = _mm_setr_epi16(0,0,-1,0,0,-1,0,0);
+    const __m128i e1 = _mm_setr_epi16(-1,0,0,-1,0,0,-1,0);
+    const __m128i e2 = _mm_setr_epi16(0,-1,0,0,-1,0,0,-1);
+    const __m128i sp = _mm_set1_epi16(' ');
+    size_t        groups = 0;
+    uint16_t      nib[24];
+
+    while (n >= 24)
+    {
+        __m128i c0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+        __m128i c1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in+8));
+        __m128i c2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in+16));
+
+        __m128i ok0 = _mm_or_si128( _mm_and_si128(e0, _mm_cmpeq_epi16(c0, sp)), _mm_andnot_si128(e0, isHex8(c0)) );
+        __m128i ok1 = _mm_or_si128( _mm_and_si128(e1, _mm_cmpeq_epi16(c1, sp)), _mm_andnot_si128(e1, isHex8(c1)) );
+        __m128i ok2 = _mm_or_si128( _mm_and_si128(e2, _mm_cmpeq_epi16(c2, sp)), _mm_andnot_si128(e2, isHex8(c2)) );
+        if ( _mm_movemask_epi8( _mm_and_si128(ok0, _mm_and_si128(ok1, ok2)) ) != 0xFFFF ) break;
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(nib),    nibbles8(c0));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(nib+8),  nibbles8(c1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(nib+16), nibbles8(c2));
+        for (int g = 0; g < 8; g++)
+        {
+            out[g] = static_cast<uint8_t>( (nib[3*g] << 4) | nib[3*g+1] );
+        }
+
+        in += 24; n -= 24; out += 8; groups += 8;
+    }
+    return groups + decodeSpacedPairsScalar(in, n, out);
+}
+
+//======================================================= AVX2 kernels
+
+TARGET("avx2")
+inline void encode32Avx2(const uint8_t* in, __m256i* r0, __m256i* r1, __m256i* r2)
+{
+    const __m256i lut = _mm256_setr_epi8('0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F',
+                                         '0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F');
+    const __m256i m0f = _mm256_set1_epi8(0x0F);
+
+    __m256i v  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+    __m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), m0f));
+    __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(v, m0f));
+    __m256i a  = _mm256_unpacklo_epi8(hi, lo);  /* per 128-bit lane: pairs of bytes 0..7  of that lane */
+    __m256i b  = _mm256_unpackhi_epi8(hi, lo);  /* per 128-bit lane: pairs of bytes 8..15 of that lane */
+
+#define DUP16(...) _mm256_setr_epi8(__VA_ARGS__, __VA_ARGS__)
+    *r0 = _mm256_or_si256( _mm256_shuffle_epi8(a, DUP16( 0, 1, Z, 2, 3, Z, 4, 5, Z, 6, 7, Z, 8, 9, Z,10)),
+                           DUP16( 0, 0,' ', 0, 0,' ', 0, 0,' ', 0, 0,' ', 0, 0,' ', 0) );
+    *r1 = _mm256_or_si256( _mm256_or_si256(
+                           _mm256_shuffle_epi8(a, DUP16(11, Z,12,13, Z,14,15, Z, Z, Z, Z, Z, Z, Z, Z, Z)),
+                           _mm256_shuffle_epi8(b, DUP16( Z, Z, Z, Z, Z, Z, Z, Z, 0, 1, Z, 2, 3, Z, 4, 5)) ),
+                           DUP16( 0,' ', 0, 0,' ', 0, 0,' ', 0, 0,' ', 0, 0,' ', 0, 0) );
+    *r2 = _mm256_or_si256( _mm256_shuffle_epi8(b, DUP16( Z, 6, 7, Z, 8, 9, Z,10,11, Z,12,13, Z,14,15, Z)),
+                           DUP16(' ', 0, 0,' ', 0, 0,' ', 0, 0,' ', 0, 0,' ', 0, 0,' ') );
+#undef DUP16
+}
+
+TARGET("avx2")
+char* encodeSpacedAvx2(const uint8_t* in, size_t n, char* out)
+{
+    __m256i r0, r1, r2;
+    while (n > 32)
+    {
+        encode32Avx2(in, &r0, &r1, &r2);
+        /* lower lanes hold output of bytes 0..15, upper lanes of bytes 16..31 */
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out),    _mm256_castsi256_si128(r0));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out+16), _mm256_castsi256_si128(r1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out+32), _mm256_castsi256_si128(r2));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out+48), _mm256_extracti128_si256(r0, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out+64), _mm256_extracti128_si256(r1, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out+80), _mm256_extracti128_si256(r2, 1));
+        in += 32; n -= 32; out += 96;
+    }
+    return encodeSpacedSsse3(in, n, out);
+}
+
+TARGET("avx2")
+uint16_t* encodeSpacedWideAvx2(const uint8_t* in, size_t n, uint16_t* out)
+{
+    __m256i r0, r1, r2;
+    while (n > 32)
+    {
+        encode32Avx2(in, &r0, &r1, &r2);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out),    _mm256_cvtepu8_epi16(_mm256_castsi256_si128(r0)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out+16), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(r1)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out+32), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(r2)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out+48), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(r0, 1)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out+64), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(r1, 1)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out+80), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(r2, 1)));
+        in += 32; n -= 32; out += 96;
+    }
+    return encodeSpacedWideSsse3(in, n, out);
+}
+
+TARGET("avx2")
+inline __m256i isHex16(__m256i c)
+{
+    __m256i d = _mm256_and_si256( _mm256_cmpgt_epi16(c, _mm256_set1_epi16('0'-1)), _mm256_cmpgt_epi16(_mm256_set1_epi16('9'+1), c) );
+    __m256i l = _mm256_or_si256(c, _mm256_set1_epi16(0x20));
+    __m256i a = _mm256_and_si256( _mm256_cmpgt_epi16(l, _mm256_set1_epi16('a'-1)), _mm256_cmpgt_epi16(_mm256_set1_epi16('f'+1), l) );
+    return _mm256_or_si256(d, a);
+}
+
+TARGET("avx2")
+inline __m256i nibbles16(__m256i c)
+{
+    __m256i t = _mm256_and_si256(_mm256_srli_epi16(c, 6), _mm256_set1_epi16(1));
+    return _mm256_add_epi16( _mm256_and_si256(c, _mm256_set1_epi16(0x0F)),
+                             _mm256_add_epi16(_mm256_slli_epi16(t, 3), t) );
+}
+
+TARGET("avx2")
+size_t scanDigitsAvx2(const uint16_t* in, size_t n)
+{
+    size_t i = 0;
+    while (i + 16 <= n)
+    {
+        unsigned m = static_cast<unsigned>( _mm256_movemask_epi8( isHex16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in+i))) ) );
+        if (m != 0xFFFFFFFFu) return i + __builtin_ctz(~m) / 2;
+        i += 16;
+    }
+    return i + scanDigitsSse2(in+i, n-i);
+}
+
+TARGET("avx2")
+void decodePairsAvx2(const uint16_t* in, size_t npairs, uint8_t* out)
+{
+    const __m256i lo_mask = _mm256_set1_epi16(0x00FF);
+    while (npairs >= 16)
+    {
+        __m256i n0 = nibbles16( _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in)) );
+        __m256i n1 = nibbles16( _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in+16)) );
+        /* packus works per 128-bit lane - restore order of the quadwords */
+        __m256i p  = _mm256_permute4x64_epi64( _mm256_packus_epi16(n0, n1), 0xD8 );
+        __m256i x  = _mm256_or_si256( _mm256_slli_epi16(_mm256_and_si256(p, lo_mask), 4), _mm256_srli_epi16(p, 8) );
+        __m256i r  = _mm256_permute4x64_epi64( _mm256_packus_epi16(x, x), 0xD8 );
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(r));
+        in += 32; npairs -= 16; out += 16;
+    }
+    decodePairsSse2(in, npairs, out);
+}
+
+#undef Z
+
+bool cpuHas(isa_t isa)
+{
+    __builtin_cpu_init();
+    switch (isa)
+    {
+    case ISA_AVX2:  return __builtin_cpu_supports("avx2");
+    case ISA_SSSE3: return __builtin_cpu_supports("ssse3");
+    default:        return true;
+    }
+}
+
+} // namespace
+#endif // HEXKERNELS_X86
+
+
+//======================================================= Dispatch
+
+namespace {
+
+struct Kernels
+{
+    isa_t       isa;
+    char*       (*encodeSpaced)(const uint8_t*, size_t, char*);
+    uint16_t*   (*encodeSpacedWide)(const uint8_t*, size_t, uint16_t*);
+    size_t      (*scanDigits)(const uint16_t*, size_t);
+    void        (*decodePairs)(const uint16_t*, size_t, uint8_t*);
+    size_t      (*decodeSpacedPairs)(const uint16_t*, size_t, uint8_t*);
+
+    void select(isa_t wanted)
+    {
+        isa               = ISA_SCALAR;
+        encodeSpaced      = encodeSpacedScalar<char>;
+        encodeSpacedWide  = encodeSpacedScalar<uint16_t>;
+        scanDigits        = scanDigitsScalar;
+        decodePairs       = decodePairsScalar;
+        decodeSpacedPairs = decodeSpacedPairsScalar;
+#ifdef HEXKERNELS_X86
+        if (wanted >= ISA_SSSE3 && cpuHas(ISA_SSSE3))
+        {
+            isa               = ISA_SSSE3;
+            encodeSpaced      = encodeSpacedSsse3;
+            encodeSpacedWide  = encodeSpacedWideSsse3;
+            scanDigits        = scanDigitsSse2;
+            decodePairs       = decodePairsSse2;
+            decodeSpacedPairs = decodeSpacedPairsSse2;
+        }
+        if (wanted >= ISA_AVX2 && cpuHas(ISA_AVX2))
+        {
+            isa               = ISA_AVX2;
+            encodeSpaced      = encodeSpacedAvx2;
+            encodeSpacedWide  = encodeSpacedWideAvx2;
+            scanDigits        = scanDigitsAvx2;
+            decodePairs       = decodePairsAvx2;
+        }
+#else
+        (void) wanted;
+#endif
+    }
+
+    Kernels() { select(ISA_AVX2); }
+};
+
+Kernels kernels;
+
+} // namespace
+
+isa_t HexKernels::activeIsa()
+{
+    return kernels.isa;
+}
+
+const char* HexKernels::isaName(isa_t isa)
+{
+    switch (isa)
+    {
+    case ISA_AVX2:   return "AVX2";
+    case ISA_SSSE3:  return "SSSE3";
+    case ISA_SCALAR:
+    default:         return "scalar";
+    }
+}
+
+isa_t HexKernels::selectIsa(isa_t isa)
+{
+    kernels.select(isa);
+    return kernels.isa;
+}
+
+char* HexKernels::encodeSpaced(const uint8_t* in, size_t n, char* out)
+{
+    return kernels.encodeSpaced(in, n, out);
+}
+
+uint16_t* HexKernels::encodeSpaced(const uint8_t* in, size_t n, uint16_t* out)
+{
+    return kernels.encodeSpacedWide(in, n, out);
+}
+
+size_t HexKernels::scanDigits(const uint16_t* in, size_t n)
+{
+    return kernels.scanDigits(in, n);
+}
+
+void HexKernels::decodePairs(const uint16_t* in, size_t npairs, uint8_t* out)
+{
+    kernels.decodePairs(in, npairs, out);
+}
+
+size_t HexKernels::decodeSpacedPairs(const uint16_t* in, size_t n, uint8_t* out)
+{
+    return kernels.decodeSpacedPairs(in, n, out);
+}
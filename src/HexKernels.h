@@ -0,0 +1,60 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Bulk byte <-> hex digit kernels with runtime selected SIMD variants
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#ifndef HEXKERNELS_H
+#define HEXKERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * All kernels have a scalar implementation; SSE2/SSSE3/AVX2 variants are
+ * compiled with GCC/Clang on x86 and selected once, at first use, according
+ * to CPU features. Results never depend on the selected variant.
+ *
+ * Text is either Latin-1 (char) or UTF-16 (uint16_t, layout compatible with QChar).
+ */
+namespace HexKernels
+{
+    typedef enum {
+        ISA_SCALAR,
+        ISA_SSSE3,      /* SSE2 decoding, SSSE3 encoding */
+        ISA_AVX2,
+
+        __ISA_CNT
+    } isa_t;
+
+    isa_t       activeIsa();
+    const char* isaName(isa_t isa);
+    /** Selects kernels variant (clamped to what CPU supports), returns selected one. Benchmarks only. */
+    isa_t       selectIsa(isa_t isa);
+
+    //--------------------------------------------------------- encoding
+    /** Writes n bytes as "XX XX .. XX" (3*n-1 characters, upper case), returns end of output */
+    char*       encodeSpaced(const uint8_t* in, size_t n, char* out);
+    uint16_t*   encodeSpaced(const uint8_t* in, size_t n, uint16_t* out);
+
+    //--------------------------------------------------------- decoding
+    /** Returns length of the leading run of hex digits [0-9A-Fa-f] */
+    size_t      scanDigits(const uint16_t* in, size_t n);
+    /** Decodes 2*npairs hex digits (already validated by scanDigits()) into npairs bytes */
+    void        decodePairs(const uint16_t* in, size_t npairs, uint8_t* out);
+    /**
+     * Decodes leading "XX " groups (two hex digits followed by a single space).
+     * Stops at the first group not matching exactly, returns number of groups (= bytes) decoded.
+     */
+    size_t      decodeSpacedPairs(const uint16_t* in, size_t n, uint8_t* out);
+}
+
+#endif // HEXKERNELS_H
@@ -0,0 +1,85 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Monotonic clock source and its conversions to wall clock time
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#include "HiResClock.h"
+
+#include <QDateTime>
+#include <QMutex>
+#include <QMutexLocker>
+
+#ifdef Q_OS_UNIX
+#include <time.h>
+#include <sys/time.h>
+#else
+#include <QElapsedTimer>
+#endif
+
+qint64 HiResClock::now()
+{
+#ifdef Q_OS_UNIX
+#ifdef CLOCK_MONOTONIC
+    struct timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return qint64(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#else
+    // must match the fallback in QSerialPortPrivate::readNotification()
+    struct timeval tv;
+    ::gettimeofday(&tv, 0);
+    return qint64(tv.tv_sec) * 1000000000 + qint64(tv.tv_usec) * 1000;
+#endif
+#else
+    static QElapsedTimer timer;
+    if (!timer.isValid()) timer.start();
+    return timer.nsecsElapsed();
+#endif
+}
+
+qint64 HiResClock::toMSecsSinceEpoch(qint64 clock_ns)
+{
+    return QDateTime::currentMSecsSinceEpoch() - (now() - clock_ns) / 1000000;
+}
+
+QString HiResClock::timeOfDay(qint64 clock_ns)
+{
+    static QMutex mutex;
+    static qint64 anchor_wall  = 0;     // ms since epoch ...
+    static qint64 anchor_clock = 0;     // ... at this clock value, ns
+    qint64        wall;
+
+    {
+        QMutexLocker lock(&mutex);
+        qint64 clock    = now();
+        qint64 wall_now = QDateTime::currentMSecsSinceEpoch();
+
+        // The us part comes from this clock only, the wall clock has just ms
+        if (!anchor_wall || qAbs(anchor_wall + (clock - anchor_clock) / 1000000 - wall_now) > ANCHOR_TOLERANCE_MS)
+        {
+            anchor_wall  = wall_now;
+            anchor_clock = clock;
+        }
+        wall = anchor_wall * 1000 + (clock_ns - anchor_clock) / 1000;   // us
+    }
+    QDateTime dt = QDateTime::fromMSecsSinceEpoch(wall / 1000);
+
+    return QString("%1%2").arg(dt.toString("hh:mm:ss.zzz")).arg(wall % 1000, 3, 10, QChar('0'));
+}
+
+QString HiResClock::duration(qint64 ns)
+{
+    if (ns < 0)              return QString("-%1").arg(duration(-ns));
+    if (ns < 10000)          return QString("%1 ns").arg(ns);
+    if (ns < 10000000)       return QString("%1 us").arg(ns / 1000.0, 0, 'f', 1);
+    if (ns < 10000000000LL)  return QString("%1 ms").arg(ns / 1000000.0, 0, 'f', 3);
+    return QString("%1 s").arg(ns / 1000000000.0, 0, 'f', 3);
+}
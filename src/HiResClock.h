@@ -0,0 +1,52 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Monotonic nanosecond clock shared by the receive path and the UI
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#ifndef HIRESCLOCK_H
+#define HIRESCLOCK_H
+
+#include <QtGlobal>
+#include <QString>
+
+/**
+ * On Unix the clock is CLOCK_MONOTONIC - the same time base as
+ * QSerialPort::readTimestamp(), so stamps taken inside the serial port
+ * backend can be compared directly with now(). Elsewhere it is a process
+ * wide QElapsedTimer.
+ */
+namespace HiResClock
+{
+    enum {
+        ANCHOR_TOLERANCE_MS = 100
+    };
+
+    /** Current time, ns */
+    qint64  now();
+
+    /** Converts a clock value to wall clock time, ms since epoch */
+    qint64  toMSecsSinceEpoch(qint64 clock_ns);
+
+    /**
+     * Wall clock time of a clock value as "hh:mm:ss.zzzuuu". The wall clock
+     * has ms resolution only: it is sampled once as an anchor, and stamps
+     * are placed from there by this clock, so the difference of two printed
+     * times is exact to the us. The anchor follows wall clock steps larger
+     * than ANCHOR_TOLERANCE_MS.
+     */
+    QString timeOfDay(qint64 clock_ns);
+
+    /** Duration as text with unit chosen for readability, e.g. "850 us", "12.345 ms" */
+    QString duration(qint64 ns);
+}
+
+#endif // HIRESCLOCK_H
@@ -30,7 +30,10 @@ void InputHistoryList::Add(QVariantList *storage, QByteArray *item)
         const QVariant& n = storage->at(i);
         if ( ! n.canConvert(QVariant::ByteArray) ) continue;
 
-        if (n.toByteArray() == *item) break;
+        // Entry sent again shares data with the item, no need to compare bytes
+        const QByteArray entry = n.toByteArray();
+        if (entry.constData() == item->constData() && entry.size() == item->size()) break;
+        if (entry == *item) break;
     }
     if ( i < storage->size() )
     {
@@ -15,6 +15,7 @@
 #include "MainWindow.h"
 
 #include <QAction>
+#include <QFileInfo>
 #include <QInputDialog>
 #include <QtSerialPort/QSerialPortInfo>
 
@@ -28,14 +29,24 @@
 
 //static const char*
 
-static const SerialSetupDialog::PortSettings defaultPortSettings = {115200,QSerialPort::Data8, QSerialPort::NoParity, QSerialPort::OneStop,QSerialPort::NoFlowControl, 250};
 // ******************************************************************************** C L A S S: MainWindow
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
+    , rx_flush_interval(RxAccumulator::DEFAULT_FLUSH_INTERVAL)
+    , rx_flush_threshold(RxAccumulator::DEFAULT_FLUSH_THRESHOLD)
+    , rx_frame_gap(RxAccumulator::MODBUS_GAP_CHARS10)
+    , last_tx_time(0)
+    , fileSender(0)
+    , replayDevice(0)
+    , tx_queue_limit(SerialPortEngine::DEFAULT_TX_QUEUE_LIMIT)
     , ui(new Ui::MainWindow)
     , logFile(0)
-    , portSettings(defaultPortSettings)
+    , log_commit_interval(CaptureLogWriter::DEFAULT_COMMIT_INTERVAL)
+    , log_queue_limit(CaptureLogWriter::DEFAULT_QUEUE_LIMIT)
+    , log_overrun(false)
+    , log_suspended(false)
+    , portSettings(SerialSetupDialog::DefaultSettings)
     , current_intput_mode_idx(-1)
     , current_output_mode_idx(-1)
     , outopt(OUTOPT_SHOW_INPUT | OUTOPT_SHOW_OUT_INFO)
@@ -69,12 +80,31 @@ MainWindow::MainWindow(QWidget *parent)
 
     createInputModeMenu();
 
-    _port = new QSerialPort(this);
+    _port = new SerialPortEngine(this);
+    _port->setTxQueueLimit(tx_queue_limit);
+
+    rxAccumulator = new RxAccumulator(this);
+    rxAccumulator->setFlushInterval(rx_flush_interval);
+    rxAccumulator->setFlushThreshold(rx_flush_threshold);
+    updateRxTiming();
+    ASSERT_ALWAYS( connect(rxAccumulator, SIGNAL(frameReady(QByteArray,int,qint64,qint64)), SLOT(onRxFrameReady(QByteArray,int,qint64,qint64)) ) );
 
     ASSERT_ALWAYS( connect(_port, SIGNAL(error(QSerialPort::SerialPortError)),    SLOT(onSerialPortError(QSerialPort::SerialPortError)) ) );
 
     ASSERT_ALWAYS( connect(_port, SIGNAL(readyRead()),    SLOT(onReadyRead()) ) );
     ASSERT_ALWAYS( connect(_port, SIGNAL(bytesWritten(qint64)), SLOT(onBytesWritten(qint64)) ) );
+    ASSERT_ALWAYS( connect(_port, SIGNAL(rxOverrun()),    SLOT(onRxOverrun()) ) );
+    ASSERT_ALWAYS( connect(_port, SIGNAL(latencyProbeFinished(int,int,qint64,qint64,qint64)), SLOT(onLatencyProbeFinished(int,int,qint64,qint64,qint64)) ) );
+    ASSERT_ALWAYS( connect(_port, SIGNAL(lineCountersChanged(QSerialPort::LineCounters,qint64)), SLOT(onLineCountersChanged(QSerialPort::LineCounters,qint64)) ) );
+
+    fileSender = new FileSender(_port, this);
+    fileSender->setWindow( qMin<int>(FileSender::DEFAULT_WINDOW, tx_queue_limit) );
+    ASSERT_ALWAYS( connect(fileSender, SIGNAL(progress(qint64,qint64)), SLOT(onFileSendProgress(qint64,qint64)) ) );
+    ASSERT_ALWAYS( connect(fileSender, SIGNAL(finished(bool)),          SLOT(onFileSendFinished(bool)) ) );
+    replayDevice = new CaptureReplayDevice(this);
+    ASSERT_ALWAYS( connect(replayDevice, SIGNAL(rxData(QByteArray,qint64)), SLOT(onReplayRxData(QByteArray,qint64)) ) );
+    ASSERT_ALWAYS( connect(replayDevice, SIGNAL(txData(QByteArray,qint64)), SLOT(onReplayTxData(QByteArray,qint64)) ) );
+    ASSERT_ALWAYS( connect(replayDevice, SIGNAL(finished(bool)),            SLOT(onReplayFinished(bool)) ) );
     //ASSERT_ALWAYS( connect(_port, SIGNAL(dataTerminalReadyChanged(bool)),    SLOT(onLineChanged(bool)) ) );
     //ASSERT_ALWAYS( connect(_port, SIGNAL(requestToSendChanged(bool)),        SLOT(onLineChanged(bool)) ) );
     ASSERT_ALWAYS( connect(_port, SIGNAL(pinoutSignalsChanged(QSerialPort::PinoutSignals)),        SLOT(onSerialLinesChanged(QSerialPort::PinoutSignals)) ) );
@@ -123,10 +153,13 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow()
 {
+    fileSender->cancel();
     if (_port->isOpen() )
     {
         _port->close();
     }
+    onReadyRead();
+    rxAccumulator->flush();
 
     updateConfig(CONF_OP_WRITE);
 
@@ -188,6 +221,22 @@ void  MainWindow::setupUi()
     inputStatus->addPermanentWidget(lbOverwriteMode);
 
 
+    // File transfer progress, shown only while sending
+    lbTxStatus = new QLabel();
+    lbTxStatus->setVisible(false);
+    ui->statusBar->addPermanentWidget(lbTxStatus);
+
+    // Line counters, shown once the port reports them
+    lbLineStatus = new QLabel();
+    lbLineStatus->setVisible(false);
+    line_counters = QSerialPort::LineCounters();
+    ui->statusBar->addPermanentWidget(lbLineStatus);
+    txProgress = new QProgressBar();
+    txProgress->setRange(0, 1000);
+    txProgress->setMaximumWidth(200);
+    txProgress->setVisible(false);
+    ui->statusBar->addPermanentWidget(txProgress);
+
     //ui->inputEditLayout->addWidget(inputStatus,ui->inputEditLayout->rowCount()+1,0,1,ui->inputEditLayout->columnCount()-1);
     ui->InputBtnsHLayout->addWidget(inputStatus);
 
@@ -203,7 +252,7 @@ void  MainWindow::setupUi()
 
 QString MainWindow::getDefaultLogFileName()
 {
-    return QString("%1_%2_%3.log.html")
+    return QString("%1_%2_%3.cap")
             .arg(QCoreApplication::applicationName())
             .arg(QDate::currentDate().toString("yyyy-MM-dd"))
             .arg(QTime::currentTime().toString("hh.mm.ss.zzz")
@@ -212,40 +261,51 @@ QString MainWindow::getDefaultLogFileName()
 
 void MainWindow::openLogFile(const QString logFileName)
 {
-    logFile = new QFile(logFileName);
-    if (!logFile->open(QIODevice::WriteOnly | QIODevice::Text))
+    logFile = new CaptureLogWriter();
+    logFile->setCommitInterval(log_commit_interval);
+    logFile->setQueueLimit(log_queue_limit);
+    log_overrun = false;
+    if (!logFile->open(logFileName))
     {
-        logError(QString("Failed to create log file: %1").arg(logFileName));
+        logError(QString("Failed to create log file: %1. %2").arg(logFileName, logFile->errorString()));
         delete  logFile;
         logFile = 0;
         return;
     }
-    //Write HTML preamble
-    QString htmlHead;
-    htmlHead = QString(
-            "<html lang=\"en\">\n"
-            "<head>\n"
-            "<title>%1 log created at %2 %3</title>\n" )
-            .arg(QCoreApplication::applicationName())
-            .arg(QDate::currentDate().toString("yyyy-MM-dd"))
-            .arg(QTime::currentTime().toString("hh:mm:ss.zzz")) ;
+    logOpGray(QString("Capturing to: %1").arg(logFileName));
+}
 
-    if ( logFile->write(htmlHead.toLatin1())<0 )
+void MainWindow::closeLogFile()
+{
+    if (logFile)
     {
-        logError(QString("Failed to write to log file: %1").arg(logFileName));
+        logFile->close();   // commits queued records
+        CaptureLogWriter::Stats st = logFile->stats();
+        QString                 err = logFile->errorString();
+
         delete  logFile;
         logFile = 0;
+
+        logOpGray(QString("Capture closed: %1 bytes, %2 commits, max commit time %3 ms, %4 records (%5 bytes) dropped")
+                  .arg(st.bytes_written).arg(st.commits).arg(st.max_commit_us / 1000.0, 0, 'f', 1)
+                  .arg(st.dropped_records).arg(st.dropped_bytes));
+        if (st.write_error) logError(QString("Writing capture failed: %1").arg(err));
     }
 }
 
-void MainWindow::closeLogFile()
+void MainWindow::checkLogWrite(bool written)
 {
-    if (logFile)
+    if (written)
     {
-        // put HTML ending
-        logFile->write("\n</body></html>\n");
-        delete  logFile;
-        logFile = 0;
+        log_overrun = false;
+    }
+    else if (!log_overrun)
+    {
+        // Disk does not keep up; report once, until records get through again
+        log_overrun = true;
+        CaptureLogWriter::Stats st = logFile->stats();
+        logError(QString("Capture queue full (%1 bytes), records are dropped. Dropped so far: %2")
+                 .arg(st.bytes_queued).arg(st.dropped_records));
     }
 }
 
@@ -260,6 +320,7 @@ void MainWindow::prepareInputModes()
     inm->display_converter = QBinStrConvCollection::getConv(QBinStrConvCollection::CONV_HEX);
     inm->edit_mode = BinaryEditor::INMODE_HEX;
     inm->editor = ui->binaryEditor;
+    inm->history_version = 0;
 
     inm = &input_modes[INMODE_ASCII];
     inm->name = "ASCII";
@@ -267,6 +328,7 @@ void MainWindow::prepareInputModes()
     inm->display_converter = QBinStrConvCollection::getConv(QBinStrConvCollection::CONV_ASCII);
     inm->edit_mode = BinaryEditor::INMODE_TEXT;
     inm->editor = ui->binaryEditor;
+    inm->history_version = 0;
 
     inm = &input_modes[INMODE_CSTR];
     inm->name = "C-like string";
@@ -274,10 +336,11 @@ void MainWindow::prepareInputModes()
     inm->display_converter = QBinStrConvCollection::getConv(QBinStrConvCollection::CONV_CSTR);
     inm->edit_mode = BinaryEditor::INMODE_TEXT;
     inm->editor = ui->binaryEditor;
+    inm->history_version = 0;
 
 }
 
-void MainWindow::selectInputMode(MainWindow::input_modes_t mode)
+void MainWindow::selectInputMode(input_modes_t mode)
 {
     //current_intput_mode_idx
     switch (mode)
@@ -315,7 +378,8 @@ void MainWindow::updateUiAccordingToPortState(bool is_open, const QString& portN
 
     ui->connectBtn->setChecked(is_open);
     ui->devicesComboBox->setEnabled(! is_open );
-    ui->sendBtn->setEnabled(is_open);
+    ui->sendBtn->setEnabled(is_open && !fileSender->isActive());
+    ui->actSendFile->setEnabled(is_open);
 
     ui->dtrBtn->setEnabled( is_open );
     ui->rtsBtn->setEnabled( is_open );
@@ -378,6 +442,8 @@ void MainWindow::createDisplayModeMenu()
     {
         ui->DisplayModeCombo->addItem(display_convs[cnt]->getName(),cnt);
     }
+    ui->DisplayModeCombo->setCurrentIndex(current_output_mode_idx);
+    ui->outputView->setDisplayConv( currentDisplayConv() );
 }
 
 void MainWindow::addDisplayOptToMenu(QMenu* menu, QString name, output_options_t opt)
@@ -394,6 +460,7 @@ void MainWindow::createDisplayOptionsMenu()
     QMenu* menu = new QMenu();
     addDisplayOptToMenu(menu, tr("Display data sent to port"), OUTOPT_SHOW_INPUT);
     addDisplayOptToMenu(menu, tr("Display received data info"), OUTOPT_SHOW_OUT_INFO);
+    addDisplayOptToMenu(menu, tr("Split received frames on line idle gap"), OUTOPT_SPLIT_ON_GAP);
     ui->dsplOptionsMenuBtn->setMenu(menu);
 }
 
@@ -424,16 +491,7 @@ void MainWindow::createDevicesList()
 
 void MainWindow::updatePortConfig(cfg_operations_t operation)
 {
-#define RW_PORTSETTINGS_FIELD(_type_, _name_) AutoCfg<_type_,convVarAsIntTo<_type_> >::doCfg(operation, &portSettings._name_, #_name_)
-    RW_PORTSETTINGS_FIELD(qint32,                   BaudRate);
-    RW_PORTSETTINGS_FIELD(QSerialPort::DataBits,    DataBits);
-    RW_PORTSETTINGS_FIELD(QSerialPort::Parity,      Parity);
-    RW_PORTSETTINGS_FIELD(QSerialPort::StopBits,    StopBits);
-    RW_PORTSETTINGS_FIELD(QSerialPort::FlowControl, FlowControl);
-    RW_PORTSETTINGS_FIELD(long,                     Timeout_Millisec);
-    //AutoCfg<qint32,                convVarAsIntTo<qint32>                >::doCfg(operation, portSettings.BaudRate, "BaudRate");
-    //AutoCfg<QSerialPort::DataBits, convVarAsIntTo<QSerialPort::DataBits> >::doCfg(operation, portSettings.DataBits, "DataBits");
- #undef RW_PORTSETTINGS_FIELD
+    SerialSetupDialog::updateConfig(operation, portSettings);
 }
 
 void MainWindow::updateConfig(cfg_operations_t operation)
@@ -446,6 +504,12 @@ void MainWindow::updateConfig(cfg_operations_t operation)
     InputMode* inm;
 
     AutoCfg_int::doCfg(operation, &outopt, "DisplayFlags" );
+    AutoCfg_int::doCfg(operation, &rx_flush_interval,  "DisplayFlushInterval" );
+    AutoCfg_int::doCfg(operation, &rx_flush_threshold, "DisplayFlushBytes" );
+    AutoCfg_int::doCfg(operation, &rx_frame_gap,       "DisplayFrameGap" );
+    AutoCfg_int::doCfg(operation, &tx_queue_limit,     "TxQueueLimit" );
+    AutoCfg_int::doCfg(operation, &log_commit_interval, "LogCommitInterval" );
+    AutoCfg_int::doCfg(operation, &log_queue_limit,     "LogQueueLimit" );
 
     appconfig->beginGroup("InputMode");
     AutoCfg_int::doCfg(operation, &current_intput_mode_idx, "SelInputMode" );
@@ -469,7 +533,26 @@ void MainWindow::updateConfig(cfg_operations_t operation)
 
 void MainWindow::displayErrMsg(const QString &msg)
 {
-     ui->outputTextEdit->appendPlainText(msg);
+     ui->outputView->appendMessage(msg.trimmed(), Qt::black);
+}
+
+void MainWindow::outMessage(const QString &msg, const char *color, const char *fmt)
+{
+    QString text  = msg.trimmed();
+    QColor  rgb   = QColor(color);
+    int     style = (fmt[0] == 'b') ? OutputRecordStore::STYLE_BOLD : OutputRecordStore::STYLE_ITALIC;
+
+    if (logFile && !log_suspended) checkLogWrite( logFile->writeMessage(text, rgb.rgb(), style) );
+    ui->outputView->appendMessage(text, rgb, style);
+}
+
+void MainWindow::outData(OutputRecordStore::record_kind_t kind, const QByteArray &data, qint64 time_ns)
+{
+    if (!time_ns) time_ns = HiResClock::now();
+
+    // Raw data only, formatting is done by the view (visible part) or by exporter
+    if (logFile && !log_suspended) checkLogWrite( logFile->write(kind, data.constData(), data.size(), logFile->timestampAt(time_ns)) );
+    ui->outputView->appendData(kind, data, HiResClock::toMSecsSinceEpoch(time_ns));
 }
 
 void MainWindow::displayOptionsTriggered()
@@ -485,6 +568,11 @@ void MainWindow::displayOptionsTriggered()
         {
             outopt &= ~opt;
         }
+        if (opt == OUTOPT_SPLIT_ON_GAP)
+        {
+            rxAccumulator->flush();
+            updateRxTiming();
+        }
     }
 }
 
@@ -560,17 +648,18 @@ void MainWindow::inputMacrosEditTriggered()
 
 void MainWindow::onInputChanged()
 {
-    const QByteArray* buf=NULL;
     QString          str;
     InputMode&       inm = input_modes[current_intput_mode_idx];
 
-    if ( inm.isValid() )
-    {
-        buf = inm.getEditorConstData();
-    }
-    if ( buf && buf->size() )
+    // Text editor keeps size and FCS of converted data per text block, no need to convert it all.
+    // FCS of a mapped file would read all of it, skip it
+    if ( inm.isValid() && !inm.editor->isFileBacked() )
     {
-        str = QString("0x%1").arg( calcFCS(*buf) ,2,16,QChar('0') );
+        quint8 fcs = inm.editor->getInputFCS();
+        if ( inm.editor->getInputSize() )
+        {
+            str = QString("0x%1").arg( fcs ,2,16,QChar('0') );
+        }
     }
 
     lbSum->setText( str );
@@ -591,6 +680,40 @@ void MainWindow::onInputOverwriteModeChanged(bool is_ovr_mode)
     lbOverwriteMode->setText(is_ovr_mode ? "OVR" : "INS" );
 }
 
+/**
+ * Short text of data for menus and names: beginning and end of its display text.
+ * Only bytes which can show up in the title are converted, not the whole payload.
+ */
+QString MainWindow::dataTitle(InputMode &inm, const QByteArray &data)
+{
+    #define MAX_TITLE_SIZE    40
+    #define SHORTCUT_AFTER    25
+    #define SHORTCUT_STR      " ... "
+    #define SHORTCUT_STR_SIZE (sizeof(SHORTCUT_STR)-1)
+    QByteArray part;
+    QString    title;
+
+    // Every byte gives at least one character
+    if ( data.size() <= 2*MAX_TITLE_SIZE )
+    {
+        part  = data;
+        title = inm.display_converter->convert( part, QBinStrConv::PLAIN_TEXT, QBinStrConv::OUTB_SIMPLE );
+        if (title.size()>MAX_TITLE_SIZE) {
+            int cnt = title.size()-MAX_TITLE_SIZE+SHORTCUT_STR_SIZE;
+            title.replace(SHORTCUT_AFTER,cnt,SHORTCUT_STR);
+        }
+        return title;
+    }
+
+    part  = data.left(MAX_TITLE_SIZE);
+    title = inm.display_converter->convert( part, QBinStrConv::PLAIN_TEXT, QBinStrConv::OUTB_SIMPLE ).left(SHORTCUT_AFTER);
+    part  = data.right(MAX_TITLE_SIZE);
+    title.append(SHORTCUT_STR);
+    title.append( inm.display_converter->convert( part, QBinStrConv::PLAIN_TEXT, QBinStrConv::OUTB_SIMPLE )
+                      .right(MAX_TITLE_SIZE-SHORTCUT_AFTER-SHORTCUT_STR_SIZE) );
+    return title;
+}
+
 void MainWindow::updateInputModeHistoryMenu()
 {
 
@@ -610,16 +733,7 @@ void MainWindow::updateInputModeHistoryMenu()
         if ( ! n.canConvert(QVariant::ByteArray) ) continue;
 
         arr = n.toByteArray();
-        title = inm.display_converter->convert( arr, QBinStrConv::PLAIN_TEXT, QBinStrConv::OUTB_SIMPLE );
-
-        #define MAX_TITLE_SIZE    40
-        #define SHORTCUT_AFTER    25
-        #define SHORTCUT_STR      " ... "
-        #define SHORTCUT_STR_SIZE (sizeof(SHORTCUT_STR)-1)
-        if (title.size()>MAX_TITLE_SIZE) {
-            int cnt = title.size()-MAX_TITLE_SIZE+SHORTCUT_STR_SIZE;
-            title.replace(SHORTCUT_AFTER,cnt,SHORTCUT_STR);
-        }
+        title = dataTitle( inm, arr );
         title.append(QString(" (%1 bytes)").arg(arr.size()));
 
         act = input_mode_history_menu.addAction(
@@ -685,24 +799,41 @@ void MainWindow::updateInputModeMacrosMenu()
 void MainWindow::onReadyRead()
 {
     //logOpBlue("Read Event...");
-    QByteArray buf;// = port->readAll();
+    const char* ptr;
+    int         len;
+    qint64      time;
 
-    int maxlen = _port->bytesAvailable();
-    if (maxlen<=0) return;
+    // Take the whole batch straight from the I/O ring, chunk by chunk with
+    // arrival stamps; rendering is deferred until the end of the current display frame
+    while ( (len = _port->peekChunk(&ptr, &time)) > 0 )
+    {
+        rxAccumulator->append(ptr, len, time);
+        _port->consume(len);
+    }
+}
 
-    if (maxlen<8192) maxlen = 8192; // If we want to use timeouts, we must try read more than is in buffer.
-    buf.resize(maxlen);
+void MainWindow::onRxOverrun()
+{
+    rxAccumulator->flush();
+    logError(QString("Receive buffer overrun: %1 bytes dropped since port was opened").arg(_port->droppedBytes()));
+}
 
-    maxlen = _port->read(buf.data(), maxlen );
-    buf.resize(maxlen);
+void MainWindow::onRxFrameReady(const QByteArray &data, int chunks, qint64 time_ns, qint64 gap_ns)
+{
     if (outopt & OUTOPT_SHOW_OUT_INFO)
     {
-        logOpBlue(QString("Read %1 bytes").arg( maxlen ));
+        QString info = QString("Read %1 bytes").arg( data.size() );
+
+        if (chunks>1)     info += QString(" (%1 chunks)").arg( chunks );
+        if (gap_ns>=0)    info += QString(", gap %1").arg( HiResClock::duration(gap_ns) );
+        if (last_tx_time) info += QString(", %1 after TX").arg( HiResClock::duration(time_ns - last_tx_time) );
+
+        logOperationAt(time_ns, info, "blue");
     }
     QBinStrConv* displayConv = currentDisplayConv();
     if (displayConv)
     {
-        outHtml( displayConv->convert(buf, QBinStrConv::HTML) );
+        outData( OutputRecordStore::REC_RX, data, time_ns );
     }
     else
     {
@@ -713,9 +844,12 @@ void MainWindow::onReadyRead()
 
 void MainWindow::onBytesWritten(qint64 bytes)
 {
+    // file transfer reports its own progress
+    if (fileSender->isActive()) return;
+
     if (outopt & OUTOPT_SHOW_INPUT)
     {
-        logOpGray(QString("&lt;&lt;&lt; %1 bytes sent\n").arg(bytes));
+        logOpGray(QString("<<< %1 bytes sent").arg(bytes));
     }
     /*
     if (bytes>0)
@@ -731,18 +865,17 @@ qint64 MainWindow::sendData(const QByteArray &data )
 {
     if (! _port->isOpen() ) return 0;
 
-    qint64      size = data.size();
-    qint64      sent;
-    const char* ptr = data.constData();
-
-    while(size>0)
+    // Queued as one packet, never blocks; paced by the I/O thread
+    qint64 sent = _port->write(data);
+    if (sent != data.size())
     {
-        sent = _port->write(ptr,size);
-        if (!sent) break;
-        ptr  += sent;
-        size -= sent;
+        logError(QString("Transmit queue full (%1 bytes waiting), %2 bytes not sent").arg(_port->txPending()).arg(data.size()));
+        return 0;
     }
-    return data.size()-size;
+
+    // Reference point for response latency of received frames
+    last_tx_time = HiResClock::now();
+    return sent;
 }
 
 void MainWindow::on_sendBtn_clicked()
@@ -785,20 +918,23 @@ void MainWindow::on_sendBtn_clicked()
     InputMode* inm = currentInputMode();
     if ( inm )
     {
-        QByteArray buf = inm->getEditorData();
+        // One buffer per editor version, shared by port queue, history and output
+        InputDataView view = inm->getEditorView();
+        QByteArray    buf  = view.bytes();
         if ( buf.size() )
         {
-            if (outopt & OUTOPT_SHOW_INPUT)
+            // Display everything received so far before the outgoing data
+            rxAccumulator->flush();
+
+            inm->addHistoryEntry(view);
+
+            if (sendData(buf) && (outopt & OUTOPT_SHOW_INPUT))
             {
-                logOpGray(QString("&gt;&gt;&gt; Sending %1 bytes...").arg(buf.size()));
+                logOperationAt(last_tx_time, QString(">>> Sending %1 bytes...").arg(buf.size()), "gray");
                 if (currentDisplayConv() )
-                outHtml( currentDisplayConv()->convert(buf,QBinStrConv::HTML) );
+                outData( OutputRecordStore::REC_TX, buf, last_tx_time );
             }
 
-            inm->addHistoryEntry(&buf);
-
-            sendData(buf);
-
             updateInputModeHistoryMenu();
         }
 
@@ -819,14 +955,29 @@ void MainWindow::on_DisplayModeCombo_activated(int index)
 {
     //selectInputMode( static_cast<input_modes_t>(ui->InputModeCombo->itemData(index).toInt()) );
      current_output_mode_idx = ui->DisplayModeCombo->itemData(index).toInt();
+     ui->outputView->setDisplayConv( currentDisplayConv() );
 }
 
 
 void MainWindow::on_connectBtn_clicked()
 {
-    if (_port->isOpen() )
+    if (replayDevice->isActive())
+    {
+        // live data would mix with the replayed one
+        logError("Stop the replay before connecting");
+    }
+    else if (_port->isOpen() )
     {
+        fileSender->cancel();
+        QSerialPort::LineCounters totals = _port->lineCounters();
         _port->close();
+        onReadyRead(); // tail of the data drained by close()
+        rxAccumulator->flush();
+        checkLineCounters(totals, HiResClock::now());  // errors since the last poll
+        logOpGray(QString("Port closed: %1").arg(formatLineCounters(totals)));
+        line_counters = QSerialPort::LineCounters();
+        lbLineStatus->clear();
+        lbLineStatus->setVisible(false);
     }
     else if (ui->devicesComboBox->currentIndex()>=0)
     {
@@ -839,7 +990,11 @@ void MainWindow::on_connectBtn_clicked()
         }
         else
         {
+            line_counters = QSerialPort::LineCounters();
+            lbLineStatus->setText(formatLineCounters(line_counters));
+            lbLineStatus->setVisible(true);
             setPortSetting(_port, portSettings);
+            updateRxTiming();
             updateUiAccordingToPinoutSignals(_port->pinoutSignals());
         }
     }
@@ -867,32 +1022,42 @@ void MainWindow::on_devicesComboBox_activated(int index)
     updateUiAccordingToPortState( _port->isOpen(), selPortName );
 }
 
-void MainWindow::getPortSetting(QSerialPort* port, SerialSetupDialog::PortSettings& settings)
+void MainWindow::getPortSetting(SerialPortEngine* port, SerialSetupDialog::PortSettings& settings)
 {
     if (port)
     {
-        settings.BaudRate  = (QSerialPort::BaudRate) port->baudRate();
-        settings.DataBits = port->dataBits();
-        settings.FlowControl = port->flowControl();
-        settings.Parity = port->parity();
-        settings.StopBits = port->stopBits();
-        settings.Timeout_Millisec = port->getTimeout();
+        port->getSettings(settings);
     }
 }
 
-void MainWindow::setPortSetting(QSerialPort* port, const SerialSetupDialog::PortSettings& settings)
+void MainWindow::setPortSetting(SerialPortEngine* port, const SerialSetupDialog::PortSettings& settings)
 {
     if (port)
     {
-        port->setBaudRate(settings.BaudRate);
-        port->setDataBits(settings.DataBits);
-        port->setFlowControl(settings.FlowControl);
-        port->setParity(settings.Parity);
-        port->setStopBits(settings.StopBits);
-        port->setTimeout(settings.Timeout_Millisec);
+        QStringList rejected = port->setSettings(settings);
+        if (!rejected.isEmpty())
+        {
+            rxAccumulator->flush();
+            logError(QString("Port settings not applied: %1 (%2)").arg(rejected.join(", "), port->errorString()));
+        }
+
+        // arbitrary rates come from the device clock divider, show what it really runs at
+        qint32 actual = port->actualBaudRate();
+        if (actual > 0 && actual != settings.BaudRate)
+            logOpGray(QString("Baud rate %1 requested, the device runs at %2").arg(settings.BaudRate).arg(actual));
     }
 }
 
+void MainWindow::updateRxTiming()
+{
+    const SerialSetupDialog::PortSettings& ps = portSettings;
+    double stop_bits = (ps.StopBits == QSerialPort::TwoStop) ? 2.0 : (ps.StopBits == QSerialPort::OneAndHalfStop) ? 1.5 : 1.0;
+    qint64 char_ns   = RxAccumulator::charTime(ps.BaudRate, ps.DataBits, ps.Parity != QSerialPort::NoParity, stop_bits);
+
+    rxAccumulator->setCharTime(char_ns);
+    rxAccumulator->setGapSplit( (outopt & OUTOPT_SPLIT_ON_GAP) ? RxAccumulator::frameGap(rx_frame_gap, ps.BaudRate, char_ns) : 0 );
+}
+
 void MainWindow::on_setupBtn_clicked()
 {
     if (_port->isOpen()) {
@@ -904,6 +1069,7 @@ void MainWindow::on_setupBtn_clicked()
         if (_port->isOpen()) {
             setPortSetting(_port, portSettings);
         }
+        updateRxTiming();
     }
 }
 
@@ -957,7 +1123,8 @@ void MainWindow::on_actEditSave_triggered()
         return;
     }
 
-    file.write(ui->binaryEditor->getInputConstData());
+    InputDataView view = ui->binaryEditor->getInputView();
+    file.write(view.ptr(), view.size());
 }
 
 void MainWindow::on_actEditOpen_triggered()
@@ -983,22 +1150,255 @@ void MainWindow::on_actEditOpen_triggered()
                           );
     if ( file_name.isEmpty() ) return;
 
-    QFile  file(file_name);
-    if (! file.open(QIODevice::ReadOnly) )
+    QString error;
+    if (! ui->binaryEditor->openFile(file_name, &error) )
+    {
+        displayErrorMessage(error);
+    }
+}
+
+
+void MainWindow::on_actMonitorPorts_triggered()
+{
+    if (!monitorWindow)
+    {
+        monitorWindow = new MonitorWindow(portSettings, this);
+    }
+    monitorWindow->show();
+    monitorWindow->raise();
+    monitorWindow->activateWindow();
+}
+
+void MainWindow::on_actSendFile_triggered()
+{
+    if (fileSender->isActive())
     {
-        displayErrorMessage(QString("Cannot open for reading file: %1").arg(file_name) );
+        fileSender->cancel();
         return;
     }
+    if (! _port->isOpen() ) return;
 
+    QString file_name = QFileDialog::getOpenFileName(this,
+                             tr("Send file"),
+                             QString(),
+                             tr("All files (*.*)")
+                          );
+    if ( file_name.isEmpty() ) return;
 
-    QByteArray data = file.readAll();
-    ui->binaryEditor->setInputData( data );
+    // Display everything received so far before the transfer starts
+    rxAccumulator->flush();
+
+    if (! fileSender->start(file_name) )
+    {
+        logError(QString("Cannot send file %1: %2").arg(file_name, fileSender->errorString()));
+        return;
+    }
+    if (! fileSender->isActive() ) return;  // empty file, already finished
+
+    last_tx_time = HiResClock::now();
+    logOpGray(QString(">>> Sending file %1 (%2 bytes)...").arg(QFileInfo(file_name).fileName()).arg(fileSender->totalSize()));
+
+    ui->actSendFile->setText(tr("Stop sending"));
+    ui->actSendFile->setToolTip(tr("Stop sending file"));
+    ui->sendBtn->setEnabled(false);
+    lbTxStatus->setVisible(true);
+    txProgress->setValue(0);
+    txProgress->setVisible(true);
+}
+
+void MainWindow::onFileSendProgress(qint64 sent, qint64 total)
+{
+    qint64 eta = fileSender->eta();
+
+    txProgress->setValue( total ? static_cast<int>(sent * 1000 / total) : 1000 );
+    lbTxStatus->setText( QString("%1 / %2 kB, %3 kB/s, ETA %4")
+                         .arg(sent / 1024).arg(total / 1024)
+                         .arg(fileSender->rate() / 1024, 0, 'f', 1)
+                         .arg( (eta < 0) ? QString("--:--")
+                                         : QTime(0, 0).addMSecs(static_cast<int>(eta)).toString( (eta >= 3600000) ? "hh:mm:ss" : "mm:ss" ) ) );
+}
+
+void MainWindow::onFileSendFinished(bool ok)
+{
+    QString summary = QString("%1 of %2 bytes in %3 s (%4 kB/s)")
+            .arg(fileSender->bytesSent()).arg(fileSender->totalSize())
+            .arg(fileSender->elapsed() / 1000.0, 0, 'f', 3)
+            .arg(fileSender->rate() / 1024, 0, 'f', 1);
+
+    if (ok)
+        logOpGray(QString("<<< File sent: %1").arg(summary));
+    else
+        logError(QString("File transfer stopped: %1. %2").arg(fileSender->errorString(), summary));
+
+    ui->actSendFile->setText(tr("Send file"));
+    ui->actSendFile->setToolTip(tr("Send file to the port"));
+    ui->sendBtn->setEnabled(_port->isOpen());
+    lbTxStatus->setVisible(false);
+    txProgress->setVisible(false);
+}
+
+void MainWindow::on_actReplayCapture_triggered()
+{
+    static const double speeds[] = { 1.0, 2.0, 10.0, 0.0 };
+    QStringList         items;
+    bool                ok;
+
+    if (replayDevice->isActive())
+    {
+        replayDevice->stop();
+        onReplayFinished(true);
+        return;
+    }
+
+    // Replayed data goes through the receive path, it must not mix with live traffic
+    if (_port->isOpen())
+    {
+        logError("Disconnect the port before replaying a capture");
+        return;
+    }
+
+    QString file_name = QFileDialog::getOpenFileName(this,
+                             tr("Replay capture"),
+                             QString(),
+                             tr("Capture files (*.cap);;All files (*.*)")
+                          );
+    if ( file_name.isEmpty() ) return;
+
+    items << tr("Recorded speed") << tr("2x") << tr("10x") << tr("As fast as possible");
+    QString speed = QInputDialog::getItem(this, tr("Replay capture"), tr("Speed:"), items, 0, false, &ok);
+    if (!ok) return;
+
+    if (!replayDevice->open(file_name))
+    {
+        logError(replayDevice->errorString());
+        return;
+    }
+    replayDevice->setSpeed( speeds[ qMax(items.indexOf(speed), 0) ] );
+
+    rxAccumulator->flush();
+    logOpGray(QString("Replaying %1 (%2)...%3").arg(QFileInfo(file_name).fileName(), speed,
+                                                    logFile ? " Capture suspended." : ""));
+    log_suspended = true;
+
+    ui->actReplayCapture->setText(tr("Stop replay"));
+    replayDevice->start();
+}
+
+void MainWindow::onReplayRxData(const QByteArray &data, qint64 time_ns)
+{
+    rxAccumulator->append(data.constData(), data.size(), time_ns);
+}
+
+void MainWindow::onReplayTxData(const QByteArray &data, qint64 time_ns)
+{
+    rxAccumulator->flush();
+    last_tx_time = time_ns;
+    if (outopt & OUTOPT_SHOW_INPUT)
+    {
+        logOperationAt(time_ns, QString(">>> Sent %1 bytes").arg(data.size()), "gray");
+        outData( OutputRecordStore::REC_TX, data, time_ns );
+    }
+}
+
+void MainWindow::onReplayFinished(bool ok)
+{
+    rxAccumulator->flush();
+    log_suspended = false;
+
+    QString summary = QString("%1 records, %2 bytes, %3 of capture")
+            .arg(replayDevice->recordsReplayed()).arg(replayDevice->bytesReplayed())
+            .arg(HiResClock::duration(replayDevice->position() * 1000));
+
+    if (ok)
+        logOpGray(QString("Replay finished: %1").arg(summary));
+    else
+        logError(QString("Replay stopped: %1. %2").arg(replayDevice->errorString(), summary));
+
+    replayDevice->close();
+    ui->actReplayCapture->setText(tr("Replay capture"));
+}
+
+void MainWindow::on_actLatencyProbe_triggered()
+{
+    InputMode* inm = currentInputMode();
+    QByteArray probe;
+    bool       ok;
+
+    if (! _port->isOpen() ) return;
+
+    int rounds = QInputDialog::getInt(this, tr("Latency probe"), tr("Rounds:"), 20, 1, 10000, 1, &ok);
+    if (!ok) return;
+
+    // editor content is the request, a loopback just echoes it
+    if (inm) probe = inm->getEditorData();
+    if (probe.isEmpty()) probe = QByteArray(1, 'U');
+
+    // the profile the port really runs with, it may have been refused
+    SerialSetupDialog::PortSettings actual;
+    getPortSetting(_port, actual);
+
+    rxAccumulator->flush();
+    logOpGray(QString(">>> Latency probe: %1 rounds of %2 bytes%3...")
+              .arg(rounds).arg(probe.size())
+              .arg(actual.LowLatency ? ", low latency" : ""));
+
+    _port->startLatencyProbe(probe, rounds, (portSettings.Timeout_Millisec > 0) ? portSettings.Timeout_Millisec : 1000);
+}
+
+void MainWindow::onLatencyProbeFinished(int replies, int rounds, qint64 min_ns, qint64 avg_ns, qint64 max_ns)
+{
+    rxAccumulator->flush();
+    if (!replies)
+    {
+        logError(QString("Latency probe: no reply in %1 rounds").arg(rounds));
+        return;
+    }
+    logOpGray(QString("<<< Latency probe: %1 of %2 replied, min %3, avg %4, max %5")
+              .arg(replies).arg(rounds)
+              .arg(HiResClock::duration(min_ns), HiResClock::duration(avg_ns), HiResClock::duration(max_ns)));
+}
+
+QString MainWindow::formatLineCounters(const QSerialPort::LineCounters& c)
+{
+    return QString("RX %1 TX %2 FE %3 PE %4 OE %5 BO %6 BRK %7")
+            .arg(c.rxBytes).arg(c.txBytes)
+            .arg(c.frameErrors).arg(c.parityErrors)
+            .arg(c.overruns).arg(c.bufferOverruns).arg(c.breaks);
+}
+
+void MainWindow::onLineCountersChanged(const QSerialPort::LineCounters& counters, qint64 time_ns)
+{
+    // a poll queued before the close, the totals were taken on closing
+    if (! _port->isOpen() ) return;
+
+    checkLineCounters(counters, time_ns);
 }
 
+void MainWindow::checkLineCounters(const QSerialPort::LineCounters& counters, qint64 time_ns)
+{
+    const QSerialPort::LineCounters& old = line_counters;
+    QStringList errors;
+
+    if (counters.frameErrors    > old.frameErrors)    errors << QString("%1 framing").arg(counters.frameErrors - old.frameErrors);
+    if (counters.parityErrors   > old.parityErrors)   errors << QString("%1 parity").arg(counters.parityErrors - old.parityErrors);
+    if (counters.overruns       > old.overruns)       errors << QString("%1 overrun").arg(counters.overruns - old.overruns);
+    if (counters.bufferOverruns > old.bufferOverruns) errors << QString("%1 buffer overrun").arg(counters.bufferOverruns - old.bufferOverruns);
+    if (counters.breaks         > old.breaks)         errors << QString("%1 break").arg(counters.breaks - old.breaks);
+
+    line_counters = counters;
+    lbLineStatus->setText(formatLineCounters(counters));
+
+    if (!errors.isEmpty())
+    {
+        // keep the errors after the data received before them
+        rxAccumulator->flush();
+        logOperationAt(time_ns, QString("Line errors: %1 (%2)").arg(errors.join(", "), formatLineCounters(counters)), "red", "b");
+    }
+}
 
 void MainWindow::on_actOutNew_triggered()
 {
-    if ( ui->outputTextEdit->document()->isEmpty() ) return;
+    if ( ui->outputView->isEmpty() ) return;
 
 
     if ( QMessageBox::question(
@@ -1009,13 +1409,14 @@ void MainWindow::on_actOutNew_triggered()
                 QMessageBox::Cancel
             ) == QMessageBox::Yes )
     {
-        ui->outputTextEdit->clear();
+        rxAccumulator->clear();
+        ui->outputView->clear();
     }
 }
 
 void MainWindow::on_actOutSave_triggered()
 {
-    if ( ui->outputTextEdit->document()->isEmpty() ) return;
+    if ( ui->outputView->isEmpty() ) return;
 
     QString sel_filters;
     QString file_name = QFileDialog::getSaveFileName(this,
@@ -1033,11 +1434,10 @@ void MainWindow::on_actOutSave_triggered()
         return;
     }
 
-    QByteArray content = (sel_filters.startsWith("HTML"))
-            ? ui->outputTextEdit->document()->toHtml().toUtf8()
-            : ui->outputTextEdit->document()->toPlainText().toLocal8Bit() ;
-
-    file.write(content);
+    if (! ui->outputView->save(&file, (sel_filters.startsWith("HTML")) ? QBinStrConv::HTML : QBinStrConv::PLAIN_TEXT) )
+    {
+        displayErrorMessage(QString("Cannot write to file: %1").arg(file_name) );
+    }
 
 }
 
@@ -1071,6 +1471,7 @@ void MainWindow::onSerialPortError(QSerialPort::SerialPortError error)
 {
     if (error != QSerialPort::NoError)
     {
+        rxAccumulator->flush();
         logError(QString("Serial Port Error: ").append(getSerialPortErrorString(error)) );
     }
 }
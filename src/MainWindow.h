@@ -21,10 +21,12 @@
 #include <QComboBox>
 #include <QTime>
 #include <QLabel>
+#include <QProgressBar>
 #include <QVariantList>
 #include <QVariantMap>
 #include <QFile>
 #include <QString>
+#include <QPointer>
 
 #include "QSerialPort"
 
@@ -36,6 +38,14 @@
 #include "InputHistoryList.h"
 
 #include "BinaryEditor.h"
+#include "RxAccumulator.h"
+#include "SerialPortEngine.h"
+#include "OutputView.h"
+#include "CaptureLog.h"
+#include "HiResClock.h"
+#include "FileSender.h"
+#include "CaptureReplayDevice.h"
+#include "MonitorWindow.h"
 
 extern void displayErrorMessage(const QString& err);
 
@@ -104,15 +114,24 @@ protected:
     QBinStrConv*         display_converter;
 
     QVariantList         history;
+    quint32              history_version;   /* editor data version added last to history */
     QVariantMap          macros;
 
 public:
     bool       isValid()       { return (editor && display_converter); }
-    QByteArray        getEditorData() { return (editor) ? editor->getInputData(): QByteArray() ; }
-    const QByteArray* getEditorConstData() { return (editor) ? &editor->getInputConstData(): NULL ; }
+    InputDataView     getEditorView() { return (editor) ? editor->getInputView(): InputDataView() ; }
+    QByteArray        getEditorData() { return getEditorView().bytes(); }
     void       setEditorData(QByteArray& data) { if (editor) editor->setInputData(data); }
 
-    void       addHistoryEntry(QByteArray* entry) { InputHistoryList::Add(&history,entry); }
+    void       addHistoryEntry(const InputDataView& entry)
+    {
+        // The same version sent again is already the newest entry
+        if (entry.version() == history_version && !history.isEmpty()) return;
+
+        QByteArray bytes = entry.bytes();
+        InputHistoryList::Add(&history,&bytes);
+        history_version = entry.version();
+    }
     void       addMacroEntry(QString& name, QByteArray& entry)
     {
         macros[name] = entry;
@@ -147,34 +166,30 @@ public:
     explicit MainWindow(QWidget *parent = 0);
     ~MainWindow();
 
-    typedef enum {
-        INMODE_HEX,
-        INMODE_ASCII,
-        INMODE_CSTR,
-
-        __INMODES_CNT
-    } input_modes_t;
-
-    typedef enum {
-        OUTMODE_HEX,
-        OUTMODE_ASCII,
-        OUTMODE_CSTR,
-
-        __OUTMODES_CNT
-    } output_modes_t;
-
     typedef enum {
         OUTOPT_SHOW_INPUT    = 0x0001,
         OUTOPT_SHOW_OUT_INFO = 0x0002,
+        OUTOPT_SPLIT_ON_GAP  = 0x0004,   /* frames end at line idle gaps instead of flush interval */
 
         __OUTOPT_CNT
     } output_options_t;
 
 protected:
     QConvValidator inputValidator;
-    QSerialPort*   _port;
+    SerialPortEngine* _port;
+    RxAccumulator* rxAccumulator;
+    int            rx_flush_interval;
+    int            rx_flush_threshold;
+    int            rx_frame_gap;     /* tenths of a character, see RxAccumulator::frameGap() */
+    qint64         last_tx_time;     /* HiResClock, 0 - nothing sent yet */
+    FileSender*    fileSender;
+    CaptureReplayDevice* replayDevice;
+    int            tx_queue_limit;   /* bytes written but not sent yet, see SerialPortEngine::write() */
+    QPointer<MonitorWindow> monitorWindow;
 
     qint64 sendData(const QByteArray &data );
+    void   updateRxTiming();
+    static QString dataTitle(InputMode& inm, const QByteArray& data);
 
     void updateUiAccordingToPortState(bool is_open, const QString& portName);
     void updateUiAccordingToPinoutSignals(QSerialPort::PinoutSignals pinoutSignals);
@@ -195,8 +210,21 @@ private:
     QLabel* lbSize;
     QLabel* lbOverwriteMode;
     QLabel* lbSum;
-
-    QFile*  logFile;
+    QProgressBar* txProgress;       /* file transfer, main status bar */
+    QLabel*       lbTxStatus;
+    QLabel*       lbLineStatus;     /* line counters of the open port */
+    QSerialPort::LineCounters line_counters;
+
+    static QString formatLineCounters(const QSerialPort::LineCounters& c);
+    /** Logs errors counted since the last update and shows the counters */
+    void           checkLineCounters(const QSerialPort::LineCounters& counters, qint64 time_ns);
+
+    CaptureLogWriter* logFile;      /* binary capture, see CaptureLog::exportFile() */
+    int               log_commit_interval;
+    int               log_queue_limit;
+    bool              log_overrun;  /* records dropped, reported once per episode */
+    bool              log_suspended;/* replay in progress, its data is not a real traffic */
+    void              checkLogWrite(bool written);
 
     QString  getDefaultLogFileName();
     void     openLogFile(const QString logFileName);
@@ -225,42 +253,35 @@ private:
 
 
     void          updateConfig(cfg_operations_t operation);
-    void getPortSetting(QSerialPort *port, SerialSetupDialog::PortSettings &settings);
-    void setPortSetting(QSerialPort *port, const SerialSetupDialog::PortSettings &settings);
+    void getPortSetting(SerialPortEngine *port, SerialSetupDialog::PortSettings &settings);
+    void setPortSetting(SerialPortEngine *port, const SerialSetupDialog::PortSettings &settings);
     void updatePortConfig(cfg_operations_t operation);
 public:
     void log(const QString& msg, const char* color = "black", const char* fmt="i")
     {
-        outHtml(QString("<br /><%3><font color=\"%2\">%1</font></%3>\n")
-              .arg(msg).arg(color).arg(fmt));
+        outMessage(msg, color, fmt);
     }
 
     void logOperation(const QString& msg, const char* color = "black", const char* fmt="i")
     {
-        outHtml(QString("<br /><%3><font color=\"%2\">[%4] %1</font></%3>\n")
-               .arg(msg).arg(color).arg(fmt)
-               .arg(QTime::currentTime().toString("hh:mm:ss.zzz")));
+        logOperationAt(HiResClock::now(), msg, color, fmt);
+    }
+    /** Event stamped with its own time (HiResClock), e.g. arrival of received data */
+    void logOperationAt(qint64 time_ns, const QString& msg, const char* color = "black", const char* fmt="i")
+    {
+        outMessage(QString("[%1] %2").arg(HiResClock::timeOfDay(time_ns), msg), color, fmt);
     }
     void logOpBlue(const QString& msg) { logOperation(msg,"blue"); }
     void logOpGray(const QString& msg) { logOperation(msg,"gray"); }
     void logOpGreen(const QString& msg) { logOperation(msg,"green"); }
 
-    void logError(const QString& msg) { outHtml(QString("<b><font color=\"red\">ERROR: %1</font></b>").arg(msg)); }
+    void logError(const QString& msg) { outMessage(QString("ERROR: %1").arg(msg), "red", "b"); }
     void displayErrMsg(const QString& msg);
 
-    void outPlainText(const QString& msg)
-    {
-        if (logFile) logFile->write( msg.toLatin1() );
-        ui->outputTextEdit->appendPlainText(msg);
-    }
-    void outHtml(const QString& msg)
-    {
-        if (logFile){
-            logFile->write( msg.toLatin1() );
-            logFile->write("<br />\n");
-        }
-        ui->outputTextEdit->appendHtml(msg);
-    }
+    /** Plain text message, fmt is "i" (italic) or "b" (bold) */
+    void outMessage(const QString& msg, const char* color, const char* fmt);
+    /** time_ns - HiResClock time of the data, 0 - now */
+    void outData(OutputRecordStore::record_kind_t kind, const QByteArray& data, qint64 time_ns = 0);
 
     const char* getSerialPortErrorString(QSerialPort::SerialPortError error);
 
@@ -288,7 +309,16 @@ private slots:
     void on_devicesComboBox_onShowPopup();
 
     void onReadyRead();
+    void onRxOverrun();
+    void onRxFrameReady(const QByteArray& data, int chunks, qint64 time_ns, qint64 gap_ns);
     void onBytesWritten( qint64 bytes );
+    void onFileSendProgress(qint64 sent, qint64 total);
+    void onFileSendFinished(bool ok);
+    void onReplayRxData(const QByteArray& data, qint64 time_ns);
+    void onReplayTxData(const QByteArray& data, qint64 time_ns);
+    void onReplayFinished(bool ok);
+    void onLatencyProbeFinished(int replies, int rounds, qint64 min_ns, qint64 avg_ns, qint64 max_ns);
+    void onLineCountersChanged(const QSerialPort::LineCounters& counters, qint64 time_ns);
     void onSerialPortError(QSerialPort::SerialPortError error);
     void onLineChanged(bool set);
     void onSerialLinesChanged(QSerialPort::PinoutSignals signals_mask);
@@ -305,6 +335,10 @@ private slots:
     void on_actEditNew_triggered();
     void on_actEditSave_triggered();
     void on_actEditOpen_triggered();
+    void on_actSendFile_triggered();
+    void on_actMonitorPorts_triggered();
+    void on_actReplayCapture_triggered();
+    void on_actLatencyProbe_triggered();
 };
 
 extern MainWindow w;
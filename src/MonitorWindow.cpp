@@ -0,0 +1,219 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Multi-port monitor: port list, merged frame view and status
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#include <QtSerialPort/QSerialPortInfo>
+#include <QListWidgetItem>
+
+#include "MonitorWindow.h"
+#include "ui_MonitorWindow.h"
+#include "OutputView.h"
+#include "RxAccumulator.h"
+#include "HiResClock.h"
+#include "strbinconv.h"
+
+#include "debug.h"
+
+// ******************************************************************************** C L A S S:  MonitorWindow
+
+MonitorWindow::MonitorWindow(const SerialSetupDialog::PortSettings &settings, QWidget *parent)
+    : QWidget(parent, Qt::Window)
+    , ui(new Ui::MonitorWindow)
+    , sessions(new SessionManager(this))
+    , settings(settings)
+{
+    ui->setupUi(this);
+    setAttribute(Qt::WA_DeleteOnClose);
+
+    ui->splitter->setStretchFactor(0, 0); // ports
+    ui->splitter->setStretchFactor(1, 1); // output
+
+    display_convs[0] = QBinStrConvCollection::getConv(QBinStrConvCollection::CONV_HEX);
+    display_convs[1] = QBinStrConvCollection::getConv(QBinStrConvCollection::CONV_ASCII);
+    display_convs[2] = QBinStrConvCollection::getConv(QBinStrConvCollection::CONV_CSTR);
+    for (int cnt = 0; cnt < __OUTMODES_CNT; cnt++)
+    {
+        ui->DisplayModeCombo->addItem(display_convs[cnt]->getName(), cnt);
+    }
+    ui->mergedView->setDisplayConv(display_convs[0]);
+
+    status_timer.setSingleShot(true);
+    status_timer.setInterval(STATUS_INTERVAL);
+    ASSERT_ALWAYS( connect(&status_timer, SIGNAL(timeout()), SLOT(updateStatus()) ) );
+
+    ASSERT_ALWAYS( connect(sessions, SIGNAL(sessionClosed(PortSession*)), SLOT(onSessionClosed(PortSession*)) ) );
+
+    createDevicesList();
+    updateStatus();
+}
+
+MonitorWindow::~MonitorWindow()
+{
+    // sessions deliver their last frames while being closed, views must still exist
+    sessions->closeAll();
+    delete ui;
+}
+
+void MonitorWindow::createDevicesList()
+{
+    QList<QSerialPortInfo> ports = QSerialPortInfo::availablePorts();
+
+    ui->portsList->blockSignals(true);
+    ui->portsList->clear();
+    for (int i = 0; i < ports.size(); i++)
+    {
+        const QSerialPortInfo& info = ports.at(i);
+        QListWidgetItem*       item = new QListWidgetItem(QString("%1\t- %2").arg(info.portName()).arg(info.description()), ui->portsList);
+
+        item->setData(Qt::UserRole, info.portName());
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(sessions->find(info.portName()) ? Qt::Checked : Qt::Unchecked);
+    }
+    ui->portsList->blockSignals(false);
+}
+
+void MonitorWindow::updateStatus()
+{
+    qint64 bytes = 0;
+
+    status_timer.stop();
+
+    for (int i = 0; i < sessions->sessions().size(); i++)
+    {
+        bytes += sessions->sessions().at(i)->bytesReceived();
+    }
+    ui->statusLabel->setText(QString("%1 ports open on %2 I/O threads, %3 bytes received")
+                             .arg(sessions->sessions().size())
+                             .arg(sessions->ioThreadCount())
+                             .arg(bytes));
+}
+
+int MonitorWindow::gapChars10() const
+{
+    return ui->splitOnGapBox->isChecked() ? static_cast<int>(RxAccumulator::MODBUS_GAP_CHARS10) : 0;
+}
+
+void MonitorWindow::on_refreshBtn_clicked()
+{
+    createDevicesList();
+}
+
+void MonitorWindow::on_setupBtn_clicked()
+{
+    if (!SerialSetupDialog::Excecute(settings, QString(), this)) return;
+
+    for (int i = 0; i < sessions->sessions().size(); i++)
+    {
+        sessions->sessions().at(i)->setSettings(settings, gapChars10());
+    }
+}
+
+void MonitorWindow::on_clearBtn_clicked()
+{
+    ui->mergedView->clear();
+    for (QMap<PortSession*, OutputView*>::iterator it = views.begin(); it != views.end(); ++it)
+    {
+        it.value()->clear();
+    }
+}
+
+void MonitorWindow::on_DisplayModeCombo_activated(int index)
+{
+    QBinStrConv* conv = display_convs[ qBound(0, index, __OUTMODES_CNT-1) ];
+
+    ui->mergedView->setDisplayConv(conv);
+    for (QMap<PortSession*, OutputView*>::iterator it = views.begin(); it != views.end(); ++it)
+    {
+        it.value()->setDisplayConv(conv);
+    }
+}
+
+void MonitorWindow::on_splitOnGapBox_toggled(bool checked)
+{
+    (void) checked;
+
+    for (int i = 0; i < sessions->sessions().size(); i++)
+    {
+        sessions->sessions().at(i)->setSettings(settings, gapChars10());
+    }
+}
+
+void MonitorWindow::on_portsList_itemChanged(QListWidgetItem *item)
+{
+    QString      name    = item->data(Qt::UserRole).toString();
+    PortSession* session = sessions->find(name);
+
+    if (item->checkState() == Qt::Checked && !session)
+    {
+        QString error;
+
+        session = sessions->open(name, settings, gapChars10(), &error);
+        if (!session)
+        {
+            ui->mergedView->appendMessage(QString("Cannot open port: %1. Error: %2").arg(name, error), Qt::red);
+            ui->portsList->blockSignals(true);
+            item->setCheckState(Qt::Unchecked);
+            ui->portsList->blockSignals(false);
+            return;
+        }
+
+        OutputView* view = new OutputView();
+        view->setDisplayConv(ui->mergedView->displayConv());
+        views.insert(session, view);
+        ui->tabs->addTab(view, name);
+
+        ASSERT_ALWAYS( connect(session, SIGNAL(frameReady(PortSession*,QByteArray,qint64)), SLOT(onFrameReady(PortSession*,QByteArray,qint64)) ) );
+        ASSERT_ALWAYS( connect(session, SIGNAL(errorOccurred(PortSession*,QString)), SLOT(onSessionError(PortSession*,QString)) ) );
+
+        ui->mergedView->appendMessage(QString("%1 opened").arg(name), QColor(session->color()));
+    }
+    else if (item->checkState() != Qt::Checked && session)
+    {
+        sessions->close(session);
+    }
+    updateStatus();
+}
+
+void MonitorWindow::onFrameReady(PortSession *session, const QByteArray &data, qint64 time_ns)
+{
+    qint64 time = HiResClock::toMSecsSinceEpoch(time_ns);
+
+    ui->mergedView->appendMessage(QString("%1  %2").arg(HiResClock::timeOfDay(time_ns), session->portName()),
+                                  QColor(session->color()), OutputRecordStore::STYLE_BOLD);
+    ui->mergedView->appendData(OutputRecordStore::REC_RX, data, time);
+
+    OutputView* view = views.value(session);
+    if (view) view->appendData(OutputRecordStore::REC_RX, data, time);
+
+    // Byte count follows frames with a delay, at most one refresh per interval
+    if (!status_timer.isActive()) status_timer.start();
+}
+
+void MonitorWindow::onSessionError(PortSession *session, const QString &message)
+{
+    ui->mergedView->appendMessage(QString("%1: %2").arg(session->portName(), message), Qt::red);
+}
+
+void MonitorWindow::onSessionClosed(PortSession *session)
+{
+    OutputView* view = views.take(session);
+
+    if (view)
+    {
+        ui->tabs->removeTab(ui->tabs->indexOf(view));
+        delete view;
+    }
+    ui->mergedView->appendMessage(QString("%1 closed, %2 bytes in %3 frames")
+                                  .arg(session->portName()).arg(session->bytesReceived()).arg(session->framesReceived()),
+                                  QColor(session->color()));
+}
@@ -0,0 +1,82 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Window showing traffic of many ports at once
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#ifndef MONITORWINDOW_H
+#define MONITORWINDOW_H
+
+#include <QWidget>
+#include <QMap>
+#include <QTimer>
+
+#include "serialsetupdialog.h"
+#include "SessionManager.h"
+
+class QListWidgetItem;
+class QBinStrConv;
+class OutputView;
+
+namespace Ui {
+class MonitorWindow;
+}
+
+// ******************************************************************************** C L A S S:  MonitorWindow
+/**
+ * Receive-only monitor of several ports (SessionManager). Every checked
+ * port gets a tab of its own, the "All ports" tab is a single timeline:
+ * each frame is headed by its port name and arrival time, in the port's
+ * color. The timeline is in delivery order, frames of different ports
+ * which came within one flush interval may be swapped - the arrival
+ * stamps are exact. The status line is refreshed at most every
+ * STATUS_INTERVAL ms, not per frame.
+ */
+class MonitorWindow : public QWidget
+{
+    Q_OBJECT
+public:
+    enum {
+        __OUTMODES_CNT  = 3,
+        STATUS_INTERVAL = 250   /* ms */
+    };
+
+    explicit MonitorWindow(const SerialSetupDialog::PortSettings& settings, QWidget* parent = 0);
+    ~MonitorWindow();
+
+private slots:
+    void    on_refreshBtn_clicked();
+    void    on_setupBtn_clicked();
+    void    on_clearBtn_clicked();
+    void    on_DisplayModeCombo_activated(int index);
+    void    on_splitOnGapBox_toggled(bool checked);
+    void    on_portsList_itemChanged(QListWidgetItem* item);
+
+    void    onFrameReady(PortSession* session, const QByteArray& data, qint64 time_ns);
+    void    onSessionError(PortSession* session, const QString& message);
+    void    onSessionClosed(PortSession* session);
+    void    updateStatus();
+
+private:
+    Q_DISABLE_COPY(MonitorWindow)
+
+    void    createDevicesList();
+    int     gapChars10() const;
+
+    Ui::MonitorWindow*              ui;
+    SessionManager*                 sessions;
+    SerialSetupDialog::PortSettings settings;
+    QBinStrConv*                    display_convs[__OUTMODES_CNT];
+    QMap<PortSession*, OutputView*> views;
+    QTimer                          status_timer;   /* pending status update after frames */
+};
+
+#endif // MONITORWINDOW_H
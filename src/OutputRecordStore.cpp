@@ -0,0 +1,67 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Chunked storage of output records
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#include "OutputRecordStore.h"
+
+// ******************************************************************************** C L A S S:  OutputRecordStore
+
+OutputRecordStore::OutputRecordStore()
+    : data_size(0)
+{
+}
+
+int OutputRecordStore::append(record_kind_t kind, const char *data, int size, qint64 time, QRgb color, int style)
+{
+    Record rec;
+
+    if (size < 0) size = 0;
+
+    // Start new chunk if record does not fit into the current one.
+    // Chunk capacity is reserved up front, so append() never moves existing data.
+    if ( chunks.isEmpty() || chunks.last().size() + size > chunks.last().capacity() )
+    {
+        chunks.append( QByteArray() );
+        chunks.last().reserve( (size > CHUNK_SIZE) ? size : CHUNK_SIZE );
+    }
+
+    QByteArray& chunk = chunks.last();
+
+    rec.time   = time;
+    rec.pos    = data_size;
+    rec.chunk  = chunks.size()-1;
+    rec.offset = chunk.size();
+    rec.size   = size;
+    rec.kind   = static_cast<quint8>(kind);
+    rec.style  = static_cast<quint8>(style);
+    rec.color  = color;
+
+    chunk.append(data, size);
+    records.append(rec);
+    data_size += size;
+
+    return records.size()-1;
+}
+
+int OutputRecordStore::appendMessage(const QString &text, qint64 time, QRgb color, int style)
+{
+    QByteArray utf8 = text.toUtf8();
+    return append(REC_MESSAGE, utf8.constData(), utf8.size(), time, color, style);
+}
+
+void OutputRecordStore::clear()
+{
+    chunks.clear();
+    records.clear();
+    data_size = 0;
+}
@@ -0,0 +1,87 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Append-only store of raw records shown in the output area
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#ifndef OUTPUTRECORDSTORE_H
+#define OUTPUTRECORDSTORE_H
+
+#include <QByteArray>
+#include <QVector>
+#include <QString>
+#include <QRgb>
+
+// ******************************************************************************** C L A S S:  OutputRecordStore
+/**
+ * Keeps received/sent data and log messages exactly as they came, without
+ * any formatting. Payloads are packed into large chunks which are never
+ * reallocated, so data pointers stay valid until clear() and memory use is
+ * the raw size plus a small fixed header per record.
+ */
+class OutputRecordStore
+{
+public:
+    typedef enum {
+        REC_RX,         /* data received from the port */
+        REC_TX,         /* data sent to the port */
+        REC_MESSAGE,    /* log message, UTF-8 text */
+
+        __REC_KIND_CNT
+    } record_kind_t;
+
+    typedef enum {
+        STYLE_NORMAL = 0x00,
+        STYLE_ITALIC = 0x01,
+        STYLE_BOLD   = 0x02
+    } record_style_t;
+
+    enum {
+        CHUNK_SIZE = 1024*1024
+    };
+
+    struct Record
+    {
+        qint64  time;       /* ms since epoch */
+        qint64  pos;        /* payload bytes of all previous records */
+        int     chunk;
+        int     offset;
+        int     size;
+        quint8  kind;       /* record_kind_t */
+        quint8  style;      /* set of record_style_t, messages only */
+        QRgb    color;      /* messages only */
+    };
+
+    OutputRecordStore();
+
+    int     append(record_kind_t kind, const char* data, int size, qint64 time, QRgb color = 0, int style = STYLE_NORMAL);
+    int     appendMessage(const QString& text, qint64 time, QRgb color, int style);
+    void    clear();
+
+    int           count() const              { return records.size(); }
+    bool          isEmpty() const            { return records.isEmpty(); }
+    const Record& record(int idx) const      { return records[idx]; }
+    const char*   data(int idx) const        { const Record& r = records[idx]; return chunks[r.chunk].constData() + r.offset; }
+    /** Payload without copying, valid until clear() */
+    QByteArray    bytes(int idx) const       { return QByteArray::fromRawData(data(idx), records[idx].size); }
+    QString       message(int idx) const     { return QString::fromUtf8(data(idx), records[idx].size); }
+
+    qint64        dataSize() const           { return data_size; }
+    /** Payload bytes before the record, idx == count() - total */
+    qint64        dataPos(int idx) const     { return (idx < records.size()) ? records[idx].pos : data_size; }
+
+private:
+    QVector<QByteArray> chunks;
+    QVector<Record>     records;
+    qint64              data_size;
+};
+
+#endif // OUTPUTRECORDSTORE_H
@@ -0,0 +1,670 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Layout and painting of the visible output records
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#include <climits>
+
+#include <QApplication>
+#include <QClipboard>
+#include <QContextMenuEvent>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QKeyEvent>
+#include <QMenu>
+#include <QPainter>
+#include <QScrollBar>
+
+#include "OutputView.h"
+#include "RecordExporter.h"
+
+#include "debug.h"
+
+// ******************************************************************************** C L A S S:  OutputView
+
+OutputView::OutputView(QWidget *parent)
+    : QAbstractScrollArea(parent)
+    , conv(NULL)
+    , hex_conv(NULL)
+    , addr_rgb(0), body_rgb(0), supp_rgb(0)
+    , laid_from(0)
+    , est_byte(0)
+    , line_height(1)
+    , line_ascent(0)
+    , char_width(1)
+    , max_columns(0)
+    , sel_anchor(-1)
+    , sel_cursor(-1)
+    , starts_rec(-1)
+{
+    line_pos.append(0);
+    layout_timer.setSingleShot(true);
+    ASSERT_ALWAYS( connect(&layout_timer, SIGNAL(timeout()), SLOT(layoutStep()) ) );
+
+    viewport()->setCursor(Qt::IBeamCursor);
+    setFocusPolicy(Qt::StrongFocus);
+    updateMetrics();
+}
+
+//======================================================= Content
+
+void OutputView::setDisplayConv(QBinStrConv *conv)
+{
+    this->conv = conv;
+    hex_conv   = dynamic_cast<QBin2HexStrConv*>(conv);
+
+    if (conv)
+    {
+        addr_rgb = QColor(conv->addr_color).rgb();
+        body_rgb = QColor(conv->body_color).rgb();
+        supp_rgb = QColor(conv->supp_color).rgb();
+    }
+    if (hex_conv) hex_conv->getDumpFormat(hex_fmt);
+
+    relayout();
+}
+
+void OutputView::appendData(OutputRecordStore::record_kind_t kind, const QByteArray &data, qint64 time)
+{
+    if (data.isEmpty()) return;
+    if (time < 0) time = QDateTime::currentMSecsSinceEpoch();
+    appendRecord( store.append(kind, data.constData(), data.size(), time) );
+}
+
+void OutputView::appendMessage(const QString &text, const QColor &color, int style)
+{
+    appendRecord( store.appendMessage(text, QDateTime::currentMSecsSinceEpoch(), color.rgb(), style) );
+}
+
+void OutputView::appendRecord(int rec)
+{
+    QScrollBar* vsb    = verticalScrollBar();
+    bool        at_end = vsb->value() >= vsb->maximum();
+
+    int cols;
+
+    line_pos.append( line_pos[rec] + countLines(rec, &cols) );
+    if (cols > max_columns) max_columns = cols;
+    updateScrollBars();
+
+    // Keep following the tail, unless user scrolled back
+    if (at_end) vsb->setValue(vsb->maximum());
+    viewport()->update();
+}
+
+void OutputView::clear()
+{
+    store.clear();
+    line_pos.resize(1);
+    line_pos[0] = 0;
+    laid_from   = 0;
+    layout_timer.stop();
+    starts_rec  = -1;
+    max_columns = 0;
+    sel_anchor  = sel_cursor = -1;
+    updateScrollBars();
+    viewport()->update();
+}
+
+void OutputView::relayout()
+{
+    QScrollBar* vsb     = verticalScrollBar();
+    bool        at_end  = vsb->value() >= vsb->maximum();
+    int         count   = store.count();
+    int         top_rec = count;
+    qint64      top_line;
+    qint64      need    = 2 * (viewport()->height() / line_height + 1);
+    int         cols;
+
+    // record at the top stays on top, unless the view follows the tail
+    if (!at_end) locate(vsb->value(), &top_rec, &top_line);
+
+    // Lay out a couple of pages at the end now, the rest in background
+    starts_rec  = -1;
+    max_columns = 0;
+    laid_from   = count;
+    line_pos.resize(count + 1);
+    line_pos[count] = 0;
+    while (laid_from > 0 && line_pos[count] - line_pos[laid_from] < need)
+    {
+        laid_from--;
+        line_pos[laid_from] = line_pos[laid_from+1] - countLines(laid_from, &cols);
+        if (cols > max_columns) max_columns = cols;
+    }
+    calibrateEstimate();
+
+    sel_anchor  = sel_cursor = -1;
+    updateScrollBars();
+    vsb->setValue( at_end ? vsb->maximum() : static_cast<int>(qMin<qint64>(lineOfRecord(top_rec), INT_MAX)) );
+    viewport()->update();
+
+    if (laid_from > 0) layout_timer.start(0);
+    else               layout_timer.stop();
+}
+
+void OutputView::layoutStep()
+{
+    extendLayout(LAYOUT_SLICE);
+}
+
+void OutputView::extendLayout(int max_ms)
+{
+    QScrollBar*   vsb        = verticalScrollBar();
+    bool          at_end     = vsb->value() >= vsb->maximum();
+    int           top_rec, anchor_rec = -1, cursor_rec = -1;
+    qint64        top_line, anchor_line = 0, cursor_line = 0;
+    int           cols;
+    QElapsedTimer timer;
+
+    if (laid_from == 0) return;
+
+    // Line numbers change below, positions are kept as record + line in record
+    locate(vsb->value(), &top_rec, &top_line);
+    if (sel_anchor >= 0)
+    {
+        locate(sel_anchor, &anchor_rec, &anchor_line);
+        locate(sel_cursor, &cursor_rec, &cursor_line);
+    }
+
+    timer.start();
+    do
+    {
+        for (int cnt = 0; cnt < 256 && laid_from > 0; cnt++)
+        {
+            laid_from--;
+            line_pos[laid_from] = line_pos[laid_from+1] - countLines(laid_from, &cols);
+            if (cols > max_columns) max_columns = cols;
+        }
+    } while ( laid_from > 0 && (max_ms < 0 || timer.elapsed() < max_ms) );
+    calibrateEstimate();
+
+    updateScrollBars();
+    vsb->setValue( at_end ? vsb->maximum() : static_cast<int>(qMin<qint64>(lineOfRecord(top_rec) + top_line, INT_MAX)) );
+    if (anchor_rec >= 0)
+    {
+        sel_anchor = lineOfRecord(anchor_rec) + anchor_line;
+        sel_cursor = lineOfRecord(cursor_rec) + cursor_line;
+    }
+    viewport()->update();
+
+    if (laid_from > 0) layout_timer.start(0);
+}
+
+void OutputView::calibrateEstimate()
+{
+    int    count = store.count();
+    qint64 lines = line_pos[count] - line_pos[laid_from];
+    qint64 recs  = count - laid_from;
+    qint64 bytes = store.dataSize() - store.dataPos(laid_from);
+
+    // lines = records + bytes * est_byte, as observed on the laid out part
+    if (bytes > 0 && lines >= recs) est_byte = static_cast<double>(lines - recs) / bytes;
+    else if (hex_conv)              est_byte = 1.0 / HexDumpEngine(hex_fmt, 0, 1).bytesPerLine();
+    else                            est_byte = 1.0 / TEXT_WRAP;
+}
+
+//======================================================= Layout
+
+qint64 OutputView::scanTextLines(const char *data, int size, QVector<int> *starts, int *longest)
+{
+    qint64 lines = 0;
+    int    pos   = 0;
+    int    end, lim;
+    char   c;
+
+    if (longest) longest[0] = longest[1] = 0;
+
+    while (pos < size)
+    {
+        if (starts) starts->append(pos);
+        lines++;
+
+        lim = (size - pos > TEXT_WRAP) ? pos + TEXT_WRAP : size;
+        for (end = pos; end < lim && data[end] != '\n' && data[end] != '\r'; end++) ;
+
+        if (longest && end - pos > longest[1])
+        {
+            longest[0] = pos;
+            longest[1] = end - pos;
+        }
+
+        if (end < lim)
+        {
+            // line end, CRLF and LFCR pairs count as one
+            c = data[end++];
+            if ( end < size && (data[end] == '\n' || data[end] == '\r') && data[end] != c ) end++;
+        }
+        pos = end;
+    }
+    return lines;
+}
+
+qint64 OutputView::countLines(int rec, int *columns) const
+{
+    const OutputRecordStore::Record& r = store.record(rec);
+
+    if (columns) *columns = 0;
+    if (r.kind == OutputRecordStore::REC_MESSAGE)
+    {
+        if (columns) *columns = store.message(rec).size();
+        return 1;
+    }
+    if (!conv) return 0;
+
+    if (hex_conv)
+    {
+        HexDumpEngine whole(hex_fmt, 0, r.size);
+        if (columns && r.size > 0)
+        {
+            // The first line is a full one, its size is known without formatting
+            HexDumpFormat fmt = hex_fmt;
+            fmt.addrWidth = whole.addressWidth();
+            HexDumpEngine first(fmt, 0, qMin<unsigned long>(r.size, whole.bytesPerLine()));
+            *columns = static_cast<int>(first.outputSize()) - 1;
+        }
+        return whole.lines();
+    }
+
+    if (!columns) return scanTextLines(store.data(rec), r.size, NULL);
+
+    // Only the longest line is converted, escapes may make another one a bit wider
+    int    longest[2];
+    qint64 lines = scanTextLines(store.data(rec), r.size, NULL, longest);
+    QByteArray buf = QByteArray::fromRawData(store.data(rec) + longest[0], longest[1]);
+    *columns = conv->convert(buf, QBinStrConv::PLAIN_TEXT).size();
+    return lines;
+}
+
+const QVector<int>& OutputView::textLineStarts(int rec) const
+{
+    // Lines are painted in order, so caching the last record is enough
+    if (starts_rec != rec)
+    {
+        starts.clear();
+        scanTextLines(store.data(rec), store.record(rec).size, &starts);
+        starts_rec = rec;
+    }
+    return starts;
+}
+
+qint64 OutputView::recordLines(int rec) const
+{
+    return (rec >= laid_from) ? line_pos[rec+1] - line_pos[rec] : countLines(rec);
+}
+
+qint64 OutputView::estimatedLine(int rec) const
+{
+    return rec + static_cast<qint64>(store.dataPos(rec) * est_byte);
+}
+
+qint64 OutputView::lineOfRecord(int rec) const
+{
+    if (rec < laid_from) return estimatedLine(rec);
+    return estimatedLine(laid_from) + line_pos[rec] - line_pos[laid_from];
+}
+
+qint64 OutputView::lineCount() const
+{
+    return lineOfRecord(store.count());
+}
+
+void OutputView::locate(qint64 line, int *rec, qint64 *rec_line) const
+{
+    int    count  = store.count();
+    qint64 prefix = estimatedLine(laid_from);
+
+    *rec_line = 0;
+    if (line >= prefix)
+    {
+        // first record which ends after the line; count - line is past the end
+        qint64 rel = line - prefix + line_pos[laid_from];
+        QVector<qint64>::const_iterator it = qUpperBound(line_pos.constBegin() + laid_from + 1,
+                                                         line_pos.constBegin() + count + 1, rel);
+        *rec = static_cast<int>( it - line_pos.constBegin() ) - 1;
+        if (*rec < count) *rec_line = rel - line_pos[*rec];
+        return;
+    }
+
+    // Estimated part: last record starting at or before the line,
+    // position inside it scaled from the estimated to the real line count
+    int lo = 0, hi = laid_from - 1;
+    while (lo < hi)
+    {
+        int mid = lo + (hi - lo + 1) / 2;
+        if (estimatedLine(mid) <= line) lo = mid;
+        else                            hi = mid - 1;
+    }
+    qint64 start = estimatedLine(lo);
+    qint64 span  = estimatedLine(lo + 1) - start;
+    *rec      = lo;
+    *rec_line = (line - start) * countLines(lo) / span;
+}
+
+//======================================================= Formatting
+
+void OutputView::formatLine(qint64 line, Line *out) const
+{
+    int    rec;
+    qint64 rec_line;
+
+    locate(line, &rec, &rec_line);
+    if (rec >= store.count())
+    {
+        out->text.clear();
+        out->spans.clear();
+        out->style = OutputRecordStore::STYLE_NORMAL;
+        return;
+    }
+    formatLine(rec, rec_line, out);
+}
+
+void OutputView::formatLine(int rec, qint64 rec_line, Line *out) const
+{
+    const OutputRecordStore::Record& r = store.record(rec);
+
+    out->spans.clear();
+    out->style = OutputRecordStore::STYLE_NORMAL;
+
+    if (r.kind == OutputRecordStore::REC_MESSAGE)
+    {
+        out->text  = store.message(rec).replace(QLatin1Char('\n'), QLatin1Char(' ')).trimmed();
+        out->style = r.style;
+        Span s = { 0, out->text.size(), r.color };
+        out->spans.append(s);
+    }
+    else if (hex_conv)
+    {
+        formatHexLine(rec, rec_line, out);
+    }
+    else
+    {
+        formatTextLine(rec, rec_line, out);
+    }
+}
+
+void OutputView::formatHexLine(int rec, qint64 line, Line *out) const
+{
+    const OutputRecordStore::Record& r = store.record(rec);
+    HexDumpFormat  fmt = hex_fmt;
+    HexDumpEngine  whole(fmt, 0, r.size);
+
+    // Same address width in all lines of the record, as if it was dumped at once
+    fmt.addrWidth = whole.addressWidth();
+
+    unsigned long  offset = static_cast<unsigned long>(line) * whole.bytesPerLine();
+    unsigned long  len    = static_cast<unsigned long>(r.size) - offset;
+    if (len > whole.bytesPerLine()) len = whole.bytesPerLine();
+
+    HexDumpEngine  engine(fmt, offset, len);
+    out->text.resize( static_cast<int>(engine.outputSize()) );
+    size_t n = engine.format( reinterpret_cast<const unsigned char*>(store.data(rec)) + offset,
+                              reinterpret_cast<uint16_t*>(out->text.data()) );
+    while (n && out->text.at(static_cast<int>(n-1)) == QLatin1Char('\n')) n--;
+    out->text.resize( static_cast<int>(n) );
+
+    // Colors: address, hex and ascii columns (separated by two spaces)
+    int pos = 0;
+    if (fmt.addrMode != HexDumpFormat::ADDR_NONE)
+    {
+        int w = out->text.indexOf(QLatin1Char(':')) + 1;
+        Span s = { 0, w, addr_rgb };
+        out->spans.append(s);
+        pos = w + 2;
+    }
+    if (fmt.showHex)
+    {
+        int w = qMin(static_cast<int>(engine.hexWidth()), out->text.size() - pos);
+        Span s = { pos, w, body_rgb };
+        out->spans.append(s);
+        pos += w + 2;
+    }
+    if (engine.asciiColumn() && pos < out->text.size())
+    {
+        Span s = { pos, out->text.size() - pos, supp_rgb };
+        out->spans.append(s);
+    }
+}
+
+void OutputView::formatTextLine(int rec, qint64 line, Line *out) const
+{
+    const QVector<int>& st   = textLineStarts(rec);
+    int                 k    = static_cast<int>(line);
+    int                 from = st[k];
+    int                 to   = (k+1 < st.size()) ? st[k+1] : store.record(rec).size;
+    QByteArray          buf  = QByteArray::fromRawData(store.data(rec) + from, to - from);
+
+    out->text = conv->convert(buf, QBinStrConv::PLAIN_TEXT);
+    while ( out->text.endsWith(QLatin1Char('\n')) || out->text.endsWith(QLatin1Char('\r')) ) out->text.chop(1);
+
+    Span s = { 0, out->text.size(), body_rgb };
+    out->spans.append(s);
+}
+
+//======================================================= Painting
+
+void OutputView::updateMetrics()
+{
+    QFontMetrics fm(font());
+    line_height = fm.lineSpacing();
+    line_ascent = fm.ascent();
+    char_width  = fm.width(QLatin1Char('0'));
+    if (line_height < 1) line_height = 1;
+    if (char_width < 1)  char_width = 1;
+}
+
+void OutputView::updateScrollBars()
+{
+    int    page  = viewport()->height() / line_height;
+    int    cols  = (viewport()->width() - 2*MARGIN) / char_width;
+    qint64 vmax  = lineCount() - page;
+
+    if (vmax > INT_MAX) vmax = INT_MAX;
+    if (vmax < 0) vmax = 0;
+
+    verticalScrollBar()->setRange(0, static_cast<int>(vmax));
+    verticalScrollBar()->setPageStep(page);
+    verticalScrollBar()->setSingleStep(1);
+    horizontalScrollBar()->setRange(0, qMax(0, max_columns - cols));
+    horizontalScrollBar()->setPageStep(cols);
+}
+
+void OutputView::paintEvent(QPaintEvent *event)
+{
+    (void) event;
+
+    QPainter  painter(viewport());
+    QFont     fnt   = font();
+    QPalette  pal   = palette();
+    qint64    first = verticalScrollBar()->value();
+    int       count = store.count();
+    int       rows  = viewport()->height() / line_height + 1;
+    int       x0    = MARGIN - horizontalScrollBar()->value() * char_width;
+    qint64    sel_from = qMin(sel_anchor, sel_cursor);
+    qint64    sel_to   = qMax(sel_anchor, sel_cursor);
+    Line      line;
+    int       rec;
+    qint64    rec_line, rec_lines = 0;
+
+    painter.fillRect(viewport()->rect(), pal.base());
+
+    // Only the top line is looked up, the rest follows record by record
+    locate(first, &rec, &rec_line);
+    if (rec < count) rec_lines = recordLines(rec);
+
+    for (int row = 0; row < rows; row++)
+    {
+        while (rec < count && rec_line >= rec_lines)
+        {
+            rec++;
+            rec_line = 0;
+            if (rec < count) rec_lines = recordLines(rec);
+        }
+        if (rec >= count) break;
+
+        qint64 ln       = first + row;
+        int    y        = row * line_height;
+        bool   selected = sel_anchor >= 0 && ln >= sel_from && ln <= sel_to;
+
+        formatLine(rec, rec_line++, &line);
+
+        if (selected) painter.fillRect(0, y, viewport()->width(), line_height, pal.highlight());
+
+        fnt.setItalic( (line.style & OutputRecordStore::STYLE_ITALIC) != 0 );
+        fnt.setBold(   (line.style & OutputRecordStore::STYLE_BOLD)   != 0 );
+        painter.setFont(fnt);
+
+        for (int cnt = 0; cnt < line.spans.size(); cnt++)
+        {
+            const Span& s = line.spans[cnt];
+            painter.setPen( selected ? pal.highlightedText().color() : QColor(s.color) );
+            painter.drawText(x0 + s.start * char_width, y + line_ascent, line.text.mid(s.start, s.len));
+        }
+    }
+}
+
+void OutputView::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBars();
+}
+
+void OutputView::changeEvent(QEvent *event)
+{
+    QAbstractScrollArea::changeEvent(event);
+    if (event->type() == QEvent::FontChange)
+    {
+        updateMetrics();
+        updateScrollBars();
+        viewport()->update();
+    }
+}
+
+//======================================================= Selection
+
+qint64 OutputView::lineAt(const QPoint &pos) const
+{
+    qint64 line = verticalScrollBar()->value() + qMax(0, pos.y()) / line_height;
+    return qMin(line, lineCount()-1);
+}
+
+void OutputView::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton)
+    {
+        qint64 line = lineAt(event->pos());
+        if ( (event->modifiers() & Qt::ShiftModifier) && sel_anchor >= 0 )
+        {
+            sel_cursor = line;
+        }
+        else
+        {
+            sel_anchor = sel_cursor = line;
+        }
+        viewport()->update();
+    }
+    QAbstractScrollArea::mousePressEvent(event);
+}
+
+void OutputView::mouseMoveEvent(QMouseEvent *event)
+{
+    if ( (event->buttons() & Qt::LeftButton) && sel_anchor >= 0 )
+    {
+        // drag beyond the viewport scrolls
+        if (event->pos().y() < 0)
+            verticalScrollBar()->triggerAction(QAbstractSlider::SliderSingleStepSub);
+        else if (event->pos().y() > viewport()->height())
+            verticalScrollBar()->triggerAction(QAbstractSlider::SliderSingleStepAdd);
+
+        sel_cursor = lineAt(event->pos());
+        viewport()->update();
+    }
+    QAbstractScrollArea::mouseMoveEvent(event);
+}
+
+void OutputView::selectAll()
+{
+    if (!lineCount()) return;
+    sel_anchor = 0;
+    sel_cursor = lineCount()-1;
+    viewport()->update();
+}
+
+void OutputView::copy()
+{
+    if (sel_anchor < 0) return;
+
+    // estimated line numbers are not continuous, lay out everything first
+    if (qMin(sel_anchor, sel_cursor) < estimatedLine(laid_from)) extendLayout(-1);
+
+    QString text;
+    Line    line;
+    qint64  to = qMax(sel_anchor, sel_cursor);
+
+    for (qint64 ln = qMin(sel_anchor, sel_cursor); ln <= to; ln++)
+    {
+        formatLine(ln, &line);
+        text += line.text;
+        text += QLatin1Char('\n');
+    }
+    QApplication::clipboard()->setText(text);
+}
+
+void OutputView::keyPressEvent(QKeyEvent *event)
+{
+    if (event == QKeySequence::Copy)
+    {
+        copy();
+    }
+    else if (event == QKeySequence::SelectAll)
+    {
+        selectAll();
+    }
+    else if (event->key() == Qt::Key_Home && (event->modifiers() & Qt::ControlModifier))
+    {
+        verticalScrollBar()->setValue(0);
+    }
+    else if (event->key() == Qt::Key_End && (event->modifiers() & Qt::ControlModifier))
+    {
+        verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+    }
+    else
+    {
+        QAbstractScrollArea::keyPressEvent(event);
+    }
+}
+
+void OutputView::contextMenuEvent(QContextMenuEvent *event)
+{
+    QMenu    menu(this);
+    QAction* act;
+
+    act = menu.addAction(tr("&Copy"), this, SLOT(copy()), QKeySequence::Copy);
+    act->setEnabled(sel_anchor >= 0);
+    act = menu.addAction(tr("Select &All"), this, SLOT(selectAll()), QKeySequence::SelectAll);
+    act->setEnabled(!isEmpty());
+
+    menu.exec(event->globalPos());
+}
+
+//======================================================= Export
+
+bool OutputView::save(QIODevice *dev, QBinStrConv::STR_FORMAT format) const
+{
+    RecordExporter exporter(dev, conv, format);
+
+    if (!exporter.begin()) return false;
+    for (int rec = 0; rec < store.count(); rec++)
+    {
+        if (!exporter.write(store.record(rec), store.data(rec))) return false;
+    }
+    return exporter.end();
+}
@@ -0,0 +1,152 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Virtualized, append-only output area
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#ifndef OUTPUTVIEW_H
+#define OUTPUTVIEW_H
+
+#include <QAbstractScrollArea>
+#include <QTimer>
+#include <QVector>
+#include <QString>
+#include <QColor>
+
+#include "OutputRecordStore.h"
+#include "HexDumpEngine.h"
+#include "strbinconv.h"
+
+class QIODevice;
+
+// ******************************************************************************** C L A S S:  OutputView
+/**
+ * Shows the content of an OutputRecordStore. Nothing is formatted up front:
+ * only a line count per record is kept, and lines are produced by the
+ * current display converter when they are painted. Memory therefore grows
+ * with the raw data only, and painting/scrolling cost depends on the
+ * viewport size, not on the capture length.
+ *
+ * Hex dump lines are cut at record offsets, text lines (ASCII, C-string)
+ * end at CR, LF, CRLF or LFCR and are wrapped after TEXT_WRAP bytes.
+ * Selection works on whole lines.
+ *
+ * Changing the display converter does not lay out the whole capture:
+ * only records at the end (the visible page) are laid out at once, line
+ * numbers of older records are estimated from their size. A background
+ * step lays out further records from the end towards the beginning in
+ * LAYOUT_SLICE ms portions, keeping the top visible line in place, until
+ * all line numbers are exact again.
+ */
+class OutputView : public QAbstractScrollArea
+{
+    Q_OBJECT
+public:
+    enum {
+        TEXT_WRAP    = 256,  /* text modes: max bytes per line */
+        MARGIN       = 4,    /* pixels */
+        LAYOUT_SLICE = 10    /* ms, background layout step */
+    };
+
+    explicit OutputView(QWidget* parent = 0);
+
+    void          setDisplayConv(QBinStrConv* conv);
+    QBinStrConv*  displayConv() const { return conv; }
+
+    /** time - ms since epoch, -1 - now */
+    void    appendData(OutputRecordStore::record_kind_t kind, const QByteArray& data, qint64 time = -1);
+    void    appendMessage(const QString& text, const QColor& color, int style = OutputRecordStore::STYLE_NORMAL);
+
+    bool    isEmpty() const { return store.isEmpty(); }
+    /** Exact once layout is complete, estimated while isLayoutPending() */
+    qint64  lineCount() const;
+    bool    isLayoutPending() const { return laid_from > 0; }
+    const OutputRecordStore& records() const { return store; }
+
+    /** Writes the whole content formatted with the current display converter */
+    bool    save(QIODevice* dev, QBinStrConv::STR_FORMAT format) const;
+
+public slots:
+    void    clear();
+    void    copy();
+    void    selectAll();
+
+protected:
+    void    paintEvent(QPaintEvent* event);
+    void    resizeEvent(QResizeEvent* event);
+    void    changeEvent(QEvent* event);
+    void    mousePressEvent(QMouseEvent* event);
+    void    mouseMoveEvent(QMouseEvent* event);
+    void    keyPressEvent(QKeyEvent* event);
+    void    contextMenuEvent(QContextMenuEvent* event);
+
+private slots:
+    void    layoutStep();
+
+private:
+    struct Span
+    {
+        int  start;
+        int  len;
+        QRgb color;
+    };
+    struct Line
+    {
+        QString       text;
+        QVector<Span> spans;     /* colored parts of the text, in order */
+        int           style;
+    };
+
+    /** columns - if set, receives width of the widest line of the record */
+    qint64  countLines(int rec, int* columns = NULL) const;
+    qint64  recordLines(int rec) const;
+    qint64  estimatedLine(int rec) const;
+    qint64  lineOfRecord(int rec) const;
+    void    locate(qint64 line, int* rec, qint64* rec_line) const;
+    void    calibrateEstimate();
+    /** Lays out records before laid_from for up to max_ms (< 0 - all), keeping view and selection in place */
+    void    extendLayout(int max_ms);
+    void    relayout();
+    void    appendRecord(int rec);
+    void    updateMetrics();
+    void    updateScrollBars();
+    qint64  lineAt(const QPoint& pos) const;
+    void    formatLine(qint64 line, Line* out) const;
+    void    formatLine(int rec, qint64 rec_line, Line* out) const;
+    void    formatHexLine(int rec, qint64 line, Line* out) const;
+    void    formatTextLine(int rec, qint64 line, Line* out) const;
+    const QVector<int>& textLineStarts(int rec) const;
+
+    /** longest - if set, receives start and length of the longest line */
+    static qint64 scanTextLines(const char* data, int size, QVector<int>* starts, int* longest = NULL);
+
+    OutputRecordStore store;
+    QBinStrConv*      conv;
+    QBin2HexStrConv*  hex_conv;     /* conv, if it is a hex dump converter */
+    HexDumpFormat     hex_fmt;
+    QRgb              addr_rgb, body_rgb, supp_rgb;
+
+    QVector<qint64>   line_pos;     /* first line of each record and end (last item), on a relative scale; valid from laid_from on */
+    int               laid_from;    /* records before are not laid out, their lines are estimated */
+    double            est_byte;     /* estimated lines per payload byte of those records (plus one per record) */
+    QTimer            layout_timer;
+    int               line_height;
+    int               line_ascent;
+    int               char_width;
+    int               max_columns;  /* widest line of the laid out records */
+    qint64            sel_anchor;   /* -1 - no selection */
+    qint64            sel_cursor;
+
+    mutable int          starts_rec;     /* record which text line starts are cached */
+    mutable QVector<int> starts;
+};
+
+#endif // OUTPUTVIEW_H
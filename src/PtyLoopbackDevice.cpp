@@ -0,0 +1,258 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Pseudo-terminal pair and its traffic generator thread
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <QSocketNotifier>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+
+#include "PtyLoopbackDevice.h"
+
+#include "debug.h"
+
+// ******************************************************************************** C L A S S:  PtyTrafficGenerator
+
+PtyTrafficGenerator::PtyTrafficGenerator(PtyLoopbackDevice *device, qint64 bytes_per_sec, pattern_t pattern, int block_size)
+    : QThread(NULL)
+    , device(device)
+    , rate(bytes_per_sec > 0 ? bytes_per_sec : 0)
+    , pattern(pattern)
+    , block_size(block_size > 0 ? block_size : DEFAULT_BLOCK_SIZE)
+    , pattern_pos(0)
+    , seed(12345)
+    , stopped(0)
+    , cpu_time(0)
+{
+    setObjectName("PtyGenerator");
+}
+
+void PtyTrafficGenerator::fill(char *buf, int size)
+{
+    static const char text[] = "The quick brown fox jumps over the lazy dog 0123456789\r\n";
+    static const int  text_len = sizeof(text) - 1;
+
+    for (int cnt = 0; cnt < size; cnt++, pattern_pos++)
+    {
+        switch (pattern)
+        {
+        case PATTERN_TEXT:
+            buf[cnt] = text[pattern_pos % text_len];
+            break;
+        case PATTERN_RANDOM:
+            seed = seed * 1103515245u + 12345u;
+            buf[cnt] = static_cast<char>(seed >> 16);
+            break;
+        default:
+            buf[cnt] = static_cast<char>(pattern_pos);
+            break;
+        }
+    }
+}
+
+void PtyTrafficGenerator::run()
+{
+    QByteArray    block(block_size, Qt::Uninitialized);
+    QElapsedTimer timer;
+    qint64        sent = 0;
+
+    timer.start();
+    while (!stopped.load())
+    {
+        int size = block_size;
+
+        if (rate > 0)
+        {
+            double elapsed = timer.nsecsElapsed() / 1e9;
+            qint64 due     = static_cast<qint64>(rate * elapsed) - sent;
+
+            if (due <= 0)
+            {
+                // sleep until the next byte is due, but keep reacting to stop()
+                qint64 wait_us = static_cast<qint64>( ((sent + 1) / static_cast<double>(rate) - elapsed) * 1e6 ) + 1;
+                usleep( static_cast<useconds_t>(qBound(1LL, wait_us, 10000LL)) );
+                continue;
+            }
+            size = static_cast<int>(qMin(due, static_cast<qint64>(block_size)));
+        }
+
+        fill(block.data(), size);
+        if (!device->writeMaster(block.constData(), size, &stopped, &device->generated)) break;
+        sent += size;
+    }
+
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+    {
+        cpu_time = static_cast<qint64>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+    }
+}
+
+// ******************************************************************************** C L A S S:  PtyLoopbackDevice
+
+PtyLoopbackDevice::PtyLoopbackDevice(QObject *parent)
+    : SerialDeviceInterface(parent)
+    , master_fd(-1)
+    , slave_fd(-1)
+    , notifier(NULL)
+    , generator(NULL)
+    , generated(0)
+    , generator_cpu(0)
+{
+}
+
+PtyLoopbackDevice::~PtyLoopbackDevice()
+{
+    close();
+}
+
+bool PtyLoopbackDevice::open()
+{
+    struct termios tio;
+    const char*    name;
+
+    if (isOpen()) return true;
+
+    master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master_fd < 0 || grantpt(master_fd) != 0 || unlockpt(master_fd) != 0 || (name = ptsname(master_fd)) == NULL)
+    {
+        error_string = QString("Cannot create pseudo-terminal: %1").arg(strerror(errno));
+        close();
+        return false;
+    }
+    slave_name = QString::fromLocal8Bit(name);
+
+    // Raw mode from the start: no echo back to the master before the application sets up the port
+    slave_fd = ::open(name, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (slave_fd < 0 || tcgetattr(slave_fd, &tio) != 0)
+    {
+        error_string = QString("Cannot open %1: %2").arg(slave_name, strerror(errno));
+        close();
+        return false;
+    }
+    cfmakeraw(&tio);
+    tcsetattr(slave_fd, TCSANOW, &tio);
+
+    fcntl(master_fd, F_SETFL, fcntl(master_fd, F_GETFL) | O_NONBLOCK);
+
+    notifier = new QSocketNotifier(master_fd, QSocketNotifier::Read, this);
+    ASSERT_ALWAYS( connect(notifier, SIGNAL(activated(int)), SLOT(onMasterReadable()) ) );
+
+    error_string.clear();
+    return true;
+}
+
+void PtyLoopbackDevice::close()
+{
+    stopGenerator();
+
+    delete notifier;
+    notifier = NULL;
+
+    if (slave_fd >= 0)  ::close(slave_fd);
+    if (master_fd >= 0) ::close(master_fd);
+    slave_fd  = -1;
+    master_fd = -1;
+    slave_name.clear();
+}
+
+bool PtyLoopbackDevice::writeMaster(const char *data, int size, const QAtomicInt *stop, qint64 *counter)
+{
+    while (size > 0)
+    {
+        ssize_t written;
+        {
+            QMutexLocker lock(&write_lock);
+            written = ::write(master_fd, data, size);
+            if (written > 0 && counter) *counter += written;
+        }
+
+        if (written > 0)
+        {
+            data += written;
+            size -= static_cast<int>(written);
+        }
+        else if (written < 0 && errno == EAGAIN)
+        {
+            // PTY full - the application is not reading fast enough
+            struct pollfd pfd = { master_fd, POLLOUT, 0 };
+            if (stop && stop->load()) return false;
+            poll(&pfd, 1, PtyTrafficGenerator::WRITE_TIMEOUT);
+        }
+        else if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PtyLoopbackDevice::send(const QByteArray &buf)
+{
+    if (!isOpen()) return false;
+    return writeMaster(buf.constData(), buf.size());
+}
+
+void PtyLoopbackDevice::startGenerator(qint64 bytes_per_sec, PtyTrafficGenerator::pattern_t pattern, int block_size)
+{
+    if (!isOpen()) return;
+
+    stopGenerator();
+    {
+        QMutexLocker lock(&write_lock);
+        generated = 0;
+    }
+    generator = new PtyTrafficGenerator(this, bytes_per_sec, pattern, block_size);
+    generator->start(QThread::HighPriority);
+}
+
+void PtyLoopbackDevice::stopGenerator()
+{
+    if (!generator) return;
+
+    generator->stop();
+    generator->wait();
+    generator_cpu = generator->cpuTime();
+    delete generator;
+    generator = NULL;
+}
+
+qint64 PtyLoopbackDevice::generatedBytes() const
+{
+    QMutexLocker lock(&write_lock);
+    return generated;
+}
+
+void PtyLoopbackDevice::onMasterReadable()
+{
+    char    buf[READ_BUFFER_SIZE];
+    ssize_t len;
+
+    while ( (len = ::read(master_fd, buf, sizeof(buf))) > 0 )
+    {
+        QByteArray data(buf, static_cast<int>(len));
+        emit on_receive(data);
+    }
+}
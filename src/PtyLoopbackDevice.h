@@ -0,0 +1,139 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Pseudo-terminal device with a local traffic generator
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#ifndef PTYLOOPBACKDEVICE_H
+#define PTYLOOPBACKDEVICE_H
+
+#include <QThread>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QString>
+
+#include "SerialDeviceInterface.h"
+
+class QSocketNotifier;
+class PtyLoopbackDevice;
+
+// ******************************************************************************** C L A S S:  PtyTrafficGenerator
+/**
+ * Writes a data pattern to the PTY master at a fixed rate. The rate is kept
+ * on average (bytes due are computed from the start time), a slow reader
+ * blocks the generator through the PTY buffer, so nothing is lost on the
+ * way - all drops happen in the application.
+ */
+class PtyTrafficGenerator : public QThread
+{
+    Q_OBJECT
+public:
+    typedef enum {
+        PATTERN_COUNTER,    /* 0x00,0x01,..0xFF,0x00.. - receiver can verify continuity */
+        PATTERN_TEXT,       /* printable lines ended with CR LF */
+        PATTERN_RANDOM,
+
+        __PATTERN_CNT
+    } pattern_t;
+
+    enum {
+        DEFAULT_BLOCK_SIZE = 4096,
+        WRITE_TIMEOUT      = 100        /* ms, poll() on a full PTY; also bounds stop() latency */
+    };
+
+    PtyTrafficGenerator(PtyLoopbackDevice* device, qint64 bytes_per_sec, pattern_t pattern, int block_size);
+
+    void    stop()                     { stopped.store(1); }
+    /** CPU time used by the thread, ns; valid after it finished */
+    qint64  cpuTime() const            { return cpu_time; }
+
+protected:
+    void    run();
+
+private:
+    void    fill(char* buf, int size);
+
+    PtyLoopbackDevice* device;
+    qint64             rate;        /* bytes per second, 0 - as fast as possible */
+    pattern_t          pattern;
+    int                block_size;
+    qint64             pattern_pos;
+    quint32            seed;
+    QAtomicInt         stopped;
+    qint64             cpu_time;
+};
+
+// ******************************************************************************** C L A S S:  PtyLoopbackDevice
+/**
+ * Device side of a pseudo-terminal pair (posix_openpt). The application
+ * opens slaveName() like any serial port (SerialPortEngine, QSerialPort);
+ * data queued with send() or produced by the traffic generator arrives
+ * there as received data. Whatever the application sends to the port is
+ * reported by on_receive().
+ *
+ * Line settings (baud rate etc.) are ignored by PTYs - the generator rate
+ * is the only throttle, which makes receive pipeline benchmarks
+ * independent of any hardware. Unix only.
+ */
+class PtyLoopbackDevice : public SerialDeviceInterface
+{
+    Q_OBJECT
+public:
+    enum {
+        READ_BUFFER_SIZE = 4096
+    };
+
+    explicit PtyLoopbackDevice(QObject* parent = 0);
+    ~PtyLoopbackDevice();
+
+    bool     open();
+    void     close();
+    bool     isOpen() const            { return master_fd >= 0; }
+    /** Path to open on the application side, e.g. /dev/pts/5 */
+    QString  slaveName() const         { return slave_name; }
+    QString  errorString() const       { return error_string; }
+
+    /** Queues data towards the application; blocks while the PTY is full, interleaves with the generator */
+    virtual bool send(const QByteArray& buf);
+
+    /** bytes_per_sec 0 - as fast as the reader takes it */
+    void     startGenerator(qint64 bytes_per_sec,
+                            PtyTrafficGenerator::pattern_t pattern = PtyTrafficGenerator::PATTERN_COUNTER,
+                            int block_size = PtyTrafficGenerator::DEFAULT_BLOCK_SIZE);
+    void     stopGenerator();
+    bool     isGenerating() const      { return generator != NULL; }
+    /** Bytes written by the generator since startGenerator() */
+    qint64   generatedBytes() const;
+    /** CPU time of the last generator run, ns - to tell it apart from the application in benchmarks */
+    qint64   generatorCpuTime() const  { return generator_cpu; }
+
+private slots:
+    void     onMasterReadable();
+
+private:
+    Q_DISABLE_COPY(PtyLoopbackDevice)
+    friend class PtyTrafficGenerator;
+
+    /** Writes all unless stop is set or an error occurs; counter (if any) follows written bytes */
+    bool     writeMaster(const char* data, int size, const QAtomicInt* stop = NULL, qint64* counter = NULL);
+
+    int                  master_fd;
+    int                  slave_fd;      /* kept open, so the master never sees a hangup */
+    QString              slave_name;
+    QString              error_string;
+    QSocketNotifier*     notifier;
+    PtyTrafficGenerator* generator;
+    mutable QMutex       write_lock;    /* guards write() calls and the counter below */
+    qint64               generated;     /* guarded by write_lock */
+    qint64               generator_cpu;
+};
+
+#endif // PTYLOOPBACKDEVICE_H
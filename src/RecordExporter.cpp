@@ -0,0 +1,81 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Text and HTML rendering of output records to files
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#include <QColor>
+
+#include "RecordExporter.h"
+
+// ******************************************************************************** C L A S S:  RecordExporter
+
+RecordExporter::RecordExporter(QIODevice *dev, QBinStrConv *conv, QBinStrConv::STR_FORMAT format)
+    : dev(dev)
+    , conv(conv)
+    , format(format)
+{
+}
+
+QBinStrConv::STR_FORMAT RecordExporter::formatForFile(const QString &file_name)
+{
+    return ( file_name.endsWith(".html", Qt::CaseInsensitive) || file_name.endsWith(".htm", Qt::CaseInsensitive) )
+            ? QBinStrConv::HTML
+            : QBinStrConv::PLAIN_TEXT;
+}
+
+bool RecordExporter::begin()
+{
+    return (format != QBinStrConv::HTML) || dev->write("<html>\n<body>\n") >= 0;
+}
+
+bool RecordExporter::end()
+{
+    return (format != QBinStrConv::HTML) || dev->write("</body>\n</html>\n") >= 0;
+}
+
+bool RecordExporter::write(const OutputRecordStore::Record &rec, const char *data)
+{
+    const bool html = (format == QBinStrConv::HTML);
+    QByteArray out;
+
+    if (rec.kind == OutputRecordStore::REC_MESSAGE)
+    {
+        QString text = QString::fromUtf8(data, rec.size);
+        if (html)
+        {
+            const char* tag = (rec.style & OutputRecordStore::STYLE_BOLD) ? "b" : "i";
+            out = QString("<p><%1><font color=\"%2\">%3</font></%1></p>\n")
+                    .arg(tag, QColor(rec.color).name(), text.toHtmlEscaped()).toUtf8();
+        }
+        else
+        {
+            out = text.append(QLatin1Char('\n')).toLocal8Bit();
+        }
+    }
+    else if (conv)
+    {
+        QByteArray buf  = QByteArray::fromRawData(data, rec.size);
+        QString    text = conv->convert(buf, format);
+
+        if (html)
+        {
+            out = text.append("<br />\n").toUtf8();
+        }
+        else
+        {
+            if (!text.endsWith(QLatin1Char('\n'))) text.append(QLatin1Char('\n'));
+            out = text.toLocal8Bit();
+        }
+    }
+
+    return dev->write(out) >= 0;
+}
@@ -0,0 +1,46 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Renders output records to text or HTML
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#ifndef RECORDEXPORTER_H
+#define RECORDEXPORTER_H
+
+#include <QIODevice>
+
+#include "OutputRecordStore.h"
+#include "strbinconv.h"
+
+// ******************************************************************************** C L A S S:  RecordExporter
+/**
+ * Streams records, one at a time, to a device: data records are formatted
+ * with the given display converter, messages are written as they are.
+ * Used for saving the output area and for offline export of capture logs.
+ */
+class RecordExporter
+{
+public:
+    RecordExporter(QIODevice* dev, QBinStrConv* conv, QBinStrConv::STR_FORMAT format);
+
+    bool    begin();
+    bool    write(const OutputRecordStore::Record& rec, const char* data);
+    bool    end();
+
+    static  QBinStrConv::STR_FORMAT formatForFile(const QString& file_name);
+
+private:
+    QIODevice*              dev;
+    QBinStrConv*            conv;
+    QBinStrConv::STR_FORMAT format;
+};
+
+#endif // RECORDEXPORTER_H
@@ -0,0 +1,150 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Coalescing of received chunks by time, size and line gaps
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#include "RxAccumulator.h"
+#include "HiResClock.h"
+
+#include "debug.h"
+
+// ******************************************************************************** C L A S S: RxAccumulator
+
+RxAccumulator::RxAccumulator(QObject *parent)
+    : QObject(parent)
+    , chunks(0)
+    , flush_interval(DEFAULT_FLUSH_INTERVAL)
+    , flush_threshold(DEFAULT_FLUSH_THRESHOLD)
+    , char_time(0)
+    , gap_split(0)
+    , gap_timeout(0)
+    , last_time(0)
+    , frame_time(0)
+    , frame_gap(-1)
+{
+    timer.setSingleShot(true);
+    timer.setTimerType(Qt::PreciseTimer);
+    timer.setInterval(flush_interval);
+    ASSERT_ALWAYS( connect(&timer, SIGNAL(timeout()), SLOT(flush()) ) );
+}
+
+void RxAccumulator::setFlushInterval(int msec)
+{
+    if (msec < MIN_FLUSH_INTERVAL) msec = MIN_FLUSH_INTERVAL;
+    if (msec > MAX_FLUSH_INTERVAL) msec = MAX_FLUSH_INTERVAL;
+    flush_interval = msec;
+    if (!gap_split) timer.setInterval(flush_interval);
+}
+
+void RxAccumulator::setFlushThreshold(int bytes)
+{
+    flush_threshold = (bytes > 0) ? bytes : DEFAULT_FLUSH_THRESHOLD;
+}
+
+void RxAccumulator::setGapSplit(qint64 gap_ns)
+{
+    gap_split = (gap_ns > 0) ? gap_ns : 0;
+
+    // idle timeout rounded up to whole ms, it must never fire before the gap elapsed
+    gap_timeout = static_cast<int>( qMin<qint64>((gap_split + 999999) / 1000000, MAX_FLUSH_INTERVAL) );
+    timer.setInterval( gap_split ? gap_timeout : flush_interval );
+}
+
+qint64 RxAccumulator::charTime(int baud, int data_bits, bool parity, double stop_bits)
+{
+    if (baud <= 0) return 0;
+
+    // start bit + data + parity + stop
+    double bits = 1 + data_bits + (parity ? 1 : 0) + stop_bits;
+    return static_cast<qint64>( bits * 1e9 / baud + 0.5 );
+}
+
+qint64 RxAccumulator::frameGap(int chars10, int baud, qint64 char_ns)
+{
+    if (chars10 <= 0) return 0;
+    if (chars10 == MODBUS_GAP_CHARS10 && baud > MODBUS_FIXED_GAP_BAUD) return MODBUS_FIXED_GAP;
+    return char_ns * chars10 / 10;
+}
+
+void RxAccumulator::append(const char *data, int size, qint64 time_ns)
+{
+    if (size <= 0) return;
+    if (!time_ns) time_ns = HiResClock::now();
+
+    // Chunk stamp is the arrival of its last byte; the line was idle
+    // from the previous chunk until the first byte of this one started
+    qint64 first = time_ns - char_time * (size - 1);
+    qint64 gap   = -1;
+
+    if (last_time)
+    {
+        if (first < last_time) first = last_time;
+        gap = first - char_time - last_time;
+        if (gap < 0) gap = 0;
+    }
+    last_time = time_ns;
+
+    if (gap_split && gap >= gap_split && !pending.isEmpty())
+    {
+        flush();
+    }
+
+    if (pending.isEmpty())
+    {
+        // First chunk of a new frame - reserve once for the whole frame
+        pending.reserve(flush_threshold);
+        frame_time = first;
+        frame_gap  = gap;
+    }
+    pending.append(data, size);
+    chunks++;
+
+    if (pending.size() >= flush_threshold)
+    {
+        flush();
+    }
+    else if (gap_split)
+    {
+        // Line idle timeout - restarted by every chunk, but not past the
+        // flush interval from the first byte of the frame
+        qint64 left = (frame_time + flush_interval * 1000000LL - HiResClock::now() + 999999) / 1000000;
+        timer.start( static_cast<int>( qBound<qint64>(0, left, gap_timeout) ) );
+    }
+    else if (!timer.isActive())
+    {
+        // Frame period is counted from the first byte, so a steady stream
+        // can't postpone the flush forever
+        timer.start();
+    }
+}
+
+void RxAccumulator::flush()
+{
+    timer.stop();
+    if (pending.isEmpty()) return;
+
+    QByteArray frame;
+    int        frame_chunks = chunks;
+
+    frame.swap(pending);
+    chunks = 0;
+
+    emit frameReady(frame, frame_chunks, frame_time, frame_gap);
+}
+
+void RxAccumulator::clear()
+{
+    timer.stop();
+    pending.clear();
+    chunks    = 0;
+    last_time = 0;
+}
@@ -0,0 +1,107 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Receive accumulator coalescing incoming chunks into display frames
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#ifndef RXACCUMULATOR_H
+#define RXACCUMULATOR_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QTimer>
+
+// ******************************************************************************** C L A S S:  RxAccumulator
+/**
+ * Collects received bytes and hands them over to the display at most once
+ * per frame. A frame ends when the flush interval elapses (counted from the
+ * first byte of the frame) or when the pending data reaches the flush
+ * threshold, whichever comes first.
+ *
+ * In gap split mode frames follow the traffic instead: a frame ends when the
+ * line stays idle for the given gap (e.g. Modbus RTU t3.5). The decision is
+ * made on chunk arrival stamps, not on the time the GUI gets to the data;
+ * the timer only bounds the delay of the last frame. Resolution is limited
+ * by the driver - USB adapters deliver data in latency timer ticks. The
+ * flush interval still bounds how long a frame waits, counted from its
+ * first byte, so a stream without gaps is shown as it comes.
+ */
+class RxAccumulator : public QObject
+{
+    Q_OBJECT
+public:
+    enum {
+        DEFAULT_FLUSH_INTERVAL  = 25,        /* ms */
+        DEFAULT_FLUSH_THRESHOLD = 64*1024,   /* bytes */
+        MIN_FLUSH_INTERVAL      = 1,
+        MAX_FLUSH_INTERVAL      = 1000,
+        MODBUS_GAP_CHARS10      = 35,        /* t3.5, in tenths of a character */
+        MODBUS_FIXED_GAP_BAUD   = 19200,     /* above this rate t3.5 is fixed ... */
+        MODBUS_FIXED_GAP        = 1750000    /* ... to 1.75 ms, ns */
+    };
+
+    explicit RxAccumulator(QObject *parent = 0);
+
+    void   setFlushInterval(int msec);
+    int    flushInterval() const      { return flush_interval; }
+    void   setFlushThreshold(int bytes);
+    int    flushThreshold() const     { return flush_threshold; }
+
+    /** Duration of one character on the line, ns; used to estimate first byte arrival */
+    void   setCharTime(qint64 ns)     { char_time = (ns > 0) ? ns : 0; }
+    qint64 charTime() const           { return char_time; }
+    /** 0 - off, frames are split by flush interval only */
+    void   setGapSplit(qint64 gap_ns);
+    qint64 gapSplit() const           { return gap_split; }
+
+    /** Character time for given line settings, ns */
+    static qint64 charTime(int baud, int data_bits, bool parity, double stop_bits);
+    /** Gap of chars10/10 characters; MODBUS_GAP_CHARS10 follows Modbus RTU rules incl. the fixed gap at high rates */
+    static qint64 frameGap(int chars10, int baud, qint64 char_ns);
+
+    /** time_ns - arrival of the chunk (its last byte), HiResClock; 0 - now */
+    void   append(const char* data, int size, qint64 time_ns = 0);
+    void   append(const QByteArray& data) { append(data.constData(), data.size()); }
+
+    int    pendingSize() const        { return pending.size(); }
+    bool   isEmpty() const            { return pending.isEmpty(); }
+
+public slots:
+    void   flush();
+    void   clear();
+
+signals:
+    /**
+     * Emitted once per frame.
+     * @param data    all bytes received since previous frame
+     * @param chunks  number of append() calls merged into this frame
+     * @param time_ns estimated arrival of the first byte, HiResClock
+     * @param gap_ns  line idle time before the frame, -1 if unknown
+     */
+    void   frameReady(const QByteArray& data, int chunks, qint64 time_ns, qint64 gap_ns);
+
+private:
+    Q_DISABLE_COPY(RxAccumulator)
+
+    QByteArray pending;
+    QTimer     timer;
+    int        chunks;
+    int        flush_interval;
+    int        flush_threshold;
+    qint64     char_time;
+    qint64     gap_split;
+    int        gap_timeout;     /* ms, gap_split rounded up */
+    qint64     last_time;       /* arrival of the last byte appended, 0 - none yet */
+    qint64     frame_time;      /* first byte of pending frame */
+    qint64     frame_gap;
+};
+
+#endif // RXACCUMULATOR_H
@@ -0,0 +1,680 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    I/O thread worker, receive ring hand-over and transmit scheduling
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#include "SerialPortEngine.h"
+
+#include <string.h>
+
+#include "RxAccumulator.h"
+#include "debug.h"
+
+// ******************************************************************************** C L A S S: SerialPortWorker
+
+SerialPortWorker::SerialPortWorker(SerialPortEngine *engine)
+    : QObject(NULL)
+    , engine(engine)
+    , port(NULL)
+    , scratch(new char[SCRATCH_SIZE])
+    , rx_pos(0)
+    , tx_offset(0)
+    , tx_gap(0)
+    , tx_byte_delay(0)
+    , tx_packet_delay(0)
+    , tx_timer(NULL)
+    , tx_char_ns(0)
+    , tx_wire_idle(0)
+    , port_pos(0)
+    , port_done(0)
+    , probe_rounds(0)
+    , probe_sent_cnt(0)
+    , probe_replies(0)
+    , probe_timeout(0)
+    , probe_sent(0)
+    , probe_min(0)
+    , probe_max(0)
+    , probe_sum(0)
+    , probe_timer(NULL)
+    , counters_timer(NULL)
+    , counters(QSerialPort::LineCounters())
+{
+}
+
+SerialPortWorker::~SerialPortWorker()
+{
+    delete port;
+    delete[] scratch;
+}
+
+void SerialPortWorker::init()
+{
+    // Created here, so the port and its notifiers belong to the I/O thread
+    port = new QSerialPort(this);
+    // ports sharing an I/O thread are served from one epoll set of that thread
+    port->setEpollReactorEnabled(!engine->own_thread);
+
+    tx_timer = new QTimer(this);
+    tx_timer->setSingleShot(true);
+    tx_timer->setTimerType(Qt::PreciseTimer);
+    ASSERT_ALWAYS( connect(tx_timer, SIGNAL(timeout()),        SLOT(pumpTx()) ) );
+
+    probe_timer = new QTimer(this);
+    probe_timer->setSingleShot(true);
+    probe_timer->setTimerType(Qt::PreciseTimer);
+    ASSERT_ALWAYS( connect(probe_timer, SIGNAL(timeout()),     SLOT(onProbeTimer()) ) );
+
+    counters_timer = new QTimer(this);
+    counters_timer->setInterval(COUNTERS_POLL_MS);
+    ASSERT_ALWAYS( connect(counters_timer, SIGNAL(timeout()),  SLOT(pollCounters()) ) );
+
+    ASSERT_ALWAYS( connect(port, SIGNAL(readyRead()),          SLOT(onReadyRead()) ) );
+    ASSERT_ALWAYS( connect(port, SIGNAL(bytesWritten(qint64)), SLOT(onBytesWritten(qint64)) ) );
+    ASSERT_ALWAYS( connect(port, SIGNAL(pinoutSignalsChanged(QSerialPort::PinoutSignals)), SLOT(onPinoutSignalsChanged(QSerialPort::PinoutSignals)) ) );
+    ASSERT_ALWAYS( connect(port, SIGNAL(error(QSerialPort::SerialPortError)), engine, SIGNAL(error(QSerialPort::SerialPortError)) ) );
+}
+
+bool SerialPortWorker::open(const QString &name)
+{
+    port->setPortName(name);
+    rx_pos = 0;
+    clearTx();
+    tx_wire_idle = 0;
+    counters = QSerialPort::LineCounters();
+    if (!port->open(QIODevice::ReadWrite)) return false;
+    updateCharTime();
+    counters_timer->start();
+    return true;
+}
+
+void SerialPortWorker::close()
+{
+    if (port->isOpen())
+    {
+        // pick up whatever is still in the driver buffer
+        onReadyRead();
+        port->close();
+    }
+    clearTx();
+    if (probe_timer && probe_timer->isActive()) finishProbe();
+    if (counters_timer) counters_timer->stop();
+}
+
+QString SerialPortWorker::errorString()
+{
+    return port->errorString();
+}
+
+QStringList SerialPortWorker::applySettings(const SerialSetupDialog::PortSettings &settings)
+{
+    QStringList rejected;
+
+    if (!port->setBaudRate(settings.BaudRate))       rejected << QString("baud rate %1").arg(settings.BaudRate);
+    if (!port->setDataBits(settings.DataBits))       rejected << "data bits";
+    if (!port->setFlowControl(settings.FlowControl)) rejected << "flow control";
+    if (!port->setParity(settings.Parity))           rejected << "parity";
+    if (!port->setStopBits(settings.StopBits))       rejected << "stop bits";
+    port->setTimeout(settings.Timeout_Millisec);
+    if (!port->setLowLatency(settings.LowLatency))   rejected << "low latency";
+    tx_byte_delay   = static_cast<int>( qMax(settings.TxByteDelay_Millisec, 0L) );
+    tx_packet_delay = static_cast<int>( qMax(settings.TxPacketDelay_Millisec, 0L) );
+    updateCharTime();
+
+    return rejected;
+}
+
+void SerialPortWorker::updateCharTime()
+{
+    // settings the port really runs with, rejected ones are not among them
+    QSerialPort::StopBits stop = port->stopBits();
+    double stop_bits = (stop == QSerialPort::TwoStop) ? 2.0 : (stop == QSerialPort::OneAndHalfStop) ? 1.5 : 1.0;
+    tx_char_ns = RxAccumulator::charTime(port->baudRate(QSerialPort::Output), port->dataBits(),
+                                         port->parity() != QSerialPort::NoParity, stop_bits);
+}
+
+SerialSetupDialog::PortSettings SerialPortWorker::readSettings()
+{
+    SerialSetupDialog::PortSettings settings;
+
+    settings.BaudRate         = port->baudRate();
+    settings.DataBits         = port->dataBits();
+    settings.FlowControl      = port->flowControl();
+    settings.Parity           = port->parity();
+    settings.StopBits         = port->stopBits();
+    settings.Timeout_Millisec = port->getTimeout();
+    settings.TxByteDelay_Millisec   = tx_byte_delay;
+    settings.TxPacketDelay_Millisec = tx_packet_delay;
+    settings.LowLatency             = port->isLowLatency();
+
+    return settings;
+}
+
+qint32 SerialPortWorker::actualBaudRate()
+{
+    return port->actualBaudRate();
+}
+
+QSerialPort::LineCounters SerialPortWorker::readLineCounters()
+{
+    QSerialPort::LineCounters result = QSerialPort::LineCounters();
+    port->lineCounters(&result);
+    return result;
+}
+
+QSerialPort::PinoutSignals SerialPortWorker::pinoutSignals()
+{
+    return port->isOpen() ? port->pinoutSignals() : QSerialPort::PinoutSignals(QSerialPort::NoSignal);
+}
+
+void SerialPortWorker::setDataTerminalReady(bool set)
+{
+    if (port->isOpen()) port->setDataTerminalReady(set);
+}
+
+void SerialPortWorker::setRequestToSend(bool set)
+{
+    if (port->isOpen()) port->setRequestToSend(set);
+}
+
+void SerialPortWorker::writeData(const QByteArray &data)
+{
+    if (!port->isOpen())
+    {
+        engine->tx_pending.fetchAndAddOrdered(-data.size());
+        return;
+    }
+    tx_queue.append(data);
+    pumpTx();
+}
+
+qint64 SerialPortWorker::clearTx()
+{
+    tx_queue.clear();
+    tx_offset = 0;
+    tx_gap    = 0;
+    if (tx_timer) tx_timer->stop();
+    if (port && port->isOpen()) port->clear(QSerialPort::Output);
+    port_pos  = 0;
+    port_done = 0;
+    port_probes.clear();
+    return engine->tx_pending.fetchAndStoreOrdered(0);
+}
+
+void SerialPortWorker::release(QThread *owner)
+{
+    clearTx();
+    if (probe_timer) probe_timer->stop();
+    if (counters_timer) counters_timer->stop();
+    delete port;
+    port = NULL;
+    moveToThread(owner);
+}
+
+void SerialPortWorker::onBytesWritten(qint64 bytes)
+{
+    qint64 from = port_done;
+    qint64 data = bytes;
+
+    // Probe bytes are not written data - skip the ones in this range
+    port_done += bytes;
+    while (!port_probes.isEmpty() && port_probes.first().first < port_done)
+    {
+        const QPair<qint64,qint64>& probe = port_probes.first();
+        data -= qMin(probe.second, port_done) - qMax(probe.first, from);
+        if (probe.second > port_done) break;
+        port_probes.removeFirst();
+    }
+
+    if (data > 0)
+    {
+        engine->tx_pending.fetchAndAddOrdered(-static_cast<int>(data));
+        QMetaObject::invokeMethod(engine, "onTxDone", Qt::QueuedConnection, Q_ARG(qint64, data) );
+    }
+    pumpTx();
+}
+
+void SerialPortWorker::pumpTx()
+{
+    qint64 len;
+    qint64 left;
+    qint64 now;
+
+    if (!port->isOpen() || tx_timer->isActive()) return;
+
+    while (!tx_queue.isEmpty())
+    {
+        if (tx_gap)
+        {
+            // gap starts when the preceding data has left the line
+            if (port->bytesToWrite() > 0) return;       // continued from onBytesWritten()
+            now    = HiResClock::now();
+            left   = qMax(tx_wire_idle, now) + tx_gap * 1000000LL - now;
+            tx_gap = 0;
+            if (left > 0)
+            {
+                tx_timer->start(static_cast<int>((left + 999999) / 1000000)); // continued from timeout
+                return;
+            }
+        }
+
+        // Keep port buffer short - flow control backpressure stops us here
+        len = TX_PORT_WINDOW - port->bytesToWrite();
+        if (len <= 0) return;
+
+        const QByteArray& packet = tx_queue.first();
+        len = qMin<qint64>(len, packet.size() - tx_offset);
+        if (tx_byte_delay) len = 1;
+
+        len = port->write(packet.constData() + tx_offset, len);
+        if (len <= 0) return;                           // error is reported by the port
+        port_pos  += len;
+        tx_offset += static_cast<int>(len);
+        now          = HiResClock::now();
+        tx_wire_idle = qMax(tx_wire_idle, now) + len * tx_char_ns;
+
+        if (tx_byte_delay) tx_gap = tx_byte_delay;
+        if (tx_offset >= packet.size())
+        {
+            tx_queue.removeFirst();
+            tx_offset = 0;
+            if (tx_packet_delay > tx_gap) tx_gap = tx_packet_delay;
+        }
+    }
+}
+
+void SerialPortWorker::onReadyRead()
+{
+    SpscRingBuffer& ring = engine->rx_ring;
+    char*           ptr;
+    const char*     src;
+    int             span;
+    qint64          len;
+    qint64          avail;
+    bool            committed = false;
+    SerialPortEngine::RxMark mark;
+    bool            received  = false;
+
+    // Stamp taken by the backend right after read(), if it supports it
+    mark.time = port->readTimestamp();
+    if (!mark.time) mark.time = HiResClock::now();
+    mark.pos  = rx_pos;
+
+    // Drain the driver completely - the port's own buffer must never grow,
+    // otherwise the kernel tty buffer is the next one to overflow
+    while (port->bytesAvailable() > 0)
+    {
+        // Taken from the port's buffer directly, read() copies through QIODevice first
+        avail = port->peekReadBuffer(&src);
+        span  = ring.writeSpan(&ptr);
+        if (span > 0)
+        {
+            if (avail > 0)
+            {
+                len = qMin<qint64>(avail, span);
+                memcpy(ptr, src, static_cast<size_t>(len));
+                port->consumeReadBuffer(len);
+            }
+            else
+            {
+                len = port->read(ptr, span);
+                if (len <= 0) break;
+            }
+            if (!committed && engine->rx_marks.freeSpace() >= static_cast<int>(sizeof(mark)))
+            {
+                // mark must be visible before the data it describes
+                engine->rx_marks.write(reinterpret_cast<const char*>(&mark), sizeof(mark));
+            }
+            ring.commitWrite(static_cast<int>(len));
+            rx_pos   += len;
+            committed = true;
+            received  = true;
+        }
+        else
+        {
+            // GUI is not keeping up - drop explicitly instead of blocking
+            if (avail > 0)
+            {
+                len = avail;
+                port->consumeReadBuffer(len);
+            }
+            else
+            {
+                len = port->read(scratch, SCRATCH_SIZE);
+                if (len <= 0) break;
+            }
+            engine->rxDropped(static_cast<int>(len));
+            received = true;
+        }
+    }
+
+    if (committed) engine->rxCommitted();
+    if (received && probe_timer && probe_timer->isActive()) probeReceived(mark.time);
+}
+
+void SerialPortWorker::onPinoutSignalsChanged(QSerialPort::PinoutSignals signals_mask)
+{
+    emit engine->pinoutSignalsChanged(signals_mask);
+}
+
+void SerialPortWorker::startLatencyProbe(const QByteArray &probe, int rounds, int timeout_ms)
+{
+    probe_data     = probe;
+    probe_rounds   = qMax(rounds, 1);
+    probe_timeout  = qMax(timeout_ms, 1);
+    probe_sent_cnt = 0;
+    probe_replies  = 0;
+    probe_sent     = 0;
+    probe_min      = 0;
+    probe_max      = 0;
+    probe_sum      = 0;
+    // the first round waits for a quiet line too
+    probe_timer->start(PROBE_SETTLE_MS);
+}
+
+void SerialPortWorker::onProbeTimer()
+{
+    // probe_sent still set - the round got no reply within the timeout
+    probe_sent = 0;
+    if (!probe_rounds || !port->isOpen())
+    {
+        finishProbe();
+        return;
+    }
+
+    probe_rounds--;
+    probe_sent_cnt++;
+    probe_sent = HiResClock::now();
+    qint64 len = port->write(probe_data);
+    if (len > 0)
+    {
+        port_probes.append( qMakePair(port_pos, port_pos + len) );
+        port_pos += len;
+    }
+    port->flush();
+    probe_timer->start(probe_timeout);
+}
+
+void SerialPortWorker::probeReceived(qint64 time)
+{
+    if (probe_sent)
+    {
+        qint64 rtt = time - probe_sent;
+        if (!probe_replies || rtt < probe_min) probe_min = rtt;
+        if (!probe_replies || rtt > probe_max) probe_max = rtt;
+        probe_sum += rtt;
+        probe_replies++;
+        probe_sent = 0;
+    }
+    // rest of the reply restarts the settle time
+    probe_timer->start(PROBE_SETTLE_MS);
+}
+
+void SerialPortWorker::pollCounters()
+{
+    QSerialPort::LineCounters now;
+
+    if (!port->lineCounters(&now)) return;
+    if (memcmp(&now, &counters, sizeof(now)) == 0) return;
+
+    counters = now;
+    emit engine->lineCountersChanged(counters, HiResClock::now());
+}
+
+void SerialPortWorker::finishProbe()
+{
+    probe_timer->stop();
+    probe_rounds = 0;
+    probe_sent   = 0;
+    emit engine->latencyProbeFinished(probe_replies, probe_sent_cnt, probe_min,
+                                      probe_replies ? probe_sum / probe_replies : 0, probe_max);
+}
+
+// ******************************************************************************** C L A S S: SerialPortEngine
+
+SerialPortEngine::SerialPortEngine(QObject *parent, int rxRingSize, QThread *io_thread)
+    : QObject(parent)
+    , io_thread(io_thread)
+    , own_thread(io_thread == NULL)
+    , worker(NULL)
+    , rx_ring(rxRingSize)
+    , rx_marks(RX_MARK_RING_SIZE)
+    , rx_pos(0)
+    , rx_chunk_time(0)
+    , rx_notify_pending(0)
+    , rx_dropped(0)
+    , rx_overrun_pending(0)
+    , tx_pending(0)
+    , tx_written(0)
+    , tx_done(0)
+    , tx_limit(DEFAULT_TX_QUEUE_LIMIT)
+    , is_open(false)
+{
+    qRegisterMetaType<QSerialPort::SerialPortError>("QSerialPort::SerialPortError");
+    qRegisterMetaType<QSerialPort::PinoutSignals>("QSerialPort::PinoutSignals");
+    qRegisterMetaType<SerialSetupDialog::PortSettings>("SerialSetupDialog::PortSettings");
+    qRegisterMetaType<QSerialPort::LineCounters>("QSerialPort::LineCounters");
+
+    worker = new SerialPortWorker(this);
+
+    if (own_thread)
+    {
+        this->io_thread = new QThread();
+        this->io_thread->setObjectName("SerialIO");
+        ASSERT_ALWAYS( connect(this->io_thread, SIGNAL(finished()), worker, SLOT(deleteLater()) ) );
+        this->io_thread->start(QThread::TimeCriticalPriority);
+    }
+    worker->moveToThread(this->io_thread);
+
+    QMetaObject::invokeMethod(worker, "init", Qt::BlockingQueuedConnection);
+}
+
+SerialPortEngine::~SerialPortEngine()
+{
+    close();
+    if (own_thread)
+    {
+        io_thread->quit();
+        io_thread->wait();
+        delete io_thread;
+    }
+    else
+    {
+        // shared thread keeps running - take the worker back and delete it here
+        QMetaObject::invokeMethod(worker, "release", Qt::BlockingQueuedConnection,
+                                  Q_ARG(QThread*, QThread::currentThread()) );
+        delete worker;
+    }
+}
+
+bool SerialPortEngine::open(QIODevice::OpenMode mode)
+{
+    (void) mode; // port is always opened for reading and writing
+    bool result = false;
+
+    rx_ring.clear();
+    rx_marks.clear();
+    rx_pos        = 0;
+    rx_chunk_time = 0;
+    rx_dropped.store(0);
+    rx_overrun_pending.store(0);
+    rx_notify_pending.store(0);
+    tx_written = 0;
+    tx_done    = 0;
+
+    QMetaObject::invokeMethod(worker, "open", Qt::BlockingQueuedConnection,
+                              Q_RETURN_ARG(bool, result),
+                              Q_ARG(QString, port_name) );
+    is_open = result;
+    return result;
+}
+
+void SerialPortEngine::close()
+{
+    if (!is_open) return;
+
+    QMetaObject::invokeMethod(worker, "close", Qt::BlockingQueuedConnection);
+    is_open = false;
+}
+
+QString SerialPortEngine::errorString()
+{
+    QString str;
+    QMetaObject::invokeMethod(worker, "errorString", Qt::BlockingQueuedConnection,
+                              Q_RETURN_ARG(QString, str) );
+    return str;
+}
+
+QStringList SerialPortEngine::setSettings(const SerialSetupDialog::PortSettings &settings)
+{
+    QStringList rejected;
+    QMetaObject::invokeMethod(worker, "applySettings", Qt::BlockingQueuedConnection,
+                              Q_RETURN_ARG(QStringList, rejected),
+                              Q_ARG(SerialSetupDialog::PortSettings, settings) );
+    return rejected;
+}
+
+void SerialPortEngine::getSettings(SerialSetupDialog::PortSettings &settings)
+{
+    QMetaObject::invokeMethod(worker, "readSettings", Qt::BlockingQueuedConnection,
+                              Q_RETURN_ARG(SerialSetupDialog::PortSettings, settings) );
+}
+
+QSerialPort::LineCounters SerialPortEngine::lineCounters()
+{
+    QSerialPort::LineCounters result = QSerialPort::LineCounters();
+    QMetaObject::invokeMethod(worker, "readLineCounters", Qt::BlockingQueuedConnection,
+                              Q_RETURN_ARG(QSerialPort::LineCounters, result) );
+    return result;
+}
+
+qint32 SerialPortEngine::actualBaudRate()
+{
+    qint32 result = 0;
+    QMetaObject::invokeMethod(worker, "actualBaudRate", Qt::BlockingQueuedConnection,
+                              Q_RETURN_ARG(qint32, result) );
+    return result;
+}
+
+QSerialPort::PinoutSignals SerialPortEngine::pinoutSignals()
+{
+    QSerialPort::PinoutSignals result = QSerialPort::NoSignal;
+    QMetaObject::invokeMethod(worker, "pinoutSignals", Qt::BlockingQueuedConnection,
+                              Q_RETURN_ARG(QSerialPort::PinoutSignals, result) );
+    return result;
+}
+
+void SerialPortEngine::startLatencyProbe(const QByteArray &probe, int rounds, int timeout_ms)
+{
+    QMetaObject::invokeMethod(worker, "startLatencyProbe", Qt::QueuedConnection,
+                              Q_ARG(QByteArray, probe), Q_ARG(int, rounds), Q_ARG(int, timeout_ms) );
+}
+
+void SerialPortEngine::setDataTerminalReady(bool set)
+{
+    QMetaObject::invokeMethod(worker, "setDataTerminalReady", Qt::QueuedConnection, Q_ARG(bool, set) );
+}
+
+void SerialPortEngine::setRequestToSend(bool set)
+{
+    QMetaObject::invokeMethod(worker, "setRequestToSend", Qt::QueuedConnection, Q_ARG(bool, set) );
+}
+
+qint64 SerialPortEngine::read(char *data, qint64 maxlen)
+{
+    // Re-arm notification before reading, so data committed meanwhile is signalled again
+    rx_notify_pending.store(0);
+    int len = rx_ring.read(data, static_cast<int>(qMin<qint64>(maxlen, rx_ring.capacity())) );
+    rx_pos += len;
+    return len;
+}
+
+bool SerialPortEngine::peekMark(RxMark *mark) const
+{
+    const char* ptr;
+
+    // marks never wrap - ring capacity is a multiple of the mark size
+    if (rx_marks.readSpan(&ptr) < static_cast<int>(sizeof(*mark))) return false;
+    memcpy(mark, ptr, sizeof(*mark));
+    return true;
+}
+
+int SerialPortEngine::peekChunk(const char **ptr, qint64 *time_ns)
+{
+    RxMark mark;
+    int    len = peek(ptr);
+
+    if (len <= 0) return len;
+
+    // Skip to the chunk containing rx_pos
+    while (peekMark(&mark) && mark.pos <= rx_pos)
+    {
+        rx_chunk_time = mark.time;
+        rx_marks.commitRead(sizeof(mark));
+    }
+    // ... and stop where the next one begins
+    if (peekMark(&mark) && mark.pos - rx_pos < len)
+    {
+        len = static_cast<int>(mark.pos - rx_pos);
+    }
+
+    *time_ns = rx_chunk_time;
+    return len;
+}
+
+qint64 SerialPortEngine::write(const QByteArray &data)
+{
+    if (!is_open || data.isEmpty()) return 0;
+
+    // Bounded queue, whole packets only; an oversized one waits for an empty queue
+    qint64 pending = tx_pending.load();
+    if (pending > 0 && pending + data.size() > tx_limit) return 0;
+
+    tx_pending.fetchAndAddOrdered(data.size());
+    tx_written += data.size();
+    QMetaObject::invokeMethod(worker, "writeData", Qt::QueuedConnection, Q_ARG(QByteArray, data) );
+    return data.size();
+}
+
+void SerialPortEngine::clearTx()
+{
+    qint64 dropped = 0;
+
+    // queued calls are executed in order, so no earlier writeData() can follow
+    QMetaObject::invokeMethod(worker, "clearTx", Qt::BlockingQueuedConnection,
+                              Q_RETURN_ARG(qint64, dropped) );
+    // reports of the bytes sent before are still on their way, these never come
+    tx_done += dropped;
+}
+
+void SerialPortEngine::onTxDone(qint64 bytes)
+{
+    tx_done += bytes;
+    emit bytesWritten(bytes);
+}
+
+void SerialPortEngine::rxCommitted()
+{
+    // one notification per batch - the GUI drains everything at once
+    if (rx_notify_pending.testAndSetOrdered(0, 1))
+    {
+        emit readyRead();
+    }
+}
+
+void SerialPortEngine::rxDropped(int len)
+{
+    rx_dropped.fetchAndAddOrdered(len);
+    if (rx_overrun_pending.testAndSetOrdered(0, 1))
+    {
+        emit rxOverrun();
+    }
+}
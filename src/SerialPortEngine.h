@@ -0,0 +1,296 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Serial port running in a dedicated I/O thread
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#ifndef SERIALPORTENGINE_H
+#define SERIALPORTENGINE_H
+
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QList>
+#include <QPair>
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QMetaType>
+
+#include "QSerialPort"
+
+#include "serialsetupdialog.h"
+#include "SpscRingBuffer.h"
+#include "HiResClock.h"
+
+Q_DECLARE_METATYPE(SerialSetupDialog::PortSettings)
+Q_DECLARE_METATYPE(QSerialPort::SerialPortError)
+Q_DECLARE_METATYPE(QSerialPort::PinoutSignals)
+Q_DECLARE_METATYPE(QSerialPort::LineCounters)
+
+class SerialPortEngine;
+
+// ******************************************************************************** C L A S S:  SerialPortWorker
+/**
+ * Owns the QSerialPort and lives in the I/O thread. Never touched directly
+ * by the GUI - all calls arrive through SerialPortEngine as queued
+ * (or blocking queued) invocations.
+ *
+ * Transmission is scheduled here: written packets wait in tx_queue and are
+ * passed to the port only while its write buffer holds less than
+ * TX_PORT_WINDOW bytes, the rest is pumped from bytesWritten(). When the
+ * line is held by RTS/CTS or XON/XOFF flow control the driver stops taking
+ * data, bytesWritten() stops and so does the pump - nothing piles up in
+ * QSerialPort's unbounded buffer. Byte and packet delays are measured from
+ * the moment the preceding data has left the wire: the port buffer must be
+ * empty and the bytes handed to the driver are counted at the character
+ * time of the current settings, the driver's own queue is not visible here.
+ * Written bytes are reported to the engine without the probe bytes, which
+ * go to the port directly and are tracked on the port stream in port_probes.
+ *
+ * The latency probe writes the probe packet directly to the port, waits for
+ * the first received chunk and takes its arrival stamp minus the time of the
+ * write as the round trip. The next round starts when the line has been
+ * quiet for PROBE_SETTLE_MS, rounds without reply end after the timeout.
+ *
+ * Line counters (bytes, frame/parity/overrun errors, breaks) are polled
+ * every COUNTERS_POLL_MS while the port is open and published through the
+ * engine only when they change.
+ */
+class SerialPortWorker : public QObject
+{
+    Q_OBJECT
+public:
+    enum {
+        SCRATCH_SIZE   = 16*1024,
+        TX_PORT_WINDOW = 4*1024,    /* max bytes in QSerialPort write buffer */
+        PROBE_SETTLE_MS = 20,       /* quiet line before next probe round */
+        COUNTERS_POLL_MS = 500
+    };
+
+    explicit SerialPortWorker(SerialPortEngine* engine);
+    ~SerialPortWorker();
+
+public slots:
+    void    init();
+    bool    open(const QString& name);
+    void    close();
+    QString errorString();
+
+    QStringList applySettings(const SerialSetupDialog::PortSettings& settings);
+    SerialSetupDialog::PortSettings readSettings();
+    qint32  actualBaudRate();
+    QSerialPort::LineCounters readLineCounters();
+
+    QSerialPort::PinoutSignals pinoutSignals();
+    void    setDataTerminalReady(bool set);
+    void    setRequestToSend(bool set);
+
+    void    writeData(const QByteArray& data);
+    /** Returns the number of written bytes dropped unsent */
+    qint64  clearTx();
+    /** Drops the port and moves the worker to given thread, so it can be deleted there */
+    void    release(QThread* owner);
+
+    void    startLatencyProbe(const QByteArray& probe, int rounds, int timeout_ms);
+
+private slots:
+    void    onReadyRead();
+    void    onBytesWritten(qint64 bytes);
+    void    pumpTx();
+    void    onPinoutSignalsChanged(QSerialPort::PinoutSignals signals_mask);
+    void    onProbeTimer();
+    void    pollCounters();
+
+private:
+    Q_DISABLE_COPY(SerialPortWorker)
+
+    void    probeReceived(qint64 time);
+    void    finishProbe();
+    void    updateCharTime();
+
+    SerialPortEngine* engine;
+    QSerialPort*      port;
+    char*             scratch;      // sink for bytes which don't fit into the ring
+    qint64            rx_pos;       // stream position of the ring head
+
+    QList<QByteArray> tx_queue;     // packets waiting for the port
+    int               tx_offset;    // part of tx_queue.first() already passed to the port
+    int               tx_gap;       // ms to keep the line idle before next byte, 0 - none
+    int               tx_byte_delay;
+    int               tx_packet_delay;
+    QTimer*           tx_timer;     // runs while a gap is being kept
+    qint64            tx_char_ns;   // character time of current settings
+    qint64            tx_wire_idle; // HiResClock, estimated end of last byte on the line
+    qint64            port_pos;     // bytes handed to the port since the last clearTx()
+    qint64            port_done;    // ... and reported by its bytesWritten()
+    QList<QPair<qint64,qint64> > port_probes;   // probe writes not reported yet, [start, end) of port_pos
+
+    QByteArray        probe_data;
+    int               probe_rounds;     // rounds not sent yet
+    int               probe_sent_cnt;
+    int               probe_replies;
+    int               probe_timeout;
+    qint64            probe_sent;       // HiResClock of the last probe write, 0 - not waiting for reply
+    qint64            probe_min;
+    qint64            probe_max;
+    qint64            probe_sum;
+    QTimer*           probe_timer;      // reply timeout, then settle time
+
+    QTimer*           counters_timer;
+    QSerialPort::LineCounters counters; // last published
+};
+
+// ******************************************************************************** C L A S S:  SerialPortEngine
+/**
+ * GUI side of the serial I/O thread. Keeps the subset of the QSerialPort
+ * interface used by MainWindow, so the UI code stays unchanged while the port
+ * itself is drained continuously by SerialPortWorker into a lock-free ring.
+ *
+ * readyRead() is emitted once per batch: it is not emitted again until the
+ * consumer calls read()/consume(), no matter how many chunks arrive meanwhile.
+ * If the ring is full, received bytes are dropped (never blocked on) and
+ * reported by rxOverrun().
+ *
+ * By default every engine runs its own I/O thread. Engines created with an
+ * io_thread share it (see SessionManager) - the worker only reacts to
+ * notifiers, so one thread serves many ports.
+ *
+ * write() never blocks: data is queued for the worker's transmit scheduler
+ * and rejected (0 returned) when the queue would exceed its limit.
+ * bytesWritten() reports data actually written to the device; it is emitted
+ * in the GUI thread after txDone() has been advanced, so a packet written
+ * at position txWritten() == pos is out once txDone() >= pos + size.
+ * Bytes of the latency probe are not part of this stream.
+ *
+ * Every chunk read from the device is stamped with HiResClock time taken
+ * right after the read() in the port backend. Stamps travel next to the
+ * data in a second ring of chunk marks, peekChunk() returns the received
+ * bytes cut at chunk boundaries together with their arrival time. When the
+ * mark ring is full, the chunk is merged with the previous one.
+ */
+class SerialPortEngine : public QObject
+{
+    Q_OBJECT
+public:
+    enum {
+        DEFAULT_RX_RING_SIZE = 4*1024*1024,
+        RX_MARK_RING_SIZE    = 64*1024,     /* 4096 chunk marks */
+        DEFAULT_TX_QUEUE_LIMIT = 1024*1024  /* bytes written but not sent yet */
+    };
+
+    explicit SerialPortEngine(QObject *parent = 0, int rxRingSize = DEFAULT_RX_RING_SIZE, QThread* io_thread = NULL);
+    ~SerialPortEngine();
+
+    void        setPortName(const QString& name) { port_name = name; }
+    QString     portName() const                 { return port_name; }
+    bool        open(QIODevice::OpenMode mode);
+    void        close();
+    bool        isOpen() const                   { return is_open; }
+    QString     errorString();
+
+    /** Returns names of the settings the port rejected, empty if all were applied */
+    QStringList setSettings(const SerialSetupDialog::PortSettings& settings);
+    void        getSettings(SerialSetupDialog::PortSettings& settings);
+    /** Baud rate the device really runs at, may differ from the requested arbitrary rate */
+    qint32      actualBaudRate();
+    /** Current line counters, see QSerialPort::lineCounters() */
+    QSerialPort::LineCounters lineCounters();
+
+    QSerialPort::PinoutSignals pinoutSignals();
+    void        setDataTerminalReady(bool set);
+    void        setRequestToSend(bool set);
+
+    //-------------------------------------------------------------- RX
+    qint64      bytesAvailable() const           { return rx_ring.size(); }
+    qint64      read(char* data, qint64 maxlen);
+    /** Zero-copy access: returns contiguous received bytes at *ptr */
+    int         peek(const char** ptr)           { rx_notify_pending.store(0); return rx_ring.readSpan(ptr); }
+    void        consume(int len)                 { rx_ring.commitRead(len); rx_pos += len; }
+    /** As peek(), but stops at the end of a received chunk; time_ns is its arrival time (HiResClock) */
+    int         peekChunk(const char** ptr, qint64* time_ns);
+
+    /** Total bytes dropped since open(); also re-arms rxOverrun() */
+    qint64      droppedBytes()                   { rx_overrun_pending.store(0); return rx_dropped.load(); }
+
+    //-------------------------------------------------------------- TX
+    /**
+     * Queues one packet without copying (implicitly shared; raw data must stay
+     * valid until sent or clearTx()). Returns 0 if the transmit queue is full,
+     * the packet is never split. A packet larger than txQueueLimit() is taken
+     * only into an empty queue, as the single packet in it.
+     */
+    qint64      write(const QByteArray& data);
+    /** Drops everything not sent yet, in the queue and in the port buffer; blocks until done */
+    void        clearTx();
+    /** Bytes written but not sent yet */
+    qint64      txPending() const                { return tx_pending.load(); }
+    void        setTxQueueLimit(int bytes)       { tx_limit = (bytes > 0) ? bytes : DEFAULT_TX_QUEUE_LIMIT; }
+    int         txQueueLimit() const             { return tx_limit; }
+    /** Bytes accepted by write() since open() - stream position of the next packet */
+    qint64      txWritten() const                { return tx_written; }
+    /** Bytes of that stream already written to the device or dropped by clearTx() */
+    qint64      txDone() const                   { return tx_done; }
+
+    /** Measures reply time of the device (or a loopback): sends probe rounds times, see latencyProbeFinished() */
+    void        startLatencyProbe(const QByteArray& probe, int rounds, int timeout_ms);
+
+signals:
+    void        readyRead();
+    void        bytesWritten(qint64 bytes);
+    void        error(QSerialPort::SerialPortError serialPortError);
+    void        pinoutSignalsChanged(QSerialPort::PinoutSignals signals_mask);
+    /** Emitted when received bytes had to be dropped, once until droppedBytes() is called */
+    void        rxOverrun();
+    /** Probe results, times in ns; replies == 0 means no reply at all */
+    void        latencyProbeFinished(int replies, int rounds, qint64 min_ns, qint64 avg_ns, qint64 max_ns);
+    /** Line counters changed; time_ns - HiResClock time of the poll */
+    void        lineCountersChanged(const QSerialPort::LineCounters& counters, qint64 time_ns);
+
+private slots:
+    void        onTxDone(qint64 bytes);
+
+private:
+    Q_DISABLE_COPY(SerialPortEngine)
+
+    // used by the worker (I/O thread)
+    void        rxCommitted();
+    void        rxDropped(int len);
+    friend class SerialPortWorker;
+
+    struct RxMark
+    {
+        qint64 pos;         /* stream position of the first byte of the chunk */
+        qint64 time;        /* arrival, HiResClock ns */
+    };
+    bool        peekMark(RxMark* mark) const;
+
+    QThread*          io_thread;
+    bool              own_thread;
+    SerialPortWorker* worker;
+    SpscRingBuffer    rx_ring;
+    SpscRingBuffer    rx_marks;         /* RxMark records, written before the data they describe */
+    qint64            rx_pos;           /* stream position of the ring tail, GUI side */
+    qint64            rx_chunk_time;    /* arrival time of the chunk at rx_pos */
+    QAtomicInt        rx_notify_pending;
+    QAtomicInt        rx_dropped;
+    QAtomicInt        rx_overrun_pending;
+    QAtomicInt        tx_pending;
+    qint64            tx_written;       /* GUI side, see txWritten() */
+    qint64            tx_done;
+    int               tx_limit;
+    QString           port_name;
+    bool              is_open;
+};
+
+#endif // SERIALPORTENGINE_H
@@ -0,0 +1,232 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Port sessions and their distribution over I/O threads
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#include <QThread>
+
+#include "SessionManager.h"
+#include "SerialPortEngine.h"
+#include "RxAccumulator.h"
+
+#include "debug.h"
+
+// ******************************************************************************** C L A S S:  PortSession
+
+PortSession::PortSession(const QString &name, QRgb color, int rx_ring_size, QThread *io_thread, QObject *parent)
+    : QObject(parent)
+    , port(NULL)
+    , rx(NULL)
+    , port_name(name)
+    , rgb(color)
+    , rx_bytes(0)
+    , rx_frames(0)
+    , io_slot(-1)
+{
+    port = new SerialPortEngine(this, rx_ring_size, io_thread);
+    rx   = new RxAccumulator(this);
+
+    ASSERT_ALWAYS( connect(port, SIGNAL(readyRead()), SLOT(onReadyRead()) ) );
+    ASSERT_ALWAYS( connect(port, SIGNAL(rxOverrun()), SLOT(onRxOverrun()) ) );
+    ASSERT_ALWAYS( connect(port, SIGNAL(error(QSerialPort::SerialPortError)), SLOT(onSerialPortError(QSerialPort::SerialPortError)) ) );
+    ASSERT_ALWAYS( connect(rx,   SIGNAL(frameReady(QByteArray,int,qint64,qint64)), SLOT(onRxFrameReady(QByteArray,int,qint64,qint64)) ) );
+
+    port->setPortName(name);
+}
+
+PortSession::~PortSession()
+{
+    close();
+}
+
+bool PortSession::isOpen() const
+{
+    return port->isOpen();
+}
+
+QString PortSession::errorString() const
+{
+    return port->errorString();
+}
+
+bool PortSession::open(const SerialSetupDialog::PortSettings &settings, int gap_chars10)
+{
+    if (!port->open(QIODevice::ReadWrite)) return false;
+
+    setSettings(settings, gap_chars10);
+    return true;
+}
+
+void PortSession::close()
+{
+    if (port->isOpen())
+    {
+        port->close();
+        onReadyRead();      // tail of the data drained by close()
+    }
+    rx->flush();
+}
+
+void PortSession::setSettings(const SerialSetupDialog::PortSettings &settings, int gap_chars10)
+{
+    double stop_bits = (settings.StopBits == QSerialPort::TwoStop) ? 2.0 : (settings.StopBits == QSerialPort::OneAndHalfStop) ? 1.5 : 1.0;
+    qint64 char_ns   = RxAccumulator::charTime(settings.BaudRate, settings.DataBits, settings.Parity != QSerialPort::NoParity, stop_bits);
+
+    if (port->isOpen())
+    {
+        QStringList rejected = port->setSettings(settings);
+        if (!rejected.isEmpty())
+            emit errorOccurred(this, QString("Port settings not applied: %1 (%2)").arg(rejected.join(", "), port->errorString()));
+    }
+    rx->setCharTime(char_ns);
+    rx->setGapSplit( (gap_chars10 > 0) ? RxAccumulator::frameGap(gap_chars10, settings.BaudRate, char_ns) : 0 );
+}
+
+void PortSession::onReadyRead()
+{
+    const char* ptr;
+    int         len;
+    qint64      time;
+
+    while ( (len = port->peekChunk(&ptr, &time)) > 0 )
+    {
+        rx->append(ptr, len, time);
+        port->consume(len);
+    }
+}
+
+void PortSession::onRxFrameReady(const QByteArray &data, int chunks, qint64 time_ns, qint64 gap_ns)
+{
+    (void) chunks;
+    (void) gap_ns;
+
+    rx_bytes += data.size();
+    rx_frames++;
+    emit frameReady(this, data, time_ns);
+}
+
+void PortSession::onSerialPortError(QSerialPort::SerialPortError error)
+{
+    if (error == QSerialPort::NoError) return;
+
+    rx->flush();
+    emit errorOccurred(this, QString("Serial port error %1: %2").arg(static_cast<int>(error)).arg(port->errorString()));
+}
+
+void PortSession::onRxOverrun()
+{
+    rx->flush();
+    emit errorOccurred(this, QString("Receive buffer overrun: %1 bytes dropped since port was opened").arg(port->droppedBytes()));
+}
+
+// ******************************************************************************** C L A S S:  SessionManager
+
+static const QRgb session_colors[] =
+{
+    0x0000c0, 0x008000, 0xc00000, 0x8000a0,
+    0x007080, 0xa06000, 0x404040, 0xc00080
+};
+
+SessionManager::SessionManager(QObject *parent)
+    : QObject(parent)
+    , color_idx(0)
+{
+    int cnt = qBound(1, QThread::idealThreadCount(), static_cast<int>(MAX_IO_THREADS));
+
+    for (int i = 0; i < cnt; i++)
+    {
+        QThread* thread = new QThread();
+        thread->setObjectName(QString("SerialIO-%1").arg(i));
+        thread->start(QThread::TimeCriticalPriority);
+        threads.append(thread);
+        thread_load.append(0);
+    }
+}
+
+SessionManager::~SessionManager()
+{
+    closeAll();
+    for (int i = 0; i < threads.size(); i++)
+    {
+        threads[i]->quit();
+        threads[i]->wait();
+        delete threads[i];
+    }
+}
+
+PortSession *SessionManager::open(const QString &port_name, const SerialSetupDialog::PortSettings &settings, int gap_chars10, QString *error)
+{
+    if (find(port_name))
+    {
+        if (error) *error = QString("%1 is already open").arg(port_name);
+        return NULL;
+    }
+
+    int          slot    = leastLoadedThread();
+    PortSession* session = new PortSession(port_name, nextColor(), SESSION_RX_RING_SIZE, threads[slot], this);
+
+    if (!session->open(settings, gap_chars10))
+    {
+        if (error) *error = session->errorString();
+        delete session;
+        return NULL;
+    }
+
+    session->io_slot = slot;
+    thread_load[slot]++;
+    list.append(session);
+    emit sessionOpened(session);
+    return session;
+}
+
+void SessionManager::close(PortSession *session)
+{
+    if (!list.removeOne(session)) return;
+
+    session->close();
+    thread_load[session->io_slot]--;
+    emit sessionClosed(session);
+    delete session;
+}
+
+void SessionManager::closeAll()
+{
+    while (!list.isEmpty())
+    {
+        close(list.last());
+    }
+}
+
+PortSession *SessionManager::find(const QString &port_name) const
+{
+    for (int i = 0; i < list.size(); i++)
+    {
+        if (list.at(i)->portName() == port_name) return list.at(i);
+    }
+    return NULL;
+}
+
+int SessionManager::leastLoadedThread()
+{
+    int best = 0;
+
+    for (int i = 1; i < thread_load.size(); i++)
+    {
+        if (thread_load[i] < thread_load[best]) best = i;
+    }
+    return best;
+}
+
+QRgb SessionManager::nextColor()
+{
+    return session_colors[ color_idx++ % (sizeof(session_colors)/sizeof(session_colors[0])) ];
+}
@@ -0,0 +1,131 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Several ports opened at once, on a small pool of I/O threads
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#ifndef SESSIONMANAGER_H
+#define SESSIONMANAGER_H
+
+#include <QObject>
+#include <QList>
+#include <QVector>
+#include <QString>
+#include <QRgb>
+
+#include "QSerialPort"
+#include "serialsetupdialog.h"
+
+class QThread;
+class SerialPortEngine;
+class RxAccumulator;
+
+// ******************************************************************************** C L A S S:  PortSession
+/**
+ * One monitored port: its own I/O engine (ring buffer, chunk stamps) and
+ * frame accumulator. Created by SessionManager only.
+ */
+class PortSession : public QObject
+{
+    Q_OBJECT
+public:
+    ~PortSession();
+
+    QString           portName() const      { return port_name; }
+    QRgb              color() const         { return rgb; }
+    bool              isOpen() const;
+    QString           errorString() const;
+    qint64            bytesReceived() const { return rx_bytes; }
+    qint64            framesReceived() const { return rx_frames; }
+
+    SerialPortEngine* engine() const        { return port; }
+    RxAccumulator*    accumulator() const   { return rx; }
+
+    /** Line settings; also updates frame gap split (gap_chars10 - 0: off) */
+    void              setSettings(const SerialSetupDialog::PortSettings& settings, int gap_chars10);
+
+signals:
+    /** time_ns - estimated arrival of the first byte, HiResClock */
+    void              frameReady(PortSession* session, const QByteArray& data, qint64 time_ns);
+    void              errorOccurred(PortSession* session, const QString& message);
+
+private slots:
+    void              onReadyRead();
+    void              onRxFrameReady(const QByteArray& data, int chunks, qint64 time_ns, qint64 gap_ns);
+    void              onSerialPortError(QSerialPort::SerialPortError error);
+    void              onRxOverrun();
+
+private:
+    Q_DISABLE_COPY(PortSession)
+    friend class SessionManager;
+
+    PortSession(const QString& name, QRgb color, int rx_ring_size, QThread* io_thread, QObject* parent);
+    bool              open(const SerialSetupDialog::PortSettings& settings, int gap_chars10);
+    void              close();
+
+    SerialPortEngine* port;
+    RxAccumulator*    rx;
+    QString           port_name;
+    QRgb              rgb;
+    qint64            rx_bytes;
+    qint64            rx_frames;
+    int               io_slot;      /* index of the I/O thread in the pool */
+};
+
+// ******************************************************************************** C L A S S:  SessionManager
+/**
+ * Opens any number of ports at once, e.g. all ports of a USB hub.
+ *
+ * Ports are spread over at most MAX_IO_THREADS I/O threads (never more than
+ * CPU cores): a worker only reacts to notifiers of its port, so one thread
+ * serves many ports and 16 ports do not mean 16 time critical threads.
+ * Each port keeps its own receive ring, so a busy port cannot starve or
+ * overrun the others.
+ */
+class SessionManager : public QObject
+{
+    Q_OBJECT
+public:
+    enum {
+        MAX_IO_THREADS       = 4,
+        SESSION_RX_RING_SIZE = 1024*1024   /* per port, smaller than the main window engine */
+    };
+
+    explicit SessionManager(QObject* parent = 0);
+    ~SessionManager();
+
+    /** Returns NULL on failure with the reason in *error */
+    PortSession*  open(const QString& port_name, const SerialSetupDialog::PortSettings& settings, int gap_chars10, QString* error);
+    void          close(PortSession* session);
+    void          closeAll();
+
+    PortSession*  find(const QString& port_name) const;
+    const QList<PortSession*>& sessions() const { return list; }
+    int           ioThreadCount() const         { return threads.size(); }
+
+signals:
+    void          sessionOpened(PortSession* session);
+    /** Emitted before the session is deleted, all its data has been delivered by then */
+    void          sessionClosed(PortSession* session);
+
+private:
+    Q_DISABLE_COPY(SessionManager)
+
+    int           leastLoadedThread();
+    QRgb          nextColor();
+
+    QList<PortSession*> list;
+    QVector<QThread*>   threads;
+    QVector<int>        thread_load;    /* sessions per thread */
+    int                 color_idx;
+};
+
+#endif // SESSIONMANAGER_H
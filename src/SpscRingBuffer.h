@@ -0,0 +1,133 @@
+/******************************************************************************
+ * @file
+ *
+ * @brief    Lock-free single-producer / single-consumer byte ring
+ *
+ * @date     17-10-2026
+ * @author   rs232test contributors
+ ******************************************************************************
+ *       Copyright (C) 2026 rs232test contributors
+ *        This file is a part of rs232test project and is released
+ *      under the terms of the license contained in the file LICENSE
+ ******************************************************************************
+ */
+
+#ifndef SPSCRINGBUFFER_H
+#define SPSCRINGBUFFER_H
+
+#include <string.h>
+
+#include <QAtomicInt>
+
+// ******************************************************************************** C L A S S:  SpscRingBuffer
+/**
+ * Fixed size byte ring shared by exactly one producer thread and exactly
+ * one consumer thread. Both sides work on contiguous spans of the ring
+ * (writeSpan()/commitWrite(), readSpan()/commitRead()), so data can be
+ * read from a device straight into the ring and formatted straight out of it.
+ *
+ * head and tail are free running counters; capacity must be a power of two.
+ */
+class SpscRingBuffer
+{
+public:
+    explicit SpscRingBuffer(int capacity_pow2 = 1<<20)
+        : cap(roundUpPow2(capacity_pow2))
+        , mask(cap-1)
+        , buf(new char[cap])
+        , head(0)
+        , tail(0)
+    {}
+    ~SpscRingBuffer() { delete[] buf; }
+
+    int  capacity() const  { return cap; }
+    int  size() const      { return static_cast<int>( static_cast<unsigned>(head.loadAcquire()) - static_cast<unsigned>(tail.loadAcquire()) ); }
+    int  freeSpace() const { return cap - size(); }
+    bool isEmpty() const   { return size() == 0; }
+
+    //-------------------------------------------------------------- producer side
+    /** Returns number of contiguous bytes which can be written at *ptr */
+    int writeSpan(char** ptr)
+    {
+        unsigned h    = static_cast<unsigned>( head.load() );
+        unsigned t    = static_cast<unsigned>( tail.loadAcquire() );
+        int      used = static_cast<int>(h - t);
+        int      off  = static_cast<int>(h & mask);
+        int      len  = cap - used;
+
+        if (len > cap - off) len = cap - off;
+        *ptr = buf + off;
+        return len;
+    }
+    void commitWrite(int len) { head.storeRelease( head.load() + len ); }
+
+    /** Copies as much as fits, returns number of bytes stored */
+    int write(const char* data, int len)
+    {
+        int   done = 0;
+        char* ptr;
+        int   span;
+
+        while ( (done < len) && ((span = writeSpan(&ptr)) > 0) )
+        {
+            if (span > len - done) span = len - done;
+            memcpy(ptr, data + done, span);
+            commitWrite(span);
+            done += span;
+        }
+        return done;
+    }
+
+    //-------------------------------------------------------------- consumer side
+    /** Returns number of contiguous bytes which can be read from *ptr */
+    int readSpan(const char** ptr) const
+    {
+        unsigned t    = static_cast<unsigned>( tail.load() );
+        unsigned h    = static_cast<unsigned>( head.loadAcquire() );
+        int      len  = static_cast<int>(h - t);
+        int      off  = static_cast<int>(t & mask);
+
+        if (len > cap - off) len = cap - off;
+        *ptr = buf + off;
+        return len;
+    }
+    void commitRead(int len) { tail.storeRelease( tail.load() + len ); }
+
+    /** Copies up to len bytes out of the ring, returns number of bytes read */
+    int read(char* data, int len)
+    {
+        int         done = 0;
+        const char* ptr;
+        int         span;
+
+        while ( (done < len) && ((span = readSpan(&ptr)) > 0) )
+        {
+            if (span > len - done) span = len - done;
+            memcpy(data + done, ptr, span);
+            commitRead(span);
+            done += span;
+        }
+        return done;
+    }
+
+    /** Consumer side only: drops all buffered data */
+    void clear() { tail.storeRelease( head.loadAcquire() ); }
+
+private:
+    Q_DISABLE_COPY(SpscRingBuffer)
+
+    static int roundUpPow2(int v)
+    {
+        int p = 4096;
+        while (p < v && p < (1<<30)) p <<= 1;
+        return p;
+    }
+
+    const int  cap;
+    const int  mask;
+    char*      buf;
+    QAtomicInt head;    // written by producer only
+    QAtomicInt tail;    // written by consumer only
+};
+
+#endif // SPSCRINGBUFFER_H
@@ -183,20 +183,45 @@ public:
 
 #define CONF_MARK_USE_DEFAULT_STR  ((char*) 1)
 
+/** Edit modes, values of the command line -i option and of the GUI mode list */
+typedef enum {
+    INMODE_HEX,
+    INMODE_ASCII,
+    INMODE_CSTR,
+
+    __INMODES_CNT
+} input_modes_t;
+
+/** Display modes, values of the command line -o option and of the GUI mode list */
+typedef enum {
+    OUTMODE_HEX,
+    OUTMODE_ASCII,
+    OUTMODE_CSTR,
+
+    __OUTMODES_CNT
+} output_modes_t;
+
 class AppCommandLineParams
 {
 protected:
-    opt_defs_t          options[8];// NOTE: thihs must be always equal to number of parameters +1
+    opt_defs_t          options[15];// NOTE: thihs must be always equal to number of parameters +1
     static opt_val_listitem_t   inmode_list[];
     static opt_val_listitem_t   outmode_list[];
 public:
     char*       selPort;
     char*       configFileName;
     char*       logFileName;
+    char*       exportFileName;
+    char*       exportOutName;
+    char*       sendPayload;
+    char*       scriptFileName;
     int         displayMode;
     int         editMode;
+    int         baudRate;
+    int         runTime;
     char        helpRequeted;
     char        doConnect;
+    char        headless;
     //NOTE: If you add parameter here, dont forget increasing options[]
     //      ... and updating constructor...
 
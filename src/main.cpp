@@ -45,6 +45,8 @@
 
 #include "MainWindow.h"
 #include "strbinconv.h"
+#include "CaptureLog.h"
+#include "HeadlessSession.h"
 
 MainWindow*          mainWnd=NULL;
 QSettings*           appconfig=NULL;
@@ -52,8 +54,20 @@ AppCommandLineParams appcmdline;
 
 static const char* phase = "BETA (" __DATE__ ")";
 
+/** false in headless mode - no QApplication, messages go to the console */
+static bool hasGui()
+{
+    return qobject_cast<QApplication*>(QCoreApplication::instance()) != NULL;
+}
+
 void displayErrorMessage(const QString& err)
 {
+    if (!hasGui())
+    {
+        fprintf(stderr,"Error: %s\n",err.toLocal8Bit().data());
+        return;
+    }
+
     QApplication::beep();
 
     if (mainWnd)
@@ -74,6 +88,7 @@ void displayMessage(const QString& msg)
     else
     {
         fprintf(stderr, "%s\n",msg.toLatin1().data());
+        if (!hasGui()) return;
 
         QMessageBox msgBox(QMessageBox::NoIcon,
                            QCoreApplication::applicationName(),
@@ -106,27 +121,35 @@ bool AppCommandLineParams::parseCommandLine(int argc, char *argv[])
 }
 opt_val_listitem_t   AppCommandLineParams::inmode_list[] =
 {
-    {MainWindow::INMODE_HEX,   "hex|h",       "HEX",     0 },
-    {MainWindow::INMODE_ASCII, "ascii|a",     "ASCII",   0 },
-    {MainWindow::INMODE_CSTR,  "cstr|c",      "C-like string",   0 },
+    {INMODE_HEX,   "hex|h",       "HEX",     0 },
+    {INMODE_ASCII, "ascii|a",     "ASCII",   0 },
+    {INMODE_CSTR,  "cstr|c",      "C-like string",   0 },
     {0,           NULL,          NULL,                0 } // List terminator
 };
 
 opt_val_listitem_t   AppCommandLineParams::outmode_list[] =
 {
-    {MainWindow::OUTMODE_HEX,   "hex|h",       "HEX",     0 },
-    {MainWindow::OUTMODE_ASCII, "ascii|a",     "ASCII",   0 },
-    {MainWindow::OUTMODE_CSTR,  "cstr|c",      "C-like string",   0 },
+    {OUTMODE_HEX,   "hex|h",       "HEX",     0 },
+    {OUTMODE_ASCII, "ascii|a",     "ASCII",   0 },
+    {OUTMODE_CSTR,  "cstr|c",      "C-like string",   0 },
     {0,           NULL,          NULL,                0 } // List terminator
 };
 
 AppCommandLineParams::AppCommandLineParams()
     : selPort(NULL)
     , configFileName(NULL)
+    , logFileName(NULL)
+    , exportFileName(NULL)
+    , exportOutName(NULL)
+    , sendPayload(NULL)
+    , scriptFileName(NULL)
     , displayMode(-1)
     , editMode(-1)
+    , baudRate(0)
+    , runTime(0)
     , helpRequeted(0)
     , doConnect(0)
+    , headless(0)
 {
 
     opt_defs_t*  op=options;
@@ -136,9 +159,16 @@ AppCommandLineParams::AppCommandLineParams()
     PUT_CHAR_OPT( op, 'p', "port",       "port name",   &selPort,         NULL,          "Port file name that should be selected");
     //PUT_OPT_DEF_CHAR(pOptDef,pShortOpt,pcLongOpt,PO_REQUIRED_ARG,pcArgName,ppcVal,pcOptDef,NULL,NULL,1,0,pcDesc)
     PUT_OPT_DEF_CHAR( op, 'l', "log",  PO_OPTIONAL_ARG, "log file",    &logFileName, CONF_MARK_USE_DEFAULT_STR ,NULL,NULL,1,0,
-                      "Dump output to log file with provided name or default file name if [log file] parameter is not provided");
+                      "Capture output to binary log file with provided name or default file name if [log file] parameter is not provided");
+    PUT_CHAR_OPT( op, 'x', "export",     "log file",    &exportFileName,  NULL,          "Export binary log file using display mode (-o) and exit");
+    PUT_CHAR_OPT( op, 'w', "exportto",   "out file",    &exportOutName,   NULL,          "Export output file (*.html, *.htm for HTML, text otherwise). Default: <log file>.txt");
     PUT_LIST_OPT( op, 'i', "inmode",     "mode",        &editMode,     inmode_list,  NULL, "Edit mode");
     PUT_LIST_OPT( op, 'o', "outmode",    "mode",        &displayMode,  outmode_list, NULL, "Display mode");
+    PUT_BOOL_OPT( op, 'n', "headless",                  &headless,                       "Run without GUI: open port (-p), write received data to stdout using display mode (-o) and/or to log file (-l)");
+    PUT_INT_OPT(  op, 'b', "baud",       "rate",        &baudRate,     0, 0, 0x7FFFFFFF,  "Headless: baud rate. Other port settings are taken from configuration");
+    PUT_CHAR_OPT( op, 's', "send",       "payload",     &sendPayload,     NULL,          "Headless: send payload, written in edit mode (-i), after opening port");
+    PUT_CHAR_OPT( op, 'f', "script",     "script file", &scriptFileName,  NULL,          "Headless: send script. Line per payload in edit mode (-i), '@sleep <ms>', '@quit', '#' comments");
+    PUT_INT_OPT(  op, 't', "time",       "seconds",     &runTime,      0, 0, 0x7FFFFFFF,  "Headless: stop after given time. Default: run until @quit or interrupted");
     PUT_END_OPT(  op );
 }
 
@@ -167,6 +197,39 @@ QString AppCommandLineParams::getCommandLineHelpString()
     return str;
 }
 
+static int exportCaptureLog()
+{
+    static const int conv_of_outmode[__OUTMODES_CNT] =
+    {
+        QBinStrConvCollection::CONV_HEX,
+        QBinStrConvCollection::CONV_ASCII,
+        QBinStrConvCollection::CONV_CSTR
+    };
+    int     outmode  = (appcmdline.displayMode >= 0) ? appcmdline.displayMode : OUTMODE_HEX;
+    QString in_name  = QString(appcmdline.exportFileName);
+    QString out_name = (appcmdline.exportOutName) ? QString(appcmdline.exportOutName) : in_name + ".txt";
+    QString error;
+
+    if (outmode >= __OUTMODES_CNT) outmode = OUTMODE_HEX;
+
+    if (! CaptureLog::exportFile(in_name, out_name, QBinStrConvCollection::getConv(conv_of_outmode[outmode]), &error) )
+    {
+        displayErrorMessage(QString("Export of %1 failed. %2").arg(in_name, error));
+        return -1;
+    }
+    return 0;
+}
+
+/** Headless mode must be known before the application object exists */
+static bool isHeadless(int argc, char *argv[])
+{
+    for (int cnt = 1; cnt < argc; cnt++)
+    {
+        if ( !qstricmp(argv[cnt], "-n") || !qstricmp(argv[cnt], "--headless") ) return true;
+    }
+    return false;
+}
+
 int main(int argc, char *argv[])
 {
     //printf("rs232test started...\n");
@@ -175,7 +238,9 @@ int main(int argc, char *argv[])
     QCoreApplication::setOrganizationDomain("rafalkukla.com");
     QCoreApplication::setApplicationName("Rs232Test2");
     QCoreApplication::setApplicationVersion(phase);
-    QApplication a(argc, argv);
+    QScopedPointer<QCoreApplication> a( isHeadless(argc, argv)
+                                        ? new QCoreApplication(argc, argv)
+                                        : new QApplication(argc, argv) );
 
     if (! appcmdline.parseCommandLine(argc,argv) )
     {
@@ -195,6 +260,12 @@ int main(int argc, char *argv[])
         return 1;
     }
 
+    if (appcmdline.exportFileName)
+    {
+        // Offline export, no GUI
+        return exportCaptureLog();
+    }
+
     QScopedPointer<QSettings*, QScopedSubPointerDeleter<QSettings*> > settings_deleter(&appconfig);
 
     if (appcmdline.configFileName)
@@ -208,10 +279,18 @@ int main(int argc, char *argv[])
         appconfig = new QSettings();
     }
 
+    if (appcmdline.headless)
+    {
+        // No widgets at all: port, accumulator and capture only
+        HeadlessSession session;
+        if (! session.start(appcmdline) ) return -1;
+        a->exec();
+        return session.exitCode();
+    }
 
     MainWindow w;
     mainWnd = &w;
 
     w.show();
-    return a.exec();
+    return a->exec();
 }
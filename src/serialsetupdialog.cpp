@@ -12,9 +12,29 @@
  ******************************************************************************
  */
 
+#include <QIntValidator>
+
 #include "serialsetupdialog.h"
 #include "ui_serialsetupdialog.h"
 
+const SerialSetupDialog::PortSettings SerialSetupDialog::DefaultSettings =
+    {115200,QSerialPort::Data8, QSerialPort::NoParity, QSerialPort::OneStop,QSerialPort::NoFlowControl, 250, 0, 0, false};
+
+void SerialSetupDialog::updateConfig(cfg_operations_t operation, PortSettings& settings)
+{
+#define RW_PORTSETTINGS_FIELD(_type_, _name_) AutoCfg<_type_,convVarAsIntTo<_type_> >::doCfg(operation, &settings._name_, #_name_)
+    RW_PORTSETTINGS_FIELD(qint32,                   BaudRate);
+    RW_PORTSETTINGS_FIELD(QSerialPort::DataBits,    DataBits);
+    RW_PORTSETTINGS_FIELD(QSerialPort::Parity,      Parity);
+    RW_PORTSETTINGS_FIELD(QSerialPort::StopBits,    StopBits);
+    RW_PORTSETTINGS_FIELD(QSerialPort::FlowControl, FlowControl);
+    RW_PORTSETTINGS_FIELD(long,                     Timeout_Millisec);
+    RW_PORTSETTINGS_FIELD(long,                     TxByteDelay_Millisec);
+    RW_PORTSETTINGS_FIELD(long,                     TxPacketDelay_Millisec);
+    RW_PORTSETTINGS_FIELD(bool,                     LowLatency);
+ #undef RW_PORTSETTINGS_FIELD
+}
+
 SerialSetupDialog::SerialSetupDialog(const QString portName, QWidget *parent)
     : QDialog(parent)
     , ui(new Ui::SerialSetupDialog)
@@ -45,6 +65,14 @@ void SerialSetupDialog::setupUI()
     ui->baudRateBox->addItem("230400", 230400);
     ui->baudRateBox->addItem("460800", 460800);
     ui->baudRateBox->addItem("921600", 921600);
+    ui->baudRateBox->addItem("1000000", 1000000);
+    ui->baudRateBox->addItem("2000000", 2000000);
+    ui->baudRateBox->addItem("3000000", 3000000);
+    ui->baudRateBox->addItem("4000000", 4000000);
+    ui->baudRateBox->addItem("12000000", 12000000);
+
+    // any other rate can be typed in
+    ui->baudRateBox->setValidator(new QIntValidator(1, MAX_BAUD_RATE, ui->baudRateBox));
 
     ui->baudRateBox->setCurrentIndex(7);
 
@@ -81,21 +109,31 @@ void SerialSetupDialog::setupUI()
 
 void SerialSetupDialog::updateGuiToConfig(PortSettings& port_conf)
 {
-    ui->baudRateBox->setCurrentIndex( ui->baudRateBox->findData(port_conf.BaudRate) );
+    int idx = ui->baudRateBox->findData(port_conf.BaudRate);
+    if (idx >= 0)
+        ui->baudRateBox->setCurrentIndex(idx);
+    else
+        ui->baudRateBox->setEditText(QString::number(port_conf.BaudRate));
     ui->parityBox->setCurrentIndex( ui->parityBox->findData(port_conf.Parity) );
     ui->dataBitsBox->setCurrentIndex( ui->dataBitsBox->findData(port_conf.DataBits) );
     ui->stopBitsBox->setCurrentIndex( ui->stopBitsBox->findData(port_conf.StopBits) );
     ui->flowCtrlBox->setCurrentIndex( ui->flowCtrlBox->findData(port_conf.FlowControl) );
     ui->timeoutBox->setValue(port_conf.Timeout_Millisec);
+    ui->byteDelayBox->setValue(port_conf.TxByteDelay_Millisec);
+    ui->packetDelayBox->setValue(port_conf.TxPacketDelay_Millisec);
+    ui->lowLatencyBox->setChecked(port_conf.LowLatency);
 
 }
 
 void SerialSetupDialog::updateConfigToGui(PortSettings& port_conf)
 {
-    int idx;
-    if ( (idx = ui->baudRateBox->currentIndex()) >=0 )
+    int  idx;
+    bool ok;
+    // typed text, which need not be one of the items
+    qint32 baud_rate = ui->baudRateBox->currentText().toInt(&ok);
+    if ( ok && baud_rate > 0 )
     {
-        port_conf.BaudRate = /*(QSerialPort::BaudRate)*/ ui->baudRateBox->itemData(idx).toInt();
+        port_conf.BaudRate = baud_rate;
     }
     if ( (idx = ui->parityBox->currentIndex()) >=0 )
     {
@@ -114,4 +152,7 @@ void SerialSetupDialog::updateConfigToGui(PortSettings& port_conf)
         port_conf.FlowControl = (QSerialPort::FlowControl) ui->flowCtrlBox->itemData(idx).toInt();
     }
     port_conf.Timeout_Millisec = ui->timeoutBox->value();
+    port_conf.TxByteDelay_Millisec   = ui->byteDelayBox->value();
+    port_conf.TxPacketDelay_Millisec = ui->packetDelayBox->value();
+    port_conf.LowLatency             = ui->lowLatencyBox->isChecked();
 }
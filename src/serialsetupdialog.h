@@ -18,6 +18,8 @@
 #include <QDialog>
 #include <QSerialPort>
 
+#include "appconfig.h"
+
 //#include <qextserialport.h>
 
 namespace Ui {
@@ -36,8 +38,18 @@ public:
         QSerialPort::StopBits    StopBits;
         QSerialPort::FlowControl FlowControl;
         long Timeout_Millisec;
+        long TxByteDelay_Millisec;      /* pause after every byte sent, 0 - none */
+        long TxPacketDelay_Millisec;    /* pause after every packet (single write) */
+        bool LowLatency;                /* QSerialPort::setLowLatency() profile */
     };
 
+    static const PortSettings DefaultSettings;
+
+    enum { MAX_BAUD_RATE = 50000000 };
+
+    /** Reads/writes settings in the current appconfig group */
+    static void updateConfig(cfg_operations_t operation, PortSettings& settings);
+
 protected:
     void setupUI();
     void updateGuiToConfig(PortSettings& port_conf);
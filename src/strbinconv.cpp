@@ -15,6 +15,8 @@
 #include <wctype.h>
 #include "strbinconv.h"
 #include "strutils.h"
+#include "HexDumpEngine.h"
+#include "HexKernels.h"
 
 QString TextToHtml(const char* str, size_t size)
 {
@@ -295,17 +297,20 @@ QStrBinConv::VALIDITY QStr2AsciiBinConv::convert(QString &str, QByteArray* pOutB
 
 //======================================================= QCStr2BinConv
 const char* QCStr2BinConv::name = "C-like string";
-QStrBinConv::VALIDITY QCStr2BinConv::convert(QString &str, QByteArray *pOutBuf, int *)
+QStrBinConv::VALIDITY QCStr2BinConv::convert(QString &str, QByteArray *pOutBuf, int *pFailPosition)
 {
     if ( pOutBuf)
     {
         int strsize = str.size();
+        size_t used = 0;
         if ( strsize > 0 )
         {
             pOutBuf->operator =( str.toLocal8Bit() );
-            strsize = static_cast<int>( CStrToStr( pOutBuf->data(), strsize, pOutBuf->data(), strsize ) );
+            strsize = static_cast<int>( CStrToStrEx( pOutBuf->data(), strsize, pOutBuf->data(), strsize, &used ) );
             pOutBuf->resize( strsize );
         }
+        // Conversion stops on a null character, report where
+        if (pFailPosition) *pFailPosition = static_cast<int>(used);
         return QStrBinConv::VALID;
     }
     return QStrBinConv::BUF_TO_SMALL;
@@ -369,47 +374,6 @@ QStrBinConv* QStrBinConvCollection::getConv(int index)
 
 //======================================================= QBin2HexStrConv
 
-/*****************************************************************************************************
-_htos_be
- ***/
-inline char* _htos_be(register const unsigned char* data, register char* buf,
-register unsigned hlen)
-{
-  register unsigned char  c,b;
-  while (hlen)
-  {
-        c = *data++;
-        b = c >> 4; c&=0xF;
-        *buf++=b+ ((b<10)?'0':'A'-10);
-        *buf++=c+ ((c<10)?'0':'A'-10);
-
-    hlen--;
-  }
-
-  return buf;
-}
-
-/*****************************************************************************************************
-_htos_le
- ***/
-inline char* _htos_le(register const unsigned char* data, register char* buf,
-register unsigned hlen)
-{
-  register unsigned char  c,b;
-  data+=hlen-1;
-  while (hlen)
-  {
-        c = *data--;
-        b = c >> 4; c&=0xF;
-        *buf++=b+ ((b<10)?'0':'A'-10);
-        *buf++=c+ ((c<10)?'0':'A'-10);
-
-    hlen--;
-  }
-
-  return buf;
-}
-
 /***************************************************************************************************** negBufLE
  ***/
 inline void negBufLE(register unsigned char* buf, register int bufsize)
@@ -447,224 +411,84 @@ inline void negBufBE(register unsigned char* buf, register int bufsize)
 #define OUTB_GET_TYPE_SIZE(_opts_) ( 1<<(((_opts_) & OUTB_TYPE_MASK)>>8) )
 
 
-/******************************************************************************************************
- * Function display data buffer in HEX and Ascii format
- *
- * @param[in]  address        start address
- * @param[in]  buf            data buffer
- * @param[in]  size           data size
- *
- */
-
-QString QBin2HexStrConv::HexToStr( unsigned long address, const unsigned char* buf, unsigned long size,
-                                   QBinStrConv::STR_FORMAT format,
-                                   uint32_t options )
+void QBin2HexStrConv::getDumpFormat(HexDumpFormat &fmt, uint32_t options) const
 {
-    static const char* sep     = "  ";
-    static const char* eol     = "\n";
-
-  QString head;
-  QString tail;
-  QString addrfmt = "%1:";
-  QString hexfmt  = "%1";
-  QString asciifmt= "%1";
-  if (format==QBinStrConv::HTML)
-  {
-      head = "<pre>";
-      tail = "</pre>";
-      addrfmt  = QString("</b><font color=\"%1\">%2</font></b>").arg(addr_color).arg(addrfmt);
-      hexfmt   = QString("<font color=\"%1\">%2</font>").arg(body_color).arg(hexfmt);
-      asciifmt = QString("<font color=\"%1\"><code>%2</code></font>").arg(supp_color).arg(asciifmt);
-  }
-
-  char          hex[OUTB_MAX_REC*3+1];
-  char          asc[OUTB_MAX_REC+1];
-  unsigned long cnt,r;
-  unsigned      typesize;
-  AddrTypes addr_type;
-  bool  is_big_endian;
-  bool  show_hex;
-  bool  show_ascii;
-  unsigned      addrw,hexw,ascw,recw; /*Width of format str */
-  int           sepRequired;
-
+  uint32_t      addr_type;
 
   if (options==OUTB_NOT_SPECIFIED)
   {
-      addr_type = addrType;
-      addrw = addrWidth;
-      recw  = recSize;
-      show_hex = showHex;
-      show_ascii = showAscii;
-      typesize = wordSize;
-      is_big_endian = isBigEndian;
+      addr_type      = addrType;
+      fmt.addrWidth  = addrWidth;
+      fmt.recSize    = recSize;
+      fmt.wordSize   = wordSize;
+      fmt.bigEndian  = isBigEndian;
+      fmt.showHex    = showHex;
+      fmt.showAscii  = showAscii;
   }
   else
   {
-      addr_type = static_cast<AddrTypes>(options & OUTB_SHOW_ADDR);
-      addrw = OUTB_GET_ADDR_SIZE(options);
-      typesize = OUTB_GET_TYPE_SIZE(options);
-      recw  = OUTB_GET_REC_SIZE(options);
-      show_hex   = (options & OUTB_SHOW_HEX) == OUTB_SHOW_HEX;
-      show_ascii = (options & OUTB_SHOW_ASCII) == OUTB_SHOW_ASCII;
-      if ( (options & OUTB_FORCE_BE) == OUTB_FORCE_BE)
+      addr_type      = options & OUTB_SHOW_ADDR;
+      fmt.addrWidth  = OUTB_GET_ADDR_SIZE(options);
+      fmt.wordSize   = OUTB_GET_TYPE_SIZE(options);
+      fmt.recSize    = OUTB_GET_REC_SIZE(options);
+      fmt.showHex    = (options & OUTB_SHOW_HEX) == OUTB_SHOW_HEX;
+      fmt.showAscii  = (options & OUTB_SHOW_ASCII) == OUTB_SHOW_ASCII;
+      if ( (options & OUTB_FORCE_LE) == OUTB_FORCE_LE)
       {
-        is_big_endian = 1;
+        fmt.bigEndian = false;
       }
-      else if ( (options & OUTB_FORCE_LE) == OUTB_FORCE_LE)
+      else if ( (options & OUTB_FORCE_BE) == OUTB_FORCE_BE)
       {
-        is_big_endian = 0;
+        fmt.bigEndian = true;
       }
       else /* determine automatically */
       {
-        cnt = 0x01; // is unsigned long
-        is_big_endian = ( *((unsigned char*) &cnt) != 0x01 );
+        const uint16_t probe = 0x0001;
+        fmt.bigEndian = ( *reinterpret_cast<const unsigned char*>(&probe) != 0x01 );
       }
-
   }
 
-  QString out = head;
-
-  // Calculate address size
-  if (addr_type != NO_ADDR)
+  switch (addr_type)
   {
-    if (!addrw)
-    {
-      if ( addr_type == ADDR_DEC )
-      {
-        addrw=1;
-        for (cnt=address+size;cnt;cnt/=10) addrw++;
-      }
-      else if ( addr_type == ADDR_HEX )
-      {
-        addrw=0;
-        for (cnt=address+size;cnt;cnt/=16) addrw++;
-        // align to 2, 4, 8, 16, ...
-        for (cnt=2; addrw>cnt; cnt<<=1) ;
-        addrw = cnt;
-      }
-    }
+  case ADDR_HEX: fmt.addrMode = HexDumpFormat::ADDR_HEX;  break;
+  case ADDR_DEC: fmt.addrMode = HexDumpFormat::ADDR_DEC;  break;
+  default:       fmt.addrMode = HexDumpFormat::ADDR_NONE; break;
   }
+}
 
-  // Calculate record size in bytes
-  if (recw>OUTB_MAX_REC) recw=OUTB_MAX_REC;
-  recw /= typesize;
-  if (! recw) recw = 1;
-
-  hexw  = recw*(typesize*2+1)-1;
-  ascw  = recw;
-
-
-  while (size>=typesize) /* only complete types */
-  {
-    r = size / typesize;
-    if ( r > recw ) r = recw;
-
-    sepRequired = 0;
-
-    // Print address field
-    if ( addr_type == ADDR_DEC )
-    {
-      //fprintf(out,"%*d: ",addrw,address);
-        out+=QString(addrfmt).arg(address,addrw,10);
-        sepRequired=1;
-    }
-    else if ( addr_type == ADDR_HEX )
-    {
-      //fprintf(out,"%.*X: ",addrw,address);
-      out+=QString(addrfmt).arg(address,addrw,16,QChar('0'));
-      sepRequired=1;
-    }
-
-    //Print hex field
-    if ( show_hex )
-    {
-      char                *hptr = hex;
-      const unsigned char *ptr  = buf;
-
-      for (cnt=r;cnt;cnt--)
-      {
-        if (is_big_endian)
-          hptr = _htos_be(ptr,hptr,typesize);
-        else
-          hptr = _htos_le(ptr,hptr,typesize);
-
-        ptr  += typesize;
-        if (cnt>1) *hptr++=' ';
-      }
-
-      *hptr=0;
-      if (sepRequired) out+=sep;
-      //fprintf(out,"%-*s ",hexw,hex);
-      if (show_ascii)
-        out+=QString(hexfmt).arg(hex,-hexw);
-      else
-          out+=QString(hexfmt).arg(hex);
-      //out+=QString::fromLatin1(hex,hexw);
-
-      sepRequired=1;
-              //("%1 ").arg(static_cast<unsigned char>(hex),-addrw,16, QChar('0'));
-    }
-
-    //Print ascii field
-    if ( show_ascii )
-    {
-      if ( typesize == sizeof(char) )
-      {
-        char                *aptr = asc;
-        const unsigned char *ptr  = buf;
-
-        for (cnt=r;cnt;cnt--)
-            {
-          *aptr++= iscntrl(*ptr) ? '.' : *ptr;
-          ptr++;
-        }
-
-        *aptr = 0;
-
-        if (sepRequired) out+=sep;
-        //fprintf(out,"%-*s ",ascw,asc);
-        if (format==QBinStrConv::HTML)
-        {
-            out+=QString(asciifmt).arg(TextToHtml(asc,r));
-        }
-        else
-        {
-            out+=QString(asciifmt).arg(asc,-ascw);
-        }
-        //out+=doc.toHtml();
-        sepRequired=1;
-      }
-      else if ( typesize == sizeof(wchar_t) )
-      {
-        wchar_t       *aptr = (wchar_t*) asc;
-        const wchar_t *ptr  = (const wchar_t*) buf;
+/******************************************************************************************************
+ * Function display data buffer in HEX and Ascii format
+ *
+ * @param[in]  address        start address
+ * @param[in]  buf            data buffer
+ * @param[in]  size           data size
+ *
+ */
 
-        for (cnt=r;cnt;cnt--)
-            {
-          *aptr++= iswcntrl(*ptr) ? L'.' : *ptr;
-          ptr++;
-        }
+QString QBin2HexStrConv::HexToStr( unsigned long address, const unsigned char* buf, unsigned long size,
+                                   QBinStrConv::STR_FORMAT format,
+                                   uint32_t options )
+{
+  HexDumpFormat fmt;
 
-        *aptr = 0;
-        if (sepRequired) out+=sep;
-        //fprintf(out,"%-*S ",ascw,asc);
-        out+=QString(asciifmt).arg(QString::fromWCharArray((wchar_t*)asc, aptr-((wchar_t*)asc) ), -ascw);
-        sepRequired=1;
+  getDumpFormat(fmt, options);
 
-      }
-    }
+  // colors must stay alive until the engine formats its tags
+  QByteArray addr_col = addr_color.toLatin1();
+  QByteArray body_col = body_color.toLatin1();
+  QByteArray supp_col = supp_color.toLatin1();
+  fmt.html      = (format==QBinStrConv::HTML);
+  fmt.addrColor = addr_col.constData();
+  fmt.bodyColor = body_col.constData();
+  fmt.suppColor = supp_col.constData();
 
-    //fprintf(out,"\n");
-    out+=eol;
+  HexDumpEngine engine(fmt, address, size);
 
-    r *= typesize;
-    buf     += r;
-    address += r;
-    size    -= r;
-  }
+  // Single allocation: engine knows the output size (upper bound for HTML)
+  QString out( static_cast<int>(engine.outputSize()), Qt::Uninitialized );
+  size_t  len = engine.format( buf, reinterpret_cast<uint16_t*>(out.data()) );
+  out.resize( static_cast<int>(len) );
 
-  out+=tail;
   return out;
 }
 
@@ -681,15 +505,25 @@ const char* QHexStr2BinConv::name = "HEX";
 
 QStrBinConv::VALIDITY QHexStr2BinConv::convert(QString &str, QByteArray* pOutBuf, int *pFailPosition)
 {
+    enum {
+        SCRATCH_SIZE = 512      /* output of bulk decoding when only validating */
+    };
     QStrBinConv::VALIDITY res;
 
 
     const QChar *uc = str.unicode();
+    const uint16_t *uc16 = reinterpret_cast<const uint16_t*>(uc);
     int maxlen = str.length();
     int idx = 0;
     unsigned short code;
     unsigned char  val;
     bool is_nible = false;
+    uint8_t  scratch[SCRATCH_SIZE];
+    uint8_t* out;
+    uint8_t* out_start;
+    size_t   step;      /* output pointer advance, 0 if output is discarded */
+    size_t   left, cnt;
+    int      start = 0;
 
     // Skip whitespace
     while (idx < maxlen && uc[idx].isSpace())
@@ -701,14 +535,53 @@ QStrBinConv::VALIDITY QHexStr2BinConv::convert(QString &str, QByteArray* pOutBuf
     res = QStrBinConv::VALID;
     val = 0;
 
+    // Every output byte takes at least two characters, except the last one
+    if (pOutBuf)
+    {
+        start = pOutBuf->size();
+        pOutBuf->resize( start + (maxlen - idx + 1) / 2 );
+        out_start = reinterpret_cast<uint8_t*>(pOutBuf->data()) + start;
+        step      = 1;
+    }
+    else
+    {
+        out_start = scratch;
+        step      = 0;
+    }
+    out = out_start;
+
     while (idx < maxlen)
     {
+        if (!is_nible)
+        {
+            // Bulk paths at byte boundary: "XX XX ..." groups, then plain runs of digits
+            left = static_cast<size_t>(maxlen - idx);
+            if (!step && left > SCRATCH_SIZE) left = SCRATCH_SIZE;
+
+            cnt = HexKernels::decodeSpacedPairs(uc16 + idx, left, out);
+            if (cnt)
+            {
+                idx += static_cast<int>(3*cnt);
+                out += cnt*step;
+                continue;
+            }
+
+            cnt = HexKernels::scanDigits(uc16 + idx, left) / 2;
+            if (cnt)
+            {
+                HexKernels::decodePairs(uc16 + idx, cnt, out);
+                idx += static_cast<int>(2*cnt);
+                out += cnt*step;
+                if (idx == maxlen) break;
+            }
+        }
+
         const QChar &in = uc[idx];
         idx++;
 
         if (in.isSpace())
         {
-            if (is_nible && pOutBuf) pOutBuf->append(val);
+            if (is_nible) { *out = val; out += step; }
             is_nible = false;
             val = 0;
             continue;
@@ -724,20 +597,20 @@ QStrBinConv::VALIDITY QHexStr2BinConv::convert(QString &str, QByteArray* pOutBuf
         }
         else // bad character
         {
-            if (is_nible && pOutBuf) pOutBuf->append(val);
             res = QStrBinConv::INVALID;
             break;
         }
         if ( is_nible )
         {
-            if (pOutBuf) pOutBuf->append(val);
+            *out = val; out += step;
             val = 0;
         }
 
         is_nible  = !is_nible;
 
     }
-    if (is_nible && pOutBuf) pOutBuf->append(val);
+    if (is_nible) { *out = val; out += step; }
+    if (pOutBuf) pOutBuf->resize( start + static_cast<int>(out - out_start) );
     if (pFailPosition) *pFailPosition = idx;
 
     return res;
@@ -21,6 +21,8 @@
 #include <QByteArray>
 
 
+struct HexDumpFormat;
+
 //======================================================= Utils Functs
 
 QString TextToHtml(const char* str, size_t size);
@@ -43,6 +45,11 @@ public:
     };
     virtual const char* getName() = 0;
     virtual VALIDITY    convert(QString& str, QByteArray* pOutBuf, int* pFailPosition) = 0;
+    /* True when converting a text line by line, each line with its line end,
+       and joining the results gives the same data as converting the whole text.
+       Conversion of a line does not continue to the next one when it is INVALID
+       or when *pFailPosition is set before the end of the line. */
+    virtual bool        isLineSeparable() { return false; }
     QByteArray  convert(QString& str)  { QByteArray buf; convert(str,&buf,NULL); return buf; }
     VALIDITY    validate(QString& str, int* pFailPosition=NULL) { return convert(str,NULL,pFailPosition); }
 };
@@ -109,6 +116,7 @@ protected:
 public:
     virtual const char* getName() { return name; }
     virtual QStrBinConv::VALIDITY convert(QString& str, QByteArray* pOutBuf, int*  );
+    virtual bool        isLineSeparable() { return true; }
 };
 
 class QAsciiBin2StrConv : public QBinStrConv
@@ -131,7 +139,8 @@ protected:
     static const char* name;
 public:
     virtual const char* getName() { return name; }
-    virtual QStrBinConv::VALIDITY convert(QString& str, QByteArray* pOutBuf, int*  );
+    virtual QStrBinConv::VALIDITY convert(QString& str, QByteArray* pOutBuf, int* pFailPosition);
+    virtual bool        isLineSeparable() { return true; }
 };
 
 class QBin2CStrConv : public QBinStrConv
@@ -154,6 +163,7 @@ protected:
 public:
     virtual const char* getName() { return name; }
     virtual QStrBinConv::VALIDITY  convert(QString& str, QByteArray* pOutBuf, int* pFailPosition);
+    virtual bool        isLineSeparable() { return true; }
 };
 
 
@@ -186,6 +196,8 @@ protected:
 public:
     virtual const char* getName() { return name; }
     virtual QString convert(QByteArray& buf, QBinStrConv::STR_FORMAT format, uint32_t options);
+    /** Layout used by convert() for given options, colors are left untouched */
+    void getDumpFormat(HexDumpFormat& fmt, uint32_t options = OUTB_NOT_SPECIFIED) const;
 
     QBin2HexStrConv():
         addrType(ADDR_HEX),